@@ -213,3 +213,43 @@ function(wscommon_cc_library)
 
   add_library(ws::${WSCOMMON_CC_LIB_NAME} ALIAS ${_NAME})
 endfunction()
+
+function(wscommon_cc_test)
+  if(NOT (BUILD_TESTING AND WSCOMMON_BUILD_TESTING))
+    return()
+  endif()
+
+  cmake_parse_arguments(WSCOMMON_CC_TEST
+    ""
+    "NAME"
+    "SRCS;COPTS;DEFINES;LINKOPTS;DEPS"
+    ${ARGN}
+  )
+
+  set(_NAME "wscommon_${WSCOMMON_CC_TEST_NAME}")
+
+  add_executable(${_NAME} "")
+  target_sources(${_NAME} PRIVATE ${WSCOMMON_CC_TEST_SRCS})
+  target_include_directories(${_NAME}
+    PUBLIC ${WSCOMMON_INCLUDE_DIRS}
+  )
+
+  target_compile_definitions(${_NAME}
+    PUBLIC ${WSCOMMON_CC_TEST_DEFINES}
+  )
+  target_compile_options(${_NAME}
+    PRIVATE ${WSCOMMON_CC_TEST_COPTS}
+  )
+
+  target_link_libraries(${_NAME}
+    PUBLIC ${WSCOMMON_CC_TEST_DEPS}
+    PRIVATE ${WSCOMMON_CC_TEST_LINKOPTS}
+  )
+  set_property(TARGET ${_NAME} PROPERTY FOLDER ${WSCOMMON_IDE_FOLDER}/test)
+
+  if(WSCOMMON_PROPAGATE_CXX_STD)
+    target_compile_features(${_NAME} PUBLIC ${WSCOMMON_INTERNAL_CXX_STD_FEATURE})
+  endif()
+
+  add_test(NAME ${_NAME} COMMAND ${_NAME})
+endfunction()
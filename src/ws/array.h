@@ -22,11 +22,17 @@ struct Array {
   using const_iterator = const T*;
   using reverse_iterator = std::reverse_iterator<iterator>;
   using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  /** Gives a buffer back to the owner it was borrowed from, e.g. an
+      ArrayPool, instead of delete[]. */
+  using release_function = void (*)(void* owner, pointer buff,
+                                    size_type length);
 
   constexpr Array();
   explicit Array(size_type length);
   Array(std::initializer_list<value_type> init);
   Array(pointer buff, size_type length);
+  Array(pointer buff, size_type length, release_function release,
+        void* owner);
   Array(Array&&) noexcept;
   Array(const Array&) = delete;
 
@@ -65,8 +71,15 @@ struct Array {
   const_reverse_iterator crend() const noexcept;
 
  private:
+  /** Checks length against max_size() before new[], which would otherwise
+      be handed an overflowed size. */
+  static pointer Allocate(size_type length);
+  void FreeBuffer() noexcept;
+
   pointer buffer;
   size_type length;
+  release_function release = nullptr;
+  void* owner = nullptr;
 };
 
 // ============================================================================
@@ -78,7 +91,7 @@ inline constexpr Array<T>::Array() : buffer(nullptr), length(0) {}
 
 template <typename T>
 inline Array<T>::Array(size_type length)
-    : buffer(length > 0 ? new value_type[length] : nullptr), length(length) {
+    : buffer(Allocate(length)), length(length) {
   assert((length == 0 || buffer != nullptr) &&
          "Buffer pointer must not be null if length > 0");
 }
@@ -99,16 +112,47 @@ inline Array<T>::Array(pointer buff, size_type length)
          "Raw pointer buffer must not be null if length > 0");
 }
 
+template <typename T>
+inline Array<T>::Array(pointer buff, size_type length,
+                       release_function release, void* owner)
+    : buffer(buff), length(length), release(release), owner(owner) {
+  assert((length == 0 || this->buffer != nullptr) &&
+         "Raw pointer buffer must not be null if length > 0");
+}
+
 template <typename T>
 inline Array<T>::Array(Array&& other) noexcept
-    : buffer(other.buffer), length(other.length) {
+    : buffer(other.buffer),
+      length(other.length),
+      release(other.release),
+      owner(other.owner) {
   other.buffer = nullptr;
   other.length = 0;
+  other.release = nullptr;
+  other.owner = nullptr;
 }
 
 template <typename T>
 inline Array<T>::~Array() {
-  delete[] buffer;
+  FreeBuffer();
+}
+
+template <typename T>
+inline typename Array<T>::pointer Array<T>::Allocate(size_type length) {
+  if (length == 0) return nullptr;
+  if (length > std::numeric_limits<size_type>::max() / sizeof(value_type))
+    throw std::length_error("Array: length exceeds max_size()");
+
+  return new value_type[length];
+}
+
+template <typename T>
+inline void Array<T>::FreeBuffer() noexcept {
+  if (release) {
+    if (buffer) release(owner, buffer, length);
+  } else {
+    delete[] buffer;
+  }
 }
 
 template <typename T>
@@ -139,13 +183,17 @@ inline typename Array<T>::const_pointer Array<T>::data() const noexcept {
 template <typename T>
 inline Array<T>& Array<T>::operator=(Array<T>&& other) noexcept {
   if (this != &other) {
-    delete[] buffer;
+    FreeBuffer();
 
     buffer = other.buffer;
     length = other.length;
+    release = other.release;
+    owner = other.owner;
 
     other.buffer = nullptr;
     other.length = 0;
+    other.release = nullptr;
+    other.owner = nullptr;
   }
 
   return *this;
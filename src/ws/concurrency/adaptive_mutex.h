@@ -0,0 +1,229 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "ws/concurrency/internal/atomic_backoff.h"
+#include "ws/concurrency/internal/concurrent_monitor.h"
+
+namespace ws {
+namespace concurrency {
+/** Mutex that spins with AtomicBackoff for a short, bounded time and then
+    parks the thread on a ConcurrentMonitor. Short critical sections are
+    handed over without a syscall, long ones do not burn CPU. The lock word
+    also counts parked threads, so unlock only touches the monitor when
+    someone is actually waiting. Not fair. */
+class AdaptiveMutex {
+ public:
+  AdaptiveMutex() noexcept : state_(0) {}
+
+  ~AdaptiveMutex() = default;
+
+  AdaptiveMutex(const AdaptiveMutex&) = delete;
+  AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+
+  class ScopedLock {
+   public:
+    explicit ScopedLock(AdaptiveMutex& mutex) : m_mutex(mutex) {
+      m_mutex.lock();
+    }
+    ~ScopedLock() { m_mutex.unlock(); }
+
+    ScopedLock(const ScopedLock&) = delete;
+    ScopedLock& operator=(const ScopedLock&) = delete;
+
+   private:
+    AdaptiveMutex& m_mutex;
+  };
+
+  static constexpr bool kIsRwMutex = false;
+  static constexpr bool kIsRecursiveMutex = false;
+  static constexpr bool IsFairMutex = false;
+
+  void lock() {
+    for (ws::concurrency::internal::AtomicBackoff backoff;
+         backoff.BoundedWait();) {
+      if (try_lock()) return;
+    }
+
+    while (!try_lock()) {
+      state_.fetch_add(kOneWaiter, std::memory_order_relaxed);
+      monitor_.Wait<ws::concurrency::internal::ConcurrentMonitor::
+                        thread_context>(
+          [this] {
+            return (state_.load(std::memory_order_relaxed) & kLocked) == 0;
+          },
+          std::uintptr_t(0));
+      state_.fetch_sub(kOneWaiter, std::memory_order_relaxed);
+    }
+  }
+
+  bool try_lock() {
+    std::uintptr_t state = state_.load(std::memory_order_relaxed);
+    return (state & kLocked) == 0 &&
+           state_.compare_exchange_strong(state, state | kLocked,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+  void unlock() {
+    if (state_.fetch_sub(kLocked, std::memory_order_release) != kLocked) {
+      monitor_.NotifyOne();
+    }
+  }
+
+ private:
+  static constexpr std::uintptr_t kLocked = 1;
+  static constexpr std::uintptr_t kOneWaiter = 2;
+
+  std::atomic<std::uintptr_t> state_;
+  ws::concurrency::internal::ConcurrentMonitor monitor_;
+};
+
+/** Reader-writer counterpart of AdaptiveMutex. Writers announce themselves
+    with a pending bit so that a steady stream of readers cannot starve
+    them; both sides spin briefly and then park on a shared monitor. */
+class AdaptiveRwMutex {
+ public:
+  AdaptiveRwMutex() noexcept : state_(0), waiters_(0) {}
+
+  ~AdaptiveRwMutex() = default;
+
+  AdaptiveRwMutex(const AdaptiveRwMutex&) = delete;
+  AdaptiveRwMutex& operator=(const AdaptiveRwMutex&) = delete;
+
+  class ScopedLock {
+   public:
+    explicit ScopedLock(AdaptiveRwMutex& mutex, bool write = true)
+        : m_mutex(mutex), m_is_writer(write) {
+      if (m_is_writer) {
+        m_mutex.lock();
+      } else {
+        m_mutex.lock_shared();
+      }
+    }
+    ~ScopedLock() {
+      if (m_is_writer) {
+        m_mutex.unlock();
+      } else {
+        m_mutex.unlock_shared();
+      }
+    }
+
+    ScopedLock(const ScopedLock&) = delete;
+    ScopedLock& operator=(const ScopedLock&) = delete;
+
+   private:
+    AdaptiveRwMutex& m_mutex;
+    const bool m_is_writer;
+  };
+
+  static constexpr bool kIsRwMutex = true;
+  static constexpr bool kIsRecursiveMutex = false;
+  static constexpr bool IsFairMutex = false;
+
+  void lock() {
+    for (ws::concurrency::internal::AtomicBackoff backoff;
+         backoff.BoundedWait();) {
+      if (TryLockOrAnnounce()) return;
+    }
+
+    while (!TryLockOrAnnounce()) {
+      Park([this] {
+        return (state_.load(std::memory_order_relaxed) & kBusy) == 0;
+      });
+    }
+  }
+
+  bool try_lock() {
+    std::uintptr_t state = state_.load(std::memory_order_relaxed);
+    return (state & kBusy) == 0 &&
+           state_.compare_exchange_strong(state, kWriter,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+  void unlock() {
+    state_.fetch_and(~(kWriter | kWriterPending));
+    NotifyWaiters();
+  }
+
+  void lock_shared() {
+    for (ws::concurrency::internal::AtomicBackoff backoff;
+         backoff.BoundedWait();) {
+      if (try_lock_shared()) return;
+    }
+
+    while (!try_lock_shared()) {
+      Park([this] {
+        return (state_.load(std::memory_order_relaxed) &
+                (kWriter | kWriterPending)) == 0;
+      });
+    }
+  }
+
+  bool try_lock_shared() {
+    const std::uintptr_t state = state_.load(std::memory_order_relaxed);
+    if ((state & (kWriter | kWriterPending)) == 0) {
+      const std::uintptr_t previous =
+          state_.fetch_add(kOneReader, std::memory_order_acquire);
+      if ((previous & kWriter) == 0) return true;
+      // Backing out can be the last reader a parked writer waits for, so
+      // it releases like unlock_shared.
+      unlock_shared();
+    }
+    return false;
+  }
+
+  void unlock_shared() {
+    const std::uintptr_t previous = state_.fetch_sub(kOneReader);
+    if ((previous & kReaders) == kOneReader) {
+      NotifyWaiters();
+    }
+  }
+
+ private:
+  static constexpr std::uintptr_t kWriter = 1;
+  static constexpr std::uintptr_t kWriterPending = 2;
+  static constexpr std::uintptr_t kOneReader = 4;
+  static constexpr std::uintptr_t kReaders = ~(kWriter | kWriterPending);
+  static constexpr std::uintptr_t kBusy = kWriter | kReaders;
+
+  /** Takes the lock if it is free, otherwise sets the pending bit so new
+      readers back off. */
+  bool TryLockOrAnnounce() {
+    std::uintptr_t state = state_.load(std::memory_order_relaxed);
+    if ((state & kBusy) == 0) {
+      return state_.compare_exchange_strong(state, kWriter,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed);
+    }
+    if ((state & kWriterPending) == 0) {
+      state_.fetch_or(kWriterPending, std::memory_order_relaxed);
+    }
+    return false;
+  }
+
+  /** The waiter count and the releasing RMW on state_ are both seq_cst, so
+      either the unlocking thread sees the waiter or the waiter's predicate
+      sees the released state. */
+  template <typename TPredicate>
+  void Park(TPredicate ready) {
+    waiters_.fetch_add(1);
+    monitor_.Wait<ws::concurrency::internal::ConcurrentMonitor::
+                      thread_context>(ready, std::uintptr_t(0));
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void NotifyWaiters() {
+    if (waiters_.load() != 0) {
+      monitor_.NotifyAll();
+    }
+  }
+
+  std::atomic<std::uintptr_t> state_;
+  std::atomic<std::uintptr_t> waiters_;
+  ws::concurrency::internal::ConcurrentMonitor monitor_;
+};
+}  // namespace concurrency
+}  // namespace ws
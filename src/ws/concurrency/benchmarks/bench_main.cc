@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ws/concurrency/benchmarks/bench_util.h"
+
+namespace ws {
+namespace concurrency {
+namespace bench {
+namespace {
+std::vector<Registration>& Registrations() {
+  static std::vector<Registration> registrations;
+  return registrations;
+}
+
+std::vector<std::int64_t> ParseList(std::string_view text) {
+  std::vector<std::int64_t> values;
+  std::stringstream stream{std::string(text)};
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) values.push_back(std::stoll(item));
+  }
+  return values;
+}
+
+/** Powers of two up to the hardware concurrency, plus the concurrency
+    itself, and never less than two threads so contention always shows. */
+std::vector<int> DefaultThreads() {
+  const int hardware =
+      std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+  std::vector<int> threads;
+  for (int n = 1; n < hardware; n *= 2) {
+    threads.push_back(n);
+  }
+  threads.push_back(hardware);
+  return threads;
+}
+
+bool TakeFlag(std::string_view arg, std::string_view name,
+              std::string_view& value) {
+  if (!arg.starts_with(name) || arg.size() <= name.size() ||
+      arg[name.size()] != '=') {
+    return false;
+  }
+  value = arg.substr(name.size() + 1);
+  return true;
+}
+
+void PrintUsage() {
+  std::fprintf(
+      stderr,
+      "ws_concurrency_bench [--ws_threads=1,2,4] "
+      "[--ws_payload_sizes=8,64,256,1024] [--ws_read_percents=50,90,99] "
+      "[benchmark flags]\n"
+      "Results are printed as JSON unless --benchmark_format is given.\n");
+}
+}  // namespace
+
+bool AddRegistration(Registration registration) {
+  Registrations().push_back(registration);
+  return true;
+}
+}  // namespace bench
+}  // namespace concurrency
+}  // namespace ws
+
+int main(int argc, char** argv) {
+  namespace bench = ws::concurrency::bench;
+
+  bench::BenchConfig config;
+  config.threads = bench::DefaultThreads();
+  config.payload_sizes = {8, 256};
+  config.read_percents = {50, 90, 99};
+
+  bool has_format = false;
+  std::vector<char*> args = {argv[0]};
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    std::string_view value;
+    if (bench::TakeFlag(arg, "--ws_threads", value)) {
+      config.threads.clear();
+      for (std::int64_t n : bench::ParseList(value)) {
+        if (n > 0) config.threads.push_back(static_cast<int>(n));
+      }
+    } else if (bench::TakeFlag(arg, "--ws_payload_sizes", value)) {
+      config.payload_sizes = bench::ParseList(value);
+    } else if (bench::TakeFlag(arg, "--ws_read_percents", value)) {
+      config.read_percents = bench::ParseList(value);
+    } else if (arg == "--help") {
+      bench::PrintUsage();
+      args.push_back(argv[i]);
+    } else {
+      has_format = has_format || arg.starts_with("--benchmark_format=");
+      args.push_back(argv[i]);
+    }
+  }
+
+  for (std::int64_t size : config.payload_sizes) {
+    if (std::find(bench::kPayloadSizes.begin(), bench::kPayloadSizes.end(),
+                  size) == bench::kPayloadSizes.end()) {
+      std::fprintf(stderr, "unsupported payload size %lld\n",
+                   static_cast<long long>(size));
+      return 1;
+    }
+  }
+  for (std::int64_t percent : config.read_percents) {
+    if (percent < 0 || percent > 100) {
+      std::fprintf(stderr, "read percent %lld is not in [0, 100]\n",
+                   static_cast<long long>(percent));
+      return 1;
+    }
+  }
+  if (config.threads.empty()) config.threads = {1};
+
+  char json_format[] = "--benchmark_format=json";
+  if (!has_format) args.push_back(json_format);
+
+  for (bench::Registration registration : bench::Registrations()) {
+    registration(config);
+  }
+
+  int benchmark_argc = static_cast<int>(args.size());
+  args.push_back(nullptr);
+  benchmark::Initialize(&benchmark_argc, args.data());
+  if (benchmark::ReportUnrecognizedArguments(benchmark_argc, args.data())) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include "ws/concurrency/benchmarks/bench_util.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ws {
+namespace concurrency {
+namespace bench {
+namespace {
+/** Parses a sysfs cpulist such as "0-3,8,10-11". */
+std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty()) continue;
+    const std::size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last =
+        dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+}  // namespace
+
+std::vector<std::vector<int>> NumaNodeCpus() {
+  std::vector<std::vector<int>> nodes;
+  for (int node = 0;; ++node) {
+    std::ifstream file("/sys/devices/system/node/node" +
+                       std::to_string(node) + "/cpulist");
+    if (!file) break;
+    std::string list;
+    std::getline(file, list);
+    nodes.push_back(ParseCpuList(list));
+  }
+  return nodes;
+}
+
+#if defined(__linux__)
+ScopedAffinity::ScopedAffinity(const std::vector<int>& cpus) {
+  if (cpus.empty()) return;
+  cpu_set_t previous;
+  if (sched_getaffinity(0, sizeof(previous), &previous) != 0) return;
+
+  cpu_set_t wanted;
+  CPU_ZERO(&wanted);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &wanted);
+  }
+  if (sched_setaffinity(0, sizeof(wanted), &wanted) != 0) return;
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&previous);
+  previous_.assign(bytes, bytes + sizeof(previous));
+}
+
+ScopedAffinity::~ScopedAffinity() {
+  if (previous_.empty()) return;
+  sched_setaffinity(0, previous_.size(),
+                    reinterpret_cast<const cpu_set_t*>(previous_.data()));
+}
+
+int PageNumaNode(const void* address) {
+#if defined(SYS_move_pages)
+  // With a null node list move_pages only reports where each page lives.
+  const long page_size = sysconf(_SC_PAGESIZE);
+  void* page = reinterpret_cast<void*>(
+      reinterpret_cast<std::uintptr_t>(address) &
+      ~static_cast<std::uintptr_t>(page_size - 1));
+  int status = -1;
+  if (syscall(SYS_move_pages, 0, 1UL, &page, nullptr, &status, 0) == 0 &&
+      status >= 0) {
+    return status;
+  }
+#else
+  (void)address;
+#endif
+  return -1;
+}
+
+std::size_t ResidentBytes() {
+  // The second field of statm is the resident page count.
+  std::ifstream file("/proc/self/statm");
+  std::size_t pages = 0;
+  std::size_t resident = 0;
+  if (!(file >> pages >> resident)) return 0;
+  return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+#else
+ScopedAffinity::ScopedAffinity(const std::vector<int>&) {}
+
+ScopedAffinity::~ScopedAffinity() = default;
+
+int PageNumaNode(const void*) { return -1; }
+
+std::size_t ResidentBytes() { return 0; }
+#endif
+}  // namespace bench
+}  // namespace concurrency
+}  // namespace ws
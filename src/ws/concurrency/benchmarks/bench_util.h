@@ -0,0 +1,124 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ws {
+namespace concurrency {
+namespace bench {
+/** Knobs shared by every benchmark, parsed from the --ws_* flags before
+    Google Benchmark sees the command line. */
+struct BenchConfig {
+  std::vector<int> threads;
+  std::vector<std::int64_t> payload_sizes;
+  std::vector<std::int64_t> read_percents;
+};
+
+using Registration = void (*)(const BenchConfig& config);
+
+/** Queues a registration that runs once the configuration is known.
+    Returns a value so that it can initialize a namespace-scope constant. */
+bool AddRegistration(Registration registration);
+
+/** Element of a given size for queue benchmarks; the first word carries a
+    sequence number so that copies cannot be elided. */
+template <std::size_t N>
+struct Payload {
+  static_assert(N >= sizeof(std::uint64_t));
+
+  Payload() = default;
+  explicit Payload(std::uint64_t sequence) { words[0] = sequence; }
+
+  std::array<std::uint64_t, N / sizeof(std::uint64_t)> words{};
+};
+
+/** Calls TFunctor::template Run<Payload<N>>(args...) for the payload size
+    picked at run time. Only the sizes listed in kPayloadSizes are
+    instantiated; other values are rejected when the flags are parsed. */
+inline constexpr std::array<std::int64_t, 4> kPayloadSizes = {8, 64, 256,
+                                                              1024};
+
+template <typename TFunctor, typename... TArgs>
+void WithPayload(std::int64_t size, TArgs&&... args) {
+  switch (size) {
+    case 8:
+      TFunctor::template Run<Payload<8>>(args...);
+      break;
+    case 64:
+      TFunctor::template Run<Payload<64>>(args...);
+      break;
+    case 256:
+      TFunctor::template Run<Payload<256>>(args...);
+      break;
+    default:
+      TFunctor::template Run<Payload<1024>>(args...);
+      break;
+  }
+}
+
+/** Applies the configured thread counts to a registered benchmark. */
+inline benchmark::internal::Benchmark* ApplyThreads(
+    benchmark::internal::Benchmark* b, const BenchConfig& config) {
+  for (int threads : config.threads) {
+    b->Threads(threads);
+  }
+  return b->UseRealTime();
+}
+
+/** Small per-thread generator; the benchmarks only need cheap, well-mixed
+    keys, not statistical quality. */
+class FastRandom {
+ public:
+  explicit FastRandom(std::uint64_t seed)
+      : state_(seed * 0x9E3779B97F4A7C15ull | 1) {}
+
+  std::uint64_t Next() {
+    std::uint64_t x = state_;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    state_ = x;
+    return x;
+  }
+
+  /** Uniform-enough value in [0, bound). */
+  std::uint64_t Next(std::uint64_t bound) {
+    return static_cast<std::uint64_t>(
+        (static_cast<unsigned __int128>(Next()) * bound) >> 64);
+  }
+
+ private:
+  std::uint64_t state_;
+};
+
+/** CPUs of every NUMA node as listed under /sys/devices/system/node. Empty
+    when the topology is not exposed. */
+std::vector<std::vector<int>> NumaNodeCpus();
+
+/** Restricts the calling thread to cpus and restores the previous mask on
+    destruction. Does nothing when cpus is empty or the call fails. */
+class ScopedAffinity {
+ public:
+  explicit ScopedAffinity(const std::vector<int>& cpus);
+  ~ScopedAffinity();
+
+  ScopedAffinity(const ScopedAffinity&) = delete;
+  ScopedAffinity& operator=(const ScopedAffinity&) = delete;
+
+ private:
+  std::vector<unsigned char> previous_;
+};
+
+/** NUMA node backing the page that holds address, or -1 when unknown. */
+int PageNumaNode(const void* address);
+
+/** Resident set size of the process in bytes, or 0 when unknown. */
+std::size_t ResidentBytes();
+}  // namespace bench
+}  // namespace concurrency
+}  // namespace ws
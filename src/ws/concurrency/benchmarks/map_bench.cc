@@ -0,0 +1,178 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "ws/concurrency/benchmarks/bench_util.h"
+#include "ws/concurrency/concurrent_flat_map.h"
+#include "ws/concurrency/concurrent_map.h"
+#include "ws/concurrency/concurrent_unordered_map.h"
+#include "ws/concurrency/concurrent_unordered_set.h"
+
+namespace ws {
+namespace concurrency {
+namespace bench {
+namespace {
+constexpr std::uint64_t kKeys = 1 << 16;
+
+template <typename TContainer>
+auto MakeValue(std::uint64_t key) {
+  if constexpr (requires { typename TContainer::mapped_type; }) {
+    return typename TContainer::value_type(key, key);
+  } else {
+    return key;
+  }
+}
+
+/** Pre-fills every other key so that reads hit about half the time and
+    writes find both present and absent keys. */
+template <typename TContainer>
+std::unique_ptr<TContainer> MakeHalfFull() {
+  auto container = std::make_unique<TContainer>();
+  for (std::uint64_t key = 0; key < kKeys; key += 2) {
+    container->Insert(MakeValue<TContainer>(key));
+  }
+  return container;
+}
+
+/** range(0) is the share of lookups in percent. Writes insert or erase a
+    random key with equal odds, so the size stays near its starting point
+    and erase goes through the epoch-based concurrent path. */
+template <typename TContainer>
+void BM_Unordered_Mixed(benchmark::State& state) {
+  static std::unique_ptr<TContainer> container;
+  if (state.thread_index() == 0) container = MakeHalfFull<TContainer>();
+  const std::uint64_t read_percent = state.range(0);
+  FastRandom random(state.thread_index() + 1);
+  for (auto _ : state) {
+    const std::uint64_t key = random.Next(kKeys);
+    if (random.Next(100) < read_percent) {
+      auto guard = container->Pin();
+      auto it = container->Find(key);
+      if (it != container->end()) benchmark::DoNotOptimize(&*it);
+    } else if (random.Next() & 1) {
+      benchmark::DoNotOptimize(container->Insert(MakeValue<TContainer>(key)));
+    } else {
+      benchmark::DoNotOptimize(container->Erase(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) container.reset();
+}
+
+/** range(1) is the share of table slots in use, in percent: the table is
+    sized for kKeys and filled with every other key of a range twice as
+    long as the fill, so reads miss half the time. ConcurrentFlatMap has no
+    concurrent erase, so writes re-insert present keys; inserting new ones
+    would raise the load, and the table would migrate, during the run. */
+void BM_FlatMap_Mixed(benchmark::State& state) {
+  using map_type = ConcurrentFlatMap<std::uint64_t, std::uint64_t>;
+  static std::unique_ptr<map_type> map;
+  static std::uint64_t key_range;
+  if (state.thread_index() == 0) {
+    map = std::make_unique<map_type>(kKeys);
+    key_range = map->Capacity() * state.range(1) / 100 * 2;
+    for (std::uint64_t key = 0; key < key_range; key += 2) {
+      map->Insert({key, key});
+    }
+  }
+  const std::uint64_t read_percent = state.range(0);
+  FastRandom random(state.thread_index() + 1);
+  for (auto _ : state) {
+    const std::uint64_t key = random.Next(key_range);
+    if (random.Next(100) < read_percent) {
+      auto it = map->Find(key);
+      if (it != map->end()) benchmark::DoNotOptimize(it->second);
+    } else {
+      const std::uint64_t present = key & ~std::uint64_t{1};
+      benchmark::DoNotOptimize(map->Insert({present, present}));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) map.reset();
+}
+
+/** Every thread inserts its own random keys into one skip list; shows how
+    insertion scales as the list grows. */
+void BM_ConcurrentMap_Insert(benchmark::State& state) {
+  using map_type = ConcurrentMap<std::uint64_t, std::uint64_t>;
+  static std::unique_ptr<map_type> map;
+  if (state.thread_index() == 0) map = std::make_unique<map_type>();
+  FastRandom random(state.thread_index() + 1);
+  for (auto _ : state) {
+    const std::uint64_t key = random.Next();
+    benchmark::DoNotOptimize(map->Insert({key, key}));
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) map.reset();
+}
+
+/** Reads are ordered scans: LowerBound of a random key followed by a walk
+    over the next 16 entries. Writes insert random keys. */
+void BM_ConcurrentMap_Mixed(benchmark::State& state) {
+  using map_type = ConcurrentMap<std::uint64_t, std::uint64_t>;
+  static std::unique_ptr<map_type> map;
+  if (state.thread_index() == 0) map = MakeHalfFull<map_type>();
+  const std::uint64_t read_percent = state.range(0);
+  FastRandom random(state.thread_index() + 1);
+  for (auto _ : state) {
+    const std::uint64_t key = random.Next(kKeys);
+    if (random.Next(100) < read_percent) {
+      std::uint64_t sum = 0;
+      auto it = map->LowerBound(key);
+      for (int i = 0; i < 16 && it != map->end(); ++i, ++it) {
+        sum += it->second;
+      }
+      benchmark::DoNotOptimize(sum);
+    } else {
+      benchmark::DoNotOptimize(map->Insert({key, key}));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) map.reset();
+}
+
+void RegisterMapBenchmarks(const BenchConfig& config) {
+  for (std::int64_t read_percent : config.read_percents) {
+    ApplyThreads(
+        benchmark::RegisterBenchmark(
+            "BM_Unordered_Mixed<ConcurrentUnorderedMap>",
+            BM_Unordered_Mixed<
+                ConcurrentUnorderedMap<std::uint64_t, std::uint64_t>>)
+            ->ArgName("read_percent")
+            ->Arg(read_percent),
+        config);
+    ApplyThreads(benchmark::RegisterBenchmark(
+                     "BM_Unordered_Mixed<ConcurrentUnorderedSet>",
+                     BM_Unordered_Mixed<ConcurrentUnorderedSet<std::uint64_t>>)
+                     ->ArgName("read_percent")
+                     ->Arg(read_percent),
+                 config);
+    // Migration starts at three quarters full, so 70 is the densest
+    // table a run can start from.
+    ApplyThreads(benchmark::RegisterBenchmark("BM_FlatMap_Mixed",
+                                              BM_FlatMap_Mixed)
+                     ->ArgNames({"read_percent", "load_percent"})
+                     ->Args({read_percent, 25})
+                     ->Args({read_percent, 50})
+                     ->Args({read_percent, 70}),
+                 config);
+    ApplyThreads(benchmark::RegisterBenchmark("BM_ConcurrentMap_Mixed",
+                                              BM_ConcurrentMap_Mixed)
+                     ->ArgName("read_percent")
+                     ->Arg(read_percent),
+                 config);
+  }
+  ApplyThreads(benchmark::RegisterBenchmark("BM_ConcurrentMap_Insert",
+                                            BM_ConcurrentMap_Insert),
+               config);
+}
+
+[[maybe_unused]] const bool kRegistered =
+    AddRegistration(RegisterMapBenchmarks);
+}  // namespace
+}  // namespace bench
+}  // namespace concurrency
+}  // namespace ws
@@ -0,0 +1,263 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ws/concurrency/benchmarks/bench_util.h"
+#include "ws/concurrency/concurrent_unordered_map.h"
+#include "ws/concurrency/scalable_allocator.h"
+#include "ws/concurrency/sharded_counter.h"
+#include "ws/concurrency/sharded_histogram.h"
+#include "ws/concurrency/thread_pool.h"
+
+namespace ws {
+namespace concurrency {
+namespace bench {
+namespace {
+/** Submits range(1) empty tasks to a pool of range(0) workers and waits for
+    all of them; measures the submit and wake-up path. */
+void BM_ThreadPool_Submit(benchmark::State& state) {
+  ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+  const std::int64_t tasks = state.range(1);
+  std::atomic<std::int64_t> done{0};
+  for (auto _ : state) {
+    done.store(0, std::memory_order_relaxed);
+    for (std::int64_t i = 0; i < tasks; ++i) {
+      pool.Submit([&done] { done.fetch_add(1, std::memory_order_release); });
+    }
+    while (done.load(std::memory_order_acquire) != tasks) {
+      std::this_thread::yield();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * tasks);
+}
+
+void BM_ThreadPool_ParallelFor(benchmark::State& state) {
+  ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+  constexpr std::int64_t kRange = 1 << 16;
+  const std::int64_t grain = state.range(1);
+  std::unique_ptr<std::uint64_t[]> data(new std::uint64_t[kRange]());
+  for (auto _ : state) {
+    pool.ParallelFor<std::int64_t>(0, kRange, grain, [&](std::int64_t i) {
+      data[i] = data[i] * 31 + static_cast<std::uint64_t>(i);
+    });
+    benchmark::DoNotOptimize(data.get());
+  }
+  state.SetItemsProcessed(state.iterations() * kRange);
+}
+
+/** Allocates a batch of range(0)-byte blocks and frees it again, so the
+    fast path of the allocator dominates. */
+template <typename TAllocator>
+void BM_Allocator_Batch(benchmark::State& state) {
+  constexpr std::size_t kBatch = 32;
+  const std::size_t bytes = static_cast<std::size_t>(state.range(0));
+  TAllocator allocator;
+  std::array<char*, kBatch> blocks;
+  for (auto _ : state) {
+    for (char*& block : blocks) {
+      block = allocator.allocate(bytes);
+      benchmark::DoNotOptimize(block);
+    }
+    for (char* block : blocks) {
+      allocator.deallocate(block, bytes);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+/** Every thread inserts range(0) keys of its own into one shared map and
+    erases them again, so each item is a node allocation plus a deferred
+    free through the map's epoch reclamation. */
+template <template <typename> class TAllocator>
+void BM_Allocator_UnorderedMap(benchmark::State& state) {
+  using map_type = ConcurrentUnorderedMap<
+      std::uint64_t, std::uint64_t, std::hash<std::uint64_t>,
+      std::equal_to<std::uint64_t>,
+      TAllocator<std::pair<const std::uint64_t, std::uint64_t>>>;
+  static std::unique_ptr<map_type> map;
+  if (state.thread_index() == 0) map = std::make_unique<map_type>();
+  const std::uint64_t batch = static_cast<std::uint64_t>(state.range(0));
+  const std::uint64_t first =
+      static_cast<std::uint64_t>(state.thread_index()) << 32;
+  for (auto _ : state) {
+    for (std::uint64_t key = first; key < first + batch; ++key) {
+      map->Insert({key, key});
+    }
+    for (std::uint64_t key = first; key < first + batch; ++key) {
+      map->Erase(key);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+  if (state.thread_index() == 0) map.reset();
+}
+
+/** Keeps 4096 live blocks per thread and replaces a random one with a
+    block of a new random size in [16, range(0)) bytes per iteration. The
+    rss_mb counter is the resident set when the timed loop ends, including
+    whatever the allocator keeps cached and whatever earlier benchmarks
+    left behind; select one allocator per process with --benchmark_filter
+    to compare footprints. */
+template <typename TAllocator>
+void BM_Allocator_Churn(benchmark::State& state) {
+  constexpr std::size_t kLiveBlocks = 4096;
+  const std::uint64_t max_bytes = static_cast<std::uint64_t>(state.range(0));
+  TAllocator allocator;
+  FastRandom random(state.thread_index() + 1);
+  std::vector<std::pair<char*, std::size_t>> blocks(kLiveBlocks);
+  for (auto& [block, bytes] : blocks) {
+    bytes = 16 + random.Next(max_bytes - 16);
+    block = allocator.allocate(bytes);
+  }
+  for (auto _ : state) {
+    auto& [block, bytes] = blocks[random.Next(kLiveBlocks)];
+    allocator.deallocate(block, bytes);
+    bytes = 16 + random.Next(max_bytes - 16);
+    // DoNotOptimize goes through a local: GCC splits its "+m,r" operand
+    // into "=m,r" and "m,0", and on a vector element the output can land
+    // in a spill slot while the store to block is dropped as dead.
+    char* fresh = allocator.allocate(bytes);
+    benchmark::DoNotOptimize(fresh);
+    block = fresh;
+  }
+  if (state.thread_index() == 0) {
+    state.counters["rss_mb"] = static_cast<double>(ResidentBytes()) / 1e6;
+  }
+  for (auto& [block, bytes] : blocks) {
+    allocator.deallocate(block, bytes);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Counter_Increment_Atomic(benchmark::State& state) {
+  static std::atomic<std::int64_t> counter{0};
+  for (auto _ : state) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Counter_Increment_Sharded(benchmark::State& state) {
+  static std::unique_ptr<ShardedCounter> counter;
+  if (state.thread_index() == 0) counter = std::make_unique<ShardedCounter>();
+  for (auto _ : state) {
+    counter->Increment();
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) counter.reset();
+}
+
+/** The single-word alternative to ShardedHistogram: one atomic per bucket
+    plus a shared count and sum. */
+void BM_Histogram_Record_Atomic(benchmark::State& state) {
+  static std::array<std::atomic<std::uint64_t>,
+                    ShardedHistogram::kNumBuckets + 2>
+      words{};
+  FastRandom random(state.thread_index() + 1);
+  for (auto _ : state) {
+    const std::uint64_t value = random.Next(1 << 20);
+    const int bucket = std::bit_width(value);
+    words[bucket].fetch_add(1, std::memory_order_relaxed);
+    words[ShardedHistogram::kNumBuckets].fetch_add(1,
+                                                   std::memory_order_relaxed);
+    words[ShardedHistogram::kNumBuckets + 1].fetch_add(
+        value, std::memory_order_relaxed);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Histogram_Record_Sharded(benchmark::State& state) {
+  static std::unique_ptr<ShardedHistogram> histogram;
+  if (state.thread_index() == 0) {
+    histogram = std::make_unique<ShardedHistogram>();
+  }
+  FastRandom random(state.thread_index() + 1);
+  for (auto _ : state) {
+    histogram->Record(random.Next(1 << 20));
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) histogram.reset();
+}
+
+void RegisterMiscBenchmarks(const BenchConfig& config) {
+  for (int threads : config.threads) {
+    benchmark::RegisterBenchmark("BM_ThreadPool_Submit", BM_ThreadPool_Submit)
+        ->ArgNames({"workers", "tasks"})
+        ->Args({threads, 64})
+        ->Args({threads, 1024})
+        ->UseRealTime();
+    benchmark::RegisterBenchmark("BM_ThreadPool_ParallelFor",
+                                 BM_ThreadPool_ParallelFor)
+        ->ArgNames({"workers", "grain"})
+        ->Args({threads, 256})
+        ->Args({threads, 4096})
+        ->UseRealTime();
+  }
+  for (std::int64_t bytes : {16, 64, 512, 4096}) {
+    ApplyThreads(benchmark::RegisterBenchmark(
+                     "BM_Allocator_Batch<ScalableAllocator>",
+                     BM_Allocator_Batch<ScalableAllocator<char>>)
+                     ->ArgName("bytes")
+                     ->Arg(bytes),
+                 config);
+    ApplyThreads(benchmark::RegisterBenchmark(
+                     "BM_Allocator_Batch<std::allocator>",
+                     BM_Allocator_Batch<std::allocator<char>>)
+                     ->ArgName("bytes")
+                     ->Arg(bytes),
+                 config);
+  }
+  ApplyThreads(benchmark::RegisterBenchmark(
+                   "BM_Allocator_UnorderedMap<ScalableAllocator>",
+                   BM_Allocator_UnorderedMap<ScalableAllocator>)
+                   ->ArgName("batch")
+                   ->Arg(256),
+               config);
+  ApplyThreads(benchmark::RegisterBenchmark(
+                   "BM_Allocator_UnorderedMap<std::allocator>",
+                   BM_Allocator_UnorderedMap<std::allocator>)
+                   ->ArgName("batch")
+                   ->Arg(256),
+               config);
+  for (std::int64_t max_bytes : {256, 4096}) {
+    ApplyThreads(benchmark::RegisterBenchmark(
+                     "BM_Allocator_Churn<ScalableAllocator>",
+                     BM_Allocator_Churn<ScalableAllocator<char>>)
+                     ->ArgName("max_bytes")
+                     ->Arg(max_bytes),
+                 config);
+    ApplyThreads(benchmark::RegisterBenchmark(
+                     "BM_Allocator_Churn<std::allocator>",
+                     BM_Allocator_Churn<std::allocator<char>>)
+                     ->ArgName("max_bytes")
+                     ->Arg(max_bytes),
+                 config);
+  }
+  ApplyThreads(benchmark::RegisterBenchmark("BM_Counter_Increment_Atomic",
+                                            BM_Counter_Increment_Atomic),
+               config);
+  ApplyThreads(benchmark::RegisterBenchmark("BM_Counter_Increment_Sharded",
+                                            BM_Counter_Increment_Sharded),
+               config);
+  ApplyThreads(benchmark::RegisterBenchmark("BM_Histogram_Record_Atomic",
+                                            BM_Histogram_Record_Atomic),
+               config);
+  ApplyThreads(benchmark::RegisterBenchmark("BM_Histogram_Record_Sharded",
+                                            BM_Histogram_Record_Sharded),
+               config);
+}
+
+[[maybe_unused]] const bool kRegistered =
+    AddRegistration(RegisterMiscBenchmarks);
+}  // namespace
+}  // namespace bench
+}  // namespace concurrency
+}  // namespace ws
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+#include "ws/concurrency/adaptive_mutex.h"
+#include "ws/concurrency/benchmarks/bench_util.h"
+#include "ws/concurrency/spin_mutex.h"
+
+namespace ws {
+namespace concurrency {
+namespace bench {
+namespace {
+/** Shared data guarded by the mutex under test; range(0) is the number of
+    dependent updates done while holding the lock. */
+template <typename TMutex>
+struct Guarded {
+  TMutex mutex;
+  std::uint64_t value = 0;
+};
+
+template <typename TMutex>
+void BM_Mutex_Lock(benchmark::State& state) {
+  static std::unique_ptr<Guarded<TMutex>> guarded;
+  if (state.thread_index() == 0) {
+    guarded = std::make_unique<Guarded<TMutex>>();
+  }
+  const std::int64_t work = state.range(0);
+  for (auto _ : state) {
+    std::lock_guard<TMutex> lock(guarded->mutex);
+    for (std::int64_t i = 0; i < work; ++i) {
+      guarded->value = guarded->value * 31 + 1;
+    }
+    benchmark::DoNotOptimize(guarded->value);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) guarded.reset();
+}
+
+/** range(0) is the share of shared (reader) acquisitions in percent. */
+template <typename TMutex>
+void BM_RwMutex_Mixed(benchmark::State& state) {
+  static std::unique_ptr<Guarded<TMutex>> guarded;
+  if (state.thread_index() == 0) {
+    guarded = std::make_unique<Guarded<TMutex>>();
+  }
+  const std::uint64_t read_percent = state.range(0);
+  FastRandom random(state.thread_index() + 1);
+  for (auto _ : state) {
+    if (random.Next(100) < read_percent) {
+      std::shared_lock<TMutex> lock(guarded->mutex);
+      benchmark::DoNotOptimize(guarded->value);
+    } else {
+      std::lock_guard<TMutex> lock(guarded->mutex);
+      ++guarded->value;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) guarded.reset();
+}
+
+template <typename TMutex>
+void RegisterLock(const char* name, const BenchConfig& config) {
+  ApplyThreads(benchmark::RegisterBenchmark(name, BM_Mutex_Lock<TMutex>)
+                   ->ArgName("work")
+                   ->Arg(0)
+                   ->Arg(16)
+                   ->Arg(256),
+               config);
+}
+
+template <typename TMutex>
+void RegisterRw(const char* name, const BenchConfig& config) {
+  for (std::int64_t read_percent : config.read_percents) {
+    ApplyThreads(benchmark::RegisterBenchmark(name, BM_RwMutex_Mixed<TMutex>)
+                     ->ArgName("read_percent")
+                     ->Arg(read_percent),
+                 config);
+  }
+}
+
+void RegisterMutexBenchmarks(const BenchConfig& config) {
+  RegisterLock<SpinMutex>("BM_Mutex_Lock<SpinMutex>", config);
+  RegisterLock<AdaptiveMutex>("BM_Mutex_Lock<AdaptiveMutex>", config);
+  RegisterLock<std::mutex>("BM_Mutex_Lock<std::mutex>", config);
+  RegisterRw<AdaptiveRwMutex>("BM_RwMutex_Mixed<AdaptiveRwMutex>", config);
+  RegisterRw<std::shared_mutex>("BM_RwMutex_Mixed<std::shared_mutex>",
+                                config);
+}
+
+[[maybe_unused]] const bool kRegistered =
+    AddRegistration(RegisterMutexBenchmarks);
+}  // namespace
+}  // namespace bench
+}  // namespace concurrency
+}  // namespace ws
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ws/concurrency/benchmarks/bench_util.h"
+#include "ws/concurrency/concurrent_unordered_map.h"
+#include "ws/concurrency/internal/numa.h"
+#include "ws/concurrency/numa_policy.h"
+
+namespace ws {
+namespace concurrency {
+namespace bench {
+namespace {
+constexpr std::uint64_t kKeys = 1 << 16;
+
+/** Producers (even threads) are pinned to the first NUMA node and insert;
+    consumers (odd threads) are pinned to the last node and look up. Every
+    64th hit of a consumer samples the node of the page holding the element
+    and counts it as remote when it differs from the consumer's node.
+    range(0) selects the NumaPolicy of the map. On a single-node machine
+    the pinning is a no-op and remote_pages stays zero. */
+void BM_Numa_UnorderedMap_ProducerConsumer(benchmark::State& state) {
+  using map_type = ConcurrentUnorderedMap<std::uint64_t, std::uint64_t>;
+  static std::unique_ptr<map_type> map;
+
+  const std::vector<std::vector<int>> nodes = NumaNodeCpus();
+  const bool producer = state.thread_index() % 2 == 0;
+  ScopedAffinity affinity(nodes.empty() ? std::vector<int>()
+                          : producer    ? nodes.front()
+                                        : nodes.back());
+
+  if (state.thread_index() == 0) {
+    map = std::make_unique<map_type>();
+    map->SetNumaPolicy(static_cast<NumaPolicy>(state.range(0)));
+    for (std::uint64_t key = 0; key < kKeys; key += 2) {
+      map->Insert({key, key});
+    }
+  }
+
+  FastRandom random(state.thread_index() + 1);
+  std::int64_t hits = 0;
+  std::int64_t sampled = 0;
+  std::int64_t remote = 0;
+  for (auto _ : state) {
+    const std::uint64_t key = random.Next(kKeys);
+    if (producer) {
+      benchmark::DoNotOptimize(map->Insert({key, key}));
+      continue;
+    }
+    auto it = map->Find(key);
+    if (it == map->end()) continue;
+    benchmark::DoNotOptimize(it->second);
+    if (++hits % 64 != 0) continue;
+    const int page_node = PageNumaNode(&*it);
+    const int cpu_node = internal::CurrentNumaNode();
+    if (page_node < 0 || cpu_node < 0) continue;
+    ++sampled;
+    remote += page_node != cpu_node;
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["numa_nodes"] = benchmark::Counter(
+      static_cast<double>(nodes.size()), benchmark::Counter::kAvgThreads);
+  state.counters["sampled_pages"] = static_cast<double>(sampled);
+  state.counters["remote_pages"] = static_cast<double>(remote);
+  if (state.thread_index() == 0) map.reset();
+}
+
+void RegisterNumaBenchmarks(const BenchConfig& config) {
+  auto* b = benchmark::RegisterBenchmark(
+                "BM_Numa_UnorderedMap_ProducerConsumer",
+                BM_Numa_UnorderedMap_ProducerConsumer)
+                ->ArgName("local_policy")
+                ->Arg(static_cast<std::int64_t>(NumaPolicy::kDefault))
+                ->Arg(static_cast<std::int64_t>(NumaPolicy::kLocal))
+                ->UseRealTime();
+  bool any = false;
+  for (int threads : config.threads) {
+    if (threads < 2) continue;
+    b->Threads(threads);
+    any = true;
+  }
+  if (!any) b->Threads(2);
+}
+
+[[maybe_unused]] const bool kRegistered =
+    AddRegistration(RegisterNumaBenchmarks);
+}  // namespace
+}  // namespace bench
+}  // namespace concurrency
+}  // namespace ws
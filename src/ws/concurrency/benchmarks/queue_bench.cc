@@ -0,0 +1,352 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ws/concurrency/benchmarks/bench_util.h"
+#include "ws/concurrency/blocking_queue.h"
+#include "ws/concurrency/concurrent_priority_queue.h"
+#include "ws/concurrency/concurrent_queue.h"
+#include "ws/concurrency/spsc_ring_buffer.h"
+#include "ws/concurrency/synchronized_queue.h"
+
+namespace ws {
+namespace concurrency {
+namespace bench {
+namespace {
+// Every thread pushes before it pops, so the queue is never empty when a
+// thread pops and blocking pops always return.
+
+template <typename TPayload>
+void BM_ConcurrentQueue_PushPop(benchmark::State& state) {
+  static std::unique_ptr<ConcurrentQueue<TPayload>> queue;
+  if (state.thread_index() == 0) {
+    queue = std::make_unique<ConcurrentQueue<TPayload>>();
+  }
+  std::uint64_t sequence = 0;
+  TPayload item;
+  for (auto _ : state) {
+    queue->Push(TPayload(++sequence));
+    while (!queue->TryPop(item)) {
+    }
+    benchmark::DoNotOptimize(item);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * sizeof(TPayload));
+  if (state.thread_index() == 0) queue.reset();
+}
+
+template <typename TPayload>
+void BM_ConcurrentQueue_PushRangeTryPopBulk(benchmark::State& state) {
+  static std::unique_ptr<ConcurrentQueue<TPayload>> queue;
+  if (state.thread_index() == 0) {
+    queue = std::make_unique<ConcurrentQueue<TPayload>>();
+  }
+  const std::size_t batch = static_cast<std::size_t>(state.range(0));
+  std::vector<TPayload> in(batch);
+  std::vector<TPayload> out(batch);
+  for (auto _ : state) {
+    queue->PushRange(in.begin(), in.end());
+    for (std::size_t popped = 0; popped != batch;) {
+      popped += queue->TryPopBulk(out.begin() + popped, batch - popped);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+  state.SetBytesProcessed(state.iterations() * batch * sizeof(TPayload));
+  if (state.thread_index() == 0) queue.reset();
+}
+
+template <typename TPayload>
+void BM_BlockingQueue_PushPop(benchmark::State& state) {
+  static std::unique_ptr<BlockingQueue<TPayload>> queue;
+  if (state.thread_index() == 0) {
+    queue = std::make_unique<BlockingQueue<TPayload>>();
+  }
+  std::uint64_t sequence = 0;
+  TPayload item;
+  for (auto _ : state) {
+    queue->Push(TPayload(++sequence));
+    queue->Pop(item);
+    benchmark::DoNotOptimize(item);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * sizeof(TPayload));
+  if (state.thread_index() == 0) queue.reset();
+}
+
+template <typename TPayload>
+void BM_SynchronizedQueue_PushPop(benchmark::State& state) {
+  static std::unique_ptr<SynchronizedQueue<TPayload>> queue;
+  if (state.thread_index() == 0) {
+    queue = std::make_unique<SynchronizedQueue<TPayload>>();
+  }
+  std::uint64_t sequence = 0;
+  TPayload item;
+  for (auto _ : state) {
+    queue->Push(TPayload(++sequence));
+    queue->Pop(item);
+    benchmark::DoNotOptimize(item);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * sizeof(TPayload));
+  if (state.thread_index() == 0) queue.reset();
+}
+
+/** Thread 0 produces and thread 1 consumes; both run the same number of
+    iterations, so every pushed item is popped. range(0) turns on
+    blocking waits. */
+template <typename TPayload>
+void BM_SpscRingBuffer_PushPop(benchmark::State& state) {
+  static std::unique_ptr<SpscRingBuffer<TPayload>> ring;
+  if (state.thread_index() == 0) {
+    ring = std::make_unique<SpscRingBuffer<TPayload>>(1024,
+                                                      state.range(0) != 0);
+  }
+  std::uint64_t sequence = 0;
+  TPayload item;
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      ring->Push(TPayload(++sequence));
+    } else {
+      ring->Pop(item);
+      benchmark::DoNotOptimize(item);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * sizeof(TPayload));
+  if (state.thread_index() == 0) ring.reset();
+}
+
+template <typename TPayload>
+void BM_SpscRingBuffer_PushRangeTryPopBulk(benchmark::State& state) {
+  static std::unique_ptr<SpscRingBuffer<TPayload>> ring;
+  if (state.thread_index() == 0) {
+    ring = std::make_unique<SpscRingBuffer<TPayload>>(1024);
+  }
+  const std::size_t batch = static_cast<std::size_t>(state.range(0));
+  std::vector<TPayload> buffer(batch);
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      ring->PushRange(buffer.begin(), buffer.end());
+    } else {
+      for (std::size_t popped = 0; popped != batch;) {
+        const std::size_t n =
+            ring->TryPopBulk(buffer.begin() + popped, batch - popped);
+        if (n == 0) std::this_thread::yield();
+        popped += n;
+      }
+      benchmark::DoNotOptimize(buffer.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * batch);
+  state.SetBytesProcessed(state.iterations() * batch * sizeof(TPayload));
+  if (state.thread_index() == 0) ring.reset();
+}
+
+/** Round trip through two rings: the timed thread pushes a ping and pops
+    the pong that a helper thread echoes back, so the time per iteration is
+    twice the one-way hand-off latency. range(0) turns on blocking waits. */
+template <typename TPayload>
+void BM_SpscRingBuffer_RoundTrip(benchmark::State& state) {
+  const bool blocking = state.range(0) != 0;
+  SpscRingBuffer<TPayload> ping(1024, blocking);
+  SpscRingBuffer<TPayload> pong(1024, blocking);
+  // Sequence 0 tells the echo thread to stop.
+  std::thread echo([&ping, &pong] {
+    TPayload item;
+    for (;;) {
+      ping.Pop(item);
+      if (item.words[0] == 0) break;
+      pong.Push(item);
+    }
+  });
+  std::uint64_t sequence = 0;
+  TPayload item;
+  for (auto _ : state) {
+    ping.Push(TPayload(++sequence));
+    pong.Pop(item);
+    benchmark::DoNotOptimize(item);
+  }
+  ping.Push(TPayload(0));
+  echo.join();
+  state.SetItemsProcessed(state.iterations());
+}
+
+/** Cost of a TryPopFor that times out on an empty queue, which bounds the
+    latency a polling consumer adds on top of the requested timeout. */
+void BM_BlockingQueue_TryPopForTimeout(benchmark::State& state) {
+  BlockingQueue<std::uint64_t> queue;
+  queue.EnableStatistics();
+  const std::chrono::microseconds timeout(state.range(0));
+  std::uint64_t item = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(queue.TryPopFor(item, timeout));
+  }
+  state.counters["pop_waits"] = static_cast<double>(
+      queue.GetStatistics()->pop_waits.Load());
+}
+
+/** Thread 0 pushes, thread 1 waits with TryPopFor; measures the hand-off
+    through a parked consumer. */
+void BM_BlockingQueue_TryPopForHandoff(benchmark::State& state) {
+  static std::unique_ptr<BlockingQueue<std::uint64_t>> queue;
+  if (state.thread_index() == 0) {
+    queue = std::make_unique<BlockingQueue<std::uint64_t>>();
+    queue->EnableStatistics();
+  }
+  std::uint64_t item = 0;
+  std::int64_t timeouts = 0;
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      queue->Push(++item);
+    } else {
+      while (!queue->TryPopFor(item, std::chrono::milliseconds(1))) {
+        ++timeouts;
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 1) {
+    state.counters["timeouts"] = static_cast<double>(timeouts);
+  }
+  if (state.thread_index() == 0) {
+    state.counters["pop_waits"] = static_cast<double>(
+        queue->GetStatistics()->pop_waits.Load());
+    queue.reset();
+  }
+}
+
+/** Reference point for ConcurrentPriorityQueue: a std::priority_queue
+    behind one std::mutex. */
+class MutexPriorityQueue {
+ public:
+  void Push(std::uint64_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push(value);
+  }
+
+  bool TryPop(std::uint64_t& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) return false;
+    result = queue_.top();
+    queue_.pop();
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::priority_queue<std::uint64_t> queue_;
+};
+
+/** Each iteration pushes a random priority and pops one item; the queue is
+    pre-filled so pops rarely see an empty queue. */
+template <typename TQueue>
+void BM_PriorityQueue_PushPop(benchmark::State& state) {
+  static std::unique_ptr<TQueue> queue;
+  if (state.thread_index() == 0) {
+    queue = std::make_unique<TQueue>();
+    FastRandom random(1);
+    for (int i = 0; i < 4096; ++i) {
+      queue->Push(random.Next());
+    }
+  }
+  FastRandom random(state.thread_index() + 2);
+  std::uint64_t item = 0;
+  for (auto _ : state) {
+    queue->Push(random.Next());
+    benchmark::DoNotOptimize(queue->TryPop(item));
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) queue.reset();
+}
+
+struct RegisterPayloadQueues {
+  template <typename TPayload>
+  static void Run(const BenchConfig& config) {
+    const std::string suffix = "<" + std::to_string(sizeof(TPayload)) + ">";
+    ApplyThreads(
+        benchmark::RegisterBenchmark(
+            ("BM_ConcurrentQueue_PushPop" + suffix).c_str(),
+            BM_ConcurrentQueue_PushPop<TPayload>),
+        config);
+    ApplyThreads(
+        benchmark::RegisterBenchmark(
+            ("BM_ConcurrentQueue_PushRangeTryPopBulk" + suffix).c_str(),
+            BM_ConcurrentQueue_PushRangeTryPopBulk<TPayload>)
+            ->Arg(16)
+            ->Arg(256),
+        config);
+    ApplyThreads(benchmark::RegisterBenchmark(
+                     ("BM_BlockingQueue_PushPop" + suffix).c_str(),
+                     BM_BlockingQueue_PushPop<TPayload>),
+                 config);
+    ApplyThreads(benchmark::RegisterBenchmark(
+                     ("BM_SynchronizedQueue_PushPop" + suffix).c_str(),
+                     BM_SynchronizedQueue_PushPop<TPayload>),
+                 config);
+    benchmark::RegisterBenchmark(
+        ("BM_SpscRingBuffer_PushPop" + suffix).c_str(),
+        BM_SpscRingBuffer_PushPop<TPayload>)
+        ->ArgName("blocking")
+        ->Arg(0)
+        ->Arg(1)
+        ->Threads(2)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark(
+        ("BM_SpscRingBuffer_RoundTrip" + suffix).c_str(),
+        BM_SpscRingBuffer_RoundTrip<TPayload>)
+        ->ArgName("blocking")
+        ->Arg(0)
+        ->Arg(1)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark(
+        ("BM_SpscRingBuffer_PushRangeTryPopBulk" + suffix).c_str(),
+        BM_SpscRingBuffer_PushRangeTryPopBulk<TPayload>)
+        ->Arg(16)
+        ->Arg(256)
+        ->Threads(2)
+        ->UseRealTime();
+  }
+};
+
+void RegisterQueueBenchmarks(const BenchConfig& config) {
+  for (std::int64_t size : config.payload_sizes) {
+    WithPayload<RegisterPayloadQueues>(size, config);
+  }
+  benchmark::RegisterBenchmark("BM_BlockingQueue_TryPopForTimeout",
+                               BM_BlockingQueue_TryPopForTimeout)
+      ->ArgName("timeout_us")
+      ->Arg(0)
+      ->Arg(10)
+      ->Arg(100)
+      ->UseRealTime();
+  benchmark::RegisterBenchmark("BM_BlockingQueue_TryPopForHandoff",
+                               BM_BlockingQueue_TryPopForHandoff)
+      ->Threads(2)
+      ->UseRealTime();
+  ApplyThreads(benchmark::RegisterBenchmark(
+                   "BM_PriorityQueue_PushPop<ConcurrentPriorityQueue>",
+                   BM_PriorityQueue_PushPop<
+                       ConcurrentPriorityQueue<std::uint64_t>>),
+               config);
+  ApplyThreads(benchmark::RegisterBenchmark(
+                   "BM_PriorityQueue_PushPop<MutexPriorityQueue>",
+                   BM_PriorityQueue_PushPop<MutexPriorityQueue>),
+               config);
+}
+
+[[maybe_unused]] const bool kRegistered =
+    AddRegistration(RegisterQueueBenchmarks);
+}  // namespace
+}  // namespace bench
+}  // namespace concurrency
+}  // namespace ws
@@ -1,9 +1,12 @@
 #pragma once
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <type_traits>
 
 #include "ws/concurrency/internal/concurrent_monitor.h"
 #include "ws/concurrency/internal/concurrent_queue_base.h"
+#include "ws/concurrency/sharded_counter.h"
 #include "ws/delegate.h"
 
 namespace ws {
@@ -17,6 +20,9 @@ class BlockingQueue {
       typename allocator_traits_type::template rebind_alloc<
           queue_representation_type>;
   using queue_allocator_traits = std::allocator_traits<queue_allocator_type>;
+  using wait_node_type =
+      ws::concurrency::internal::ConcurrentMonitor::thread_context;
+  using clock_type = std::chrono::steady_clock;
 
   void InternalWait(ws::concurrency::internal::ConcurrentMonitor* monitors,
                     std::size_t monitor_tag, std::ptrdiff_t target,
@@ -161,6 +167,79 @@ class BlockingQueue {
       Returns true if successful; false otherwise. */
   bool TryPop(T& result) { return InternalPopIfPresent(&result); }
 
+  /** Waits up to timeout for an item. Returns false if none arrived. */
+  template <typename TRep, typename TPeriod>
+  bool TryPopFor(T& result,
+                 const std::chrono::duration<TRep, TPeriod>& timeout) {
+    return TryPopUntil(result, clock_type::now() + timeout);
+  }
+
+  template <typename TClock, typename TDuration>
+  bool TryPopUntil(T& result,
+                   const std::chrono::time_point<TClock, TDuration>& deadline) {
+    wait_node_type node(std::uintptr_t(0));
+    return InternalTryUntil(
+        ws::concurrency::internal::kCbqItemsAvailTag, node,
+        ToSteadyDeadline(deadline), PopOperation(result), ItemsAvailable(),
+        [] { return false; }, &Statistics::pop_waits);
+  }
+
+  /** Blocks until an item is popped or token is cancelled, and returns
+      false in the latter case. Cancellation wakes only this waiter.
+      TCancellationToken is ws::threading::CancellationToken; it is a
+      template parameter so this module does not depend on the threading
+      module. */
+  template <typename TCancellationToken>
+  bool Pop(T& result, TCancellationToken token) {
+    return InternalTryUntilCancelled(
+        ws::concurrency::internal::kCbqItemsAvailTag, token,
+        PopOperation(result), ItemsAvailable(), &Statistics::pop_waits);
+  }
+
+  /** Waits up to timeout for a free slot. Returns false, leaving value
+      untouched, if the queue stayed full. */
+  template <typename TRep, typename TPeriod>
+  bool TryPushFor(const T& value,
+                  const std::chrono::duration<TRep, TPeriod>& timeout) {
+    return TryPushUntil(value, clock_type::now() + timeout);
+  }
+
+  template <typename TRep, typename TPeriod>
+  bool TryPushFor(T&& value,
+                  const std::chrono::duration<TRep, TPeriod>& timeout) {
+    return TryPushUntil(std::move(value), clock_type::now() + timeout);
+  }
+
+  template <typename TClock, typename TDuration>
+  bool TryPushUntil(
+      const T& value,
+      const std::chrono::time_point<TClock, TDuration>& deadline) {
+    return InternalTryPushUntil(ToSteadyDeadline(deadline), value);
+  }
+
+  template <typename TClock, typename TDuration>
+  bool TryPushUntil(
+      T&& value, const std::chrono::time_point<TClock, TDuration>& deadline) {
+    return InternalTryPushUntil(ToSteadyDeadline(deadline), std::move(value));
+  }
+
+  /** Blocks until value is pushed or token is cancelled, and returns false
+      in the latter case. See Pop(T&, TCancellationToken). */
+  template <typename TCancellationToken>
+  bool Push(const T& value, TCancellationToken token) {
+    return InternalTryUntilCancelled(
+        ws::concurrency::internal::kCbqSlotsAvailTag, token,
+        PushOperation(value), SlotsAvailable(), &Statistics::push_waits);
+  }
+
+  template <typename TCancellationToken>
+  bool Push(T&& value, TCancellationToken token) {
+    return InternalTryUntilCancelled(
+        ws::concurrency::internal::kCbqSlotsAvailTag, token,
+        PushOperation(std::move(value)), SlotsAvailable(),
+        &Statistics::push_waits);
+  }
+
   void Abort() { InternalAbort(); }
 
   std::ptrdiff_t Size() const { return queue_rep_ptr_->Size(); }
@@ -178,6 +257,22 @@ class BlockingQueue {
 
   allocator_type get_allocator() const { return allocator_; }
 
+  struct Statistics {
+    ShardedCounter pushes;
+    ShardedCounter pops;
+    ShardedCounter push_waits;
+    ShardedCounter pop_waits;
+  };
+
+  /** Starts counting pushes, pops and the operations that had to wait.
+      Must be called before the queue is shared between threads. */
+  void EnableStatistics() {
+    if (!statistics_) statistics_ = std::make_unique<Statistics>();
+  }
+
+  /** Returns nullptr unless statistics are enabled. */
+  const Statistics* GetStatistics() const { return statistics_.get(); }
+
  private:
   void InternalSwap(BlockingQueue& src) {
     std::swap(queue_rep_ptr_, src.queue_rep_ptr_);
@@ -186,7 +281,7 @@ class BlockingQueue {
   }
 
   static constexpr std::ptrdiff_t kInfiniteCapacity =
-      std::ptrdiff_t(~size_type(0) / 2);
+      std::ptrdiff_t(~std::size_t(0) / 2);
 
   template <typename... TArgs>
   void InternalPush(TArgs&&... args) {
@@ -197,6 +292,7 @@ class BlockingQueue {
 
     if (static_cast<std::ptrdiff_t>(queue_rep_ptr_->head_counter_.load(
             std::memory_order_relaxed)) <= target) {
+      if (statistics_) statistics_->push_waits.Increment();
       Delegate<bool()> pred = [&] {
         if (abort_counter_.load(std::memory_order_relaxed) !=
             old_abort_counter) {
@@ -221,6 +317,7 @@ class BlockingQueue {
                                         std::forward<TArgs>(args)...);
     ws::concurrency::internal::NotifyBoundedQueueMonitor(
         monitors_, ws::concurrency::internal::kCbqItemsAvailTag, ticket);
+    if (statistics_) statistics_->pushes.Increment();
   }
 
   template <typename... TArgs>
@@ -241,6 +338,7 @@ class BlockingQueue {
                                         std::forward<TArgs>(args)...);
     ws::concurrency::internal::NotifyBoundedQueueMonitor(
         monitors_, ws::concurrency::internal::kCbqItemsAvailTag, ticket);
+    if (statistics_) statistics_->pushes.Increment();
     return true;
   }
 
@@ -253,6 +351,7 @@ class BlockingQueue {
       target = queue_rep_ptr_->head_counter_++;
       if (static_cast<std::ptrdiff_t>(queue_rep_ptr_->tail_counter_.load(
               std::memory_order_relaxed)) <= target) {
+        if (statistics_) statistics_->pop_waits.Increment();
         auto pred = [&] {
           if (abort_counter_.load(std::memory_order_relaxed) !=
               old_abort_counter) {
@@ -275,6 +374,7 @@ class BlockingQueue {
 
     ws::concurrency::internal::NotifyBoundedQueueMonitor(
         monitors_, ws::concurrency::internal::kCbqSlotsAvailTag, target);
+    if (statistics_) statistics_->pops.Increment();
   }
 
   bool InternalPopIfPresent(void* dst) {
@@ -286,10 +386,121 @@ class BlockingQueue {
     if (present) {
       ws::concurrency::internal::NotifyBoundedQueueMonitor(
           monitors_, ws::concurrency::internal::kCbqSlotsAvailTag, ticket);
+      if (statistics_) statistics_->pops.Increment();
     }
     return present;
   }
 
+  auto PopOperation(T& result) {
+    return [this, &result] { return InternalPopIfPresent(&result); };
+  }
+
+  template <typename TValue>
+  auto PushOperation(TValue&& value) {
+    return [this, &value] {
+      return InternalPushIfNotFull(std::forward<TValue>(value));
+    };
+  }
+
+  auto ItemsAvailable() const {
+    return [this] { return queue_rep_ptr_->Size() > 0; };
+  }
+
+  auto SlotsAvailable() const {
+    return [this] { return queue_rep_ptr_->Size() < capacity_; };
+  }
+
+  template <typename TValue>
+  bool InternalTryPushUntil(clock_type::time_point deadline,
+                            TValue&& value) {
+    wait_node_type node(std::uintptr_t(0));
+    return InternalTryUntil(
+        ws::concurrency::internal::kCbqSlotsAvailTag, node, deadline,
+        PushOperation(std::forward<TValue>(value)), SlotsAvailable(),
+        [] { return false; }, &Statistics::push_waits);
+  }
+
+  /** Retries try_operation until it succeeds, stop returns true or
+      deadline passes, parking node on the monitor in between. Unlike Push
+      and Pop no ticket is claimed up front, so giving up leaves the queue
+      untouched. The node waits with context 0, so every push or pop
+      wakes it to retry. */
+  template <typename TTryOperation, typename TReady, typename TStop>
+  bool InternalTryUntil(std::size_t monitor_tag, wait_node_type& node,
+                        clock_type::time_point deadline,
+                        TTryOperation try_operation, TReady ready, TStop stop,
+                        ShardedCounter Statistics::*wait_counter) {
+    const unsigned old_abort_counter =
+        abort_counter_.load(std::memory_order_relaxed);
+    ws::concurrency::internal::ConcurrentMonitor& monitor =
+        monitors_[monitor_tag];
+    auto pred = [&] {
+      if (abort_counter_.load(std::memory_order_relaxed) !=
+          old_abort_counter) {
+        throw std::runtime_error("user_abort");
+      }
+
+      return ready() || stop();
+    };
+
+    bool waited = false;
+    while (!try_operation()) {
+      if (stop() || clock_type::now() >= deadline) return false;
+      if (!waited) {
+        waited = true;
+        if (statistics_) (statistics_.get()->*wait_counter).Increment();
+      }
+
+      if (deadline == clock_type::time_point::max()) {
+        monitor.Wait(pred, node);
+      } else if (!monitor.WaitUntil(pred, node, deadline)) {
+        return try_operation();
+      }
+    }
+    return true;
+  }
+
+  template <typename TCancellationToken, typename TTryOperation,
+            typename TReady>
+  bool InternalTryUntilCancelled(std::size_t monitor_tag,
+                                 TCancellationToken& token,
+                                 TTryOperation try_operation, TReady ready,
+                                 ShardedCounter Statistics::*wait_counter) {
+    if (try_operation()) return true;
+    if (token.IsCancellationRequested()) return false;
+
+    wait_node_type node(std::uintptr_t(0));
+    ws::concurrency::internal::ConcurrentMonitor& monitor =
+        monitors_[monitor_tag];
+    auto registration = token.RegisterCallback(
+        [&monitor, &node] { monitor.NotifyNode(node); });
+
+    bool done = false;
+    ws::concurrency::internal::templates::TryCall([&] {
+      done = InternalTryUntil(
+          monitor_tag, node, clock_type::time_point::max(), try_operation,
+          ready, [&token] { return token.IsCancellationRequested(); },
+          wait_counter);
+    }).OnCompletion([&] {
+      // Unregister waits for a callback that is already running, so node
+      // outlives every NotifyNode call.
+      if (registration.Ok()) registration.Value().Unregister();
+    });
+    return done;
+  }
+
+  template <typename TClock, typename TDuration>
+  static clock_type::time_point ToSteadyDeadline(
+      const std::chrono::time_point<TClock, TDuration>& deadline) {
+    if constexpr (std::is_same<TClock, clock_type>::value) {
+      return std::chrono::time_point_cast<clock_type::duration>(deadline);
+    } else {
+      return clock_type::now() +
+             std::chrono::duration_cast<clock_type::duration>(deadline -
+                                                              TClock::now());
+    }
+  }
+
   void InternalAbort() {
     ++abort_counter_;
     ws::concurrency::internal::AbortBoundedQueueMonitors(monitors_);
@@ -310,6 +521,7 @@ class BlockingQueue {
   queue_representation_type* queue_rep_ptr_;
 
   ws::concurrency::internal::ConcurrentMonitor* monitors_;
+  std::unique_ptr<Statistics> statistics_;
 
   friend void Swap(BlockingQueue& lhs, BlockingQueue& rhs) { lhs.swap(rhs); }
 
@@ -401,6 +613,45 @@ class blocking_queue {
 
   void pop(value_type& __x) { internal_instance_.Pop(__x); }
 
+  template <typename TRep, typename TPeriod>
+  bool try_pop_for(value_type& __x,
+                   const std::chrono::duration<TRep, TPeriod>& __timeout) {
+    return internal_instance_.TryPopFor(__x, __timeout);
+  }
+
+  template <typename TClock, typename TDuration>
+  bool try_pop_until(
+      value_type& __x,
+      const std::chrono::time_point<TClock, TDuration>& __deadline) {
+    return internal_instance_.TryPopUntil(__x, __deadline);
+  }
+
+  template <typename TCancellationToken>
+  bool pop(value_type& __x, TCancellationToken __token) {
+    return internal_instance_.Pop(__x, std::move(__token));
+  }
+
+  template <typename TValue, typename TRep, typename TPeriod>
+  bool try_push_for(TValue&& __x,
+                    const std::chrono::duration<TRep, TPeriod>& __timeout) {
+    return internal_instance_.TryPushFor(std::forward<TValue>(__x),
+                                         __timeout);
+  }
+
+  template <typename TValue, typename TClock, typename TDuration>
+  bool try_push_until(
+      TValue&& __x,
+      const std::chrono::time_point<TClock, TDuration>& __deadline) {
+    return internal_instance_.TryPushUntil(std::forward<TValue>(__x),
+                                           __deadline);
+  }
+
+  template <typename TValue, typename TCancellationToken>
+  bool push(TValue&& __x, TCancellationToken __token) {
+    return internal_instance_.Push(std::forward<TValue>(__x),
+                                   std::move(__token));
+  }
+
   void pop() {
     value_type & __x;
     internal_instance_.pop(__x);
@@ -0,0 +1,842 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ws/concurrency/internal/atomic_backoff.h"
+#include "ws/concurrency/internal/hash_compare.h"
+#include "ws/concurrency/internal/helpers.h"
+
+namespace ws {
+namespace concurrency {
+/** Open-addressing (linear probing) concurrent hash map for read-mostly
+    workloads. Each slot holds a state word (empty, moved, tombstone or the
+    key's hash tag) next to a pointer to an individually allocated node, so a
+    lookup scans contiguous slots and only dereferences nodes whose tag
+    matches. Elements never move, so references and iterators stay valid
+    across concurrent insertion and resizing.
+
+    Find, Insert and Emplace are thread-safe; Find never waits. When the
+    table passes its load factor, writers migrate it chunk by chunk into a
+    table twice as large and readers follow the moved slots into it.
+    Retired tables are kept until Clear() or destruction. Methods prefixed
+    with Unsafe, Clear and Swap must not run concurrently with other
+    operations. */
+template <typename TKey, typename T, typename THash = std::hash<TKey>,
+          typename TKeyEqual = std::equal_to<TKey>,
+          typename TAllocator = std::allocator<std::pair<const TKey, T>>>
+class ConcurrentFlatMap {
+  using hash_compare_type =
+      ws::concurrency::internal::HashCompare<TKey, THash, TKeyEqual>;
+  using allocator_traits_type = std::allocator_traits<TAllocator>;
+
+  struct Node {
+    template <typename... TArgs>
+    explicit Node(TArgs&&... args) : value(std::forward<TArgs>(args)...) {}
+
+    std::pair<const TKey, T> value;
+    std::size_t hash = 0;
+  };
+
+  using node_allocator_type =
+      typename allocator_traits_type::template rebind_alloc<Node>;
+  using node_allocator_traits = std::allocator_traits<node_allocator_type>;
+
+  static constexpr std::size_t kEmpty = 0;
+  static constexpr std::size_t kMoved = 1;
+  static constexpr std::size_t kTombstone = 2;
+  static constexpr std::size_t kFirstTag = 3;
+
+  static constexpr std::size_t kMinCapacity = 16;
+  static constexpr std::size_t kMigrationChunk = 256;
+
+  struct Slot {
+    std::atomic<std::size_t> state{kEmpty};
+    std::atomic<Node*> node{nullptr};
+  };
+
+  struct Table {
+    explicit Table(std::size_t cap, Table* prev)
+        : capacity(cap),
+          mask(cap - 1),
+          slots(std::make_unique<Slot[]>(cap)),
+          previous(prev) {}
+
+    bool OverLoaded() const {
+      return used.load(std::memory_order_relaxed) >= capacity - capacity / 4;
+    }
+
+    const std::size_t capacity;
+    const std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    Table* const previous;
+    std::atomic<std::size_t> used{0};
+    std::atomic<Table*> next{nullptr};
+    std::atomic<std::size_t> migration_cursor{0};
+    std::atomic<std::size_t> migrated{0};
+  };
+
+  template <typename TK>
+  using is_transparent = ws::concurrency::internal::containers::DependentBool<
+      ws::concurrency::internal::containers::HasTransparentKeyEqual<
+          TKey, THash, TKeyEqual>,
+      TK>;
+
+  template <bool IsConst>
+  class FlatMapIterator {
+    friend class ConcurrentFlatMap;
+    template <bool>
+    friend class FlatMapIterator;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<const TKey, T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer =
+        std::conditional_t<IsConst, const value_type*, value_type*>;
+    using reference =
+        std::conditional_t<IsConst, const value_type&, value_type&>;
+
+    FlatMapIterator() = default;
+
+    template <bool C = IsConst, typename = std::enable_if_t<C>>
+    FlatMapIterator(const FlatMapIterator<false>& other)
+        : table_(other.table_), index_(other.index_), node_(other.node_) {}
+
+    reference operator*() const { return node_->value; }
+
+    pointer operator->() const { return &node_->value; }
+
+    FlatMapIterator& operator++() {
+      Advance(index_ + 1);
+      return *this;
+    }
+
+    FlatMapIterator operator++(int) {
+      FlatMapIterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const FlatMapIterator& lhs,
+                           const FlatMapIterator& rhs) {
+      return lhs.node_ == rhs.node_;
+    }
+
+    friend bool operator!=(const FlatMapIterator& lhs,
+                           const FlatMapIterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    FlatMapIterator(Table* table, std::size_t index, Node* node)
+        : table_(table), index_(index), node_(node) {}
+
+    void Advance(std::size_t index) {
+      for (; index < table_->capacity; ++index) {
+        const std::size_t state =
+            table_->slots[index].state.load(std::memory_order_acquire);
+        if (state < kFirstTag) continue;
+
+        Node* node = table_->slots[index].node.load(std::memory_order_acquire);
+        if (node) {
+          index_ = index;
+          node_ = node;
+          return;
+        }
+      }
+
+      table_ = nullptr;
+      index_ = 0;
+      node_ = nullptr;
+    }
+
+    Table* table_ = nullptr;
+    std::size_t index_ = 0;
+    Node* node_ = nullptr;
+  };
+
+ public:
+  using key_type = TKey;
+  using mapped_type = T;
+  using value_type = std::pair<const TKey, T>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = typename hash_compare_type::hasher;
+  using key_equal = typename hash_compare_type::key_equal;
+  using allocator_type = TAllocator;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = typename allocator_traits_type::pointer;
+  using const_pointer = typename allocator_traits_type::const_pointer;
+  using iterator = FlatMapIterator<false>;
+  using const_iterator = FlatMapIterator<true>;
+
+  ConcurrentFlatMap() : ConcurrentFlatMap(0) {}
+
+  explicit ConcurrentFlatMap(size_type n, const hasher& hash = hasher(),
+                             const key_equal& equal = key_equal(),
+                             const allocator_type& a = allocator_type())
+      : node_allocator_(a),
+        hash_compare_(hash, equal),
+        table_(new Table(CapacityFor(n), nullptr)) {}
+
+  explicit ConcurrentFlatMap(const allocator_type& a)
+      : ConcurrentFlatMap(0, hasher(), key_equal(), a) {}
+
+  template <typename TInputIterator>
+  ConcurrentFlatMap(TInputIterator first, TInputIterator last,
+                    size_type n = 0, const hasher& hash = hasher(),
+                    const key_equal& equal = key_equal(),
+                    const allocator_type& a = allocator_type())
+      : ConcurrentFlatMap(n, hash, equal, a) {
+    Insert(first, last);
+  }
+
+  ConcurrentFlatMap(std::initializer_list<value_type> il, size_type n = 0,
+                    const hasher& hash = hasher(),
+                    const key_equal& equal = key_equal(),
+                    const allocator_type& a = allocator_type())
+      : ConcurrentFlatMap(il.begin(), il.end(), n, hash, equal, a) {}
+
+  ConcurrentFlatMap(const ConcurrentFlatMap& other)
+      : ConcurrentFlatMap(other,
+                          node_allocator_traits::
+                              select_on_container_copy_construction(
+                                  other.node_allocator_)) {}
+
+  ConcurrentFlatMap(const ConcurrentFlatMap& other, const allocator_type& a)
+      : ConcurrentFlatMap(other.Size(), other.HashFunction(), other.KeyEq(),
+                          a) {
+    Insert(other.begin(), other.end());
+  }
+
+  ConcurrentFlatMap(ConcurrentFlatMap&& other)
+      : ConcurrentFlatMap(0, other.HashFunction(), other.KeyEq(),
+                          allocator_type(other.node_allocator_)) {
+    InternalSwap(other);
+  }
+
+  ConcurrentFlatMap& operator=(const ConcurrentFlatMap& other) {
+    if (this != &other) {
+      ConcurrentFlatMap copy(other);
+      InternalSwap(copy);
+    }
+    return *this;
+  }
+
+  ConcurrentFlatMap& operator=(ConcurrentFlatMap&& other) {
+    if (this != &other) {
+      Clear();
+      InternalSwap(other);
+    }
+    return *this;
+  }
+
+  ConcurrentFlatMap& operator=(std::initializer_list<value_type> il) {
+    Clear();
+    Insert(il);
+    return *this;
+  }
+
+  ~ConcurrentFlatMap() {
+    DestroyNodes();
+    DestroyTables(table_.load(std::memory_order_relaxed));
+  }
+
+  allocator_type get_allocator() const {
+    return allocator_type(node_allocator_);
+  }
+
+  [[nodiscard]] bool Empty() const { return Size() == 0; }
+
+  size_type Size() const { return size_.load(std::memory_order_acquire); }
+
+  size_type Capacity() const {
+    return table_.load(std::memory_order_acquire)->capacity;
+  }
+
+  iterator begin() { return MakeBegin<iterator>(); }
+
+  const_iterator begin() const { return MakeBegin<const_iterator>(); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() { return iterator(); }
+
+  const_iterator end() const { return const_iterator(); }
+
+  const_iterator cend() const { return end(); }
+
+  std::pair<iterator, bool> Insert(const value_type& value) {
+    return Emplace(value);
+  }
+
+  std::pair<iterator, bool> Insert(value_type&& value) {
+    return Emplace(std::move(value));
+  }
+
+  template <typename TP>
+  typename std::enable_if<std::is_constructible<value_type, TP&&>::value,
+                          std::pair<iterator, bool>>::type
+  Insert(TP&& value) {
+    return Emplace(std::forward<TP>(value));
+  }
+
+  template <typename TInputIterator>
+  void Insert(TInputIterator first, TInputIterator last) {
+    for (; first != last; ++first) {
+      Emplace(*first);
+    }
+  }
+
+  void Insert(std::initializer_list<value_type> il) {
+    Insert(il.begin(), il.end());
+  }
+
+  template <typename... TArgs>
+  std::pair<iterator, bool> Emplace(TArgs&&... args) {
+    Node* node = CreateNode(std::forward<TArgs>(args)...);
+    auto [position, inserted] = InternalInsert(node);
+    if (!inserted) DestroyNode(node);
+    return {position, inserted};
+  }
+
+  mapped_type& operator[](const key_type& key) {
+    iterator where = Find(key);
+    if (where == end()) {
+      where = Emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                      std::tuple<>())
+                  .first;
+    }
+    return where->second;
+  }
+
+  mapped_type& operator[](key_type&& key) {
+    iterator where = Find(key);
+    if (where == end()) {
+      where = Emplace(std::piecewise_construct,
+                      std::forward_as_tuple(std::move(key)), std::tuple<>())
+                  .first;
+    }
+    return where->second;
+  }
+
+  mapped_type& At(const key_type& key) {
+    iterator where = Find(key);
+    if (where == end()) throw std::out_of_range("ConcurrentFlatMap::at");
+    return where->second;
+  }
+
+  const mapped_type& At(const key_type& key) const {
+    const_iterator where = Find(key);
+    if (where == end()) throw std::out_of_range("ConcurrentFlatMap::at");
+    return where->second;
+  }
+
+  iterator Find(const key_type& key) { return InternalFind<iterator>(key); }
+
+  const_iterator Find(const key_type& key) const {
+    return InternalFind<const_iterator>(key);
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, iterator>::type Find(
+      const TK& key) {
+    return InternalFind<iterator>(key);
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, const_iterator>::type Find(
+      const TK& key) const {
+    return InternalFind<const_iterator>(key);
+  }
+
+  size_type Count(const key_type& key) const { return Contains(key) ? 1 : 0; }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, size_type>::type Count(
+      const TK& key) const {
+    return Contains(key) ? 1 : 0;
+  }
+
+  bool Contains(const key_type& key) const { return Find(key) != end(); }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, bool>::type Contains(
+      const TK& key) const {
+    return Find(key) != end();
+  }
+
+  size_type UnsafeErase(const key_type& key) { return InternalErase(key); }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value &&
+                              !std::is_convertible<TK, const_iterator>::value &&
+                              !std::is_convertible<TK, iterator>::value,
+                          size_type>::type
+  UnsafeErase(const TK& key) {
+    return InternalErase(key);
+  }
+
+  void Clear() {
+    DestroyNodes();
+    Table* fresh = new Table(kMinCapacity, nullptr);
+    DestroyTables(table_.exchange(fresh, std::memory_order_acq_rel));
+    size_.store(0, std::memory_order_release);
+  }
+
+  void Swap(ConcurrentFlatMap& other) {
+    if (this != &other) InternalSwap(other);
+  }
+
+  hasher HashFunction() const { return hash_compare_.HashFunction(); }
+
+  key_equal KeyEq() const { return hash_compare_.KeyEq(); }
+
+ private:
+  static size_type CapacityFor(size_type n) {
+    size_type capacity = kMinCapacity;
+    while (capacity - capacity / 4 <= n) {
+      capacity <<= 1;
+    }
+    return capacity;
+  }
+
+  static std::size_t Mix(std::size_t h) {
+    std::uint64_t x = h;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return static_cast<std::size_t>(x);
+  }
+
+  static std::size_t Tag(std::size_t hash) {
+    return hash < kFirstTag ? hash + kFirstTag : hash;
+  }
+
+  static Node* WaitForNode(Slot& slot) {
+    Node* node = slot.node.load(std::memory_order_acquire);
+    for (ws::concurrency::internal::AtomicBackoff backoff; !node;
+         backoff.Wait()) {
+      node = slot.node.load(std::memory_order_acquire);
+    }
+    return node;
+  }
+
+  template <typename... TArgs>
+  Node* CreateNode(TArgs&&... args) {
+    Node* node = node_allocator_traits::allocate(node_allocator_, 1);
+    ws::concurrency::internal::templates::TryCall([&] {
+      node_allocator_traits::construct(node_allocator_, node,
+                                       std::forward<TArgs>(args)...);
+    }).OnException([&] {
+      node_allocator_traits::deallocate(node_allocator_, node, 1);
+    });
+    node->hash = Mix(hash_compare_(node->value.first));
+    return node;
+  }
+
+  void DestroyNode(Node* node) {
+    node_allocator_traits::destroy(node_allocator_, node);
+    node_allocator_traits::deallocate(node_allocator_, node, 1);
+  }
+
+  template <typename TIterator>
+  TIterator MakeBegin() const {
+    TIterator it(table_.load(std::memory_order_acquire), 0, nullptr);
+    it.Advance(0);
+    return it;
+  }
+
+  template <typename TIterator, typename TK>
+  TIterator InternalFind(const TK& key) const {
+    const std::size_t hash = Mix(hash_compare_(key));
+    const std::size_t tag = Tag(hash);
+    for (Table* t = table_.load(std::memory_order_acquire); t;
+         t = t->next.load(std::memory_order_acquire)) {
+      std::size_t index = hash & t->mask;
+      for (std::size_t probes = 0; probes < t->capacity;
+           ++probes, index = (index + 1) & t->mask) {
+        Slot& slot = t->slots[index];
+        const std::size_t state = slot.state.load(std::memory_order_acquire);
+        if (state == kEmpty) return TIterator();
+        if (state == kMoved) break;
+        if (state != tag) continue;
+
+        // A claimed slot whose node is not yet published is an insertion
+        // that has not completed, so readers skip it instead of waiting.
+        Node* node = slot.node.load(std::memory_order_acquire);
+        if (node && hash_compare_(node->value.first, key)) {
+          return TIterator(t, index, node);
+        }
+      }
+    }
+    return TIterator();
+  }
+
+  std::pair<iterator, bool> InternalInsert(Node* node) {
+    for (;;) {
+      Table* t = table_.load(std::memory_order_acquire);
+      if (!t->next.load(std::memory_order_acquire)) {
+        if (auto result = TryInsertInto(t, node)) return *result;
+        StartResize(t);
+      }
+      HelpMigrate(t);
+    }
+  }
+
+  /** Returns nothing when the table is migrating or over its load factor;
+      the caller then helps the migration and retries. */
+  std::optional<std::pair<iterator, bool>> TryInsertInto(Table* t,
+                                                         Node* node) {
+    const std::size_t tag = Tag(node->hash);
+    std::size_t index = node->hash & t->mask;
+    for (std::size_t probes = 0; probes < t->capacity;
+         ++probes, index = (index + 1) & t->mask) {
+      Slot& slot = t->slots[index];
+      std::size_t state = slot.state.load(std::memory_order_acquire);
+      while (state == kEmpty) {
+        if (t->OverLoaded()) return std::nullopt;
+        if (slot.state.compare_exchange_strong(state, tag,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+          slot.node.store(node, std::memory_order_release);
+          t->used.fetch_add(1, std::memory_order_relaxed);
+          size_.fetch_add(1, std::memory_order_release);
+          return std::pair<iterator, bool>(iterator(t, index, node), true);
+        }
+      }
+
+      if (state == kMoved) return std::nullopt;
+      if (state != tag) continue;
+
+      Node* existing = WaitForNode(slot);
+      if (hash_compare_(existing->value.first, node->value.first)) {
+        return std::pair<iterator, bool>(iterator(t, index, existing), false);
+      }
+    }
+    return std::nullopt;
+  }
+
+  void StartResize(Table* t) {
+    if (t->next.load(std::memory_order_acquire)) return;
+
+    Table* bigger = new Table(t->capacity * 2, t);
+    Table* expected = nullptr;
+    if (!t->next.compare_exchange_strong(expected, bigger,
+                                         std::memory_order_acq_rel)) {
+      delete bigger;
+    }
+  }
+
+  /** Migrates chunks of t until none are left, then waits for the other
+      helpers so the caller always continues on the new table. */
+  void HelpMigrate(Table* t) {
+    Table* next = t->next.load(std::memory_order_acquire);
+    const std::size_t num_chunks =
+        (t->capacity + kMigrationChunk - 1) / kMigrationChunk;
+
+    std::size_t chunk;
+    while ((chunk = t->migration_cursor.fetch_add(
+                1, std::memory_order_relaxed)) < num_chunks) {
+      const std::size_t first = chunk * kMigrationChunk;
+      const std::size_t last = std::min(first + kMigrationChunk, t->capacity);
+      for (std::size_t index = first; index < last; ++index) {
+        MigrateSlot(t->slots[index], next);
+      }
+
+      if (t->migrated.fetch_add(last - first, std::memory_order_acq_rel) +
+              (last - first) ==
+          t->capacity) {
+        Table* expected = t;
+        table_.compare_exchange_strong(expected, next,
+                                       std::memory_order_acq_rel);
+      }
+    }
+
+    for (ws::concurrency::internal::AtomicBackoff backoff;
+         table_.load(std::memory_order_acquire) == t; backoff.Wait()) {
+    }
+  }
+
+  void MigrateSlot(Slot& slot, Table* next) {
+    std::size_t state = slot.state.load(std::memory_order_acquire);
+    while (state == kEmpty) {
+      if (slot.state.compare_exchange_strong(state, kMoved,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+        return;
+      }
+    }
+    if (state < kFirstTag) return;
+
+    Node* node = WaitForNode(slot);
+    std::size_t index = node->hash & next->mask;
+    for (;; index = (index + 1) & next->mask) {
+      Slot& target = next->slots[index];
+      std::size_t expected = kEmpty;
+      if (target.state.compare_exchange_strong(expected, Tag(node->hash),
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_relaxed)) {
+        target.node.store(node, std::memory_order_release);
+        next->used.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+    }
+  }
+
+  template <typename TK>
+  size_type InternalErase(const TK& key) {
+    iterator where = InternalFind<iterator>(key);
+    if (where == end()) return 0;
+
+    Slot& slot = where.table_->slots[where.index_];
+    slot.node.store(nullptr, std::memory_order_relaxed);
+    slot.state.store(kTombstone, std::memory_order_release);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    DestroyNode(where.node_);
+    return 1;
+  }
+
+  void DestroyNodes() {
+    Table* t = table_.load(std::memory_order_relaxed);
+    for (std::size_t index = 0; index < t->capacity; ++index) {
+      Slot& slot = t->slots[index];
+      if (slot.state.load(std::memory_order_relaxed) < kFirstTag) continue;
+      if (Node* node = slot.node.load(std::memory_order_relaxed)) {
+        DestroyNode(node);
+      }
+    }
+  }
+
+  static void DestroyTables(Table* t) {
+    while (t) {
+      Table* previous = t->previous;
+      delete t;
+      t = previous;
+    }
+  }
+
+  void InternalSwap(ConcurrentFlatMap& other) {
+    using std::swap;
+    if (node_allocator_traits::propagate_on_container_swap::value) {
+      swap(node_allocator_, other.node_allocator_);
+    }
+    swap(hash_compare_, other.hash_compare_);
+
+    Table* table = table_.load(std::memory_order_relaxed);
+    table_.store(other.table_.load(std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+    other.table_.store(table, std::memory_order_relaxed);
+
+    size_type size = size_.load(std::memory_order_relaxed);
+    size_.store(other.size_.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    other.size_.store(size, std::memory_order_relaxed);
+  }
+
+  node_allocator_type node_allocator_;
+  hash_compare_type hash_compare_;
+  alignas(ws::internal::CacheLineSize()) std::atomic<Table*> table_;
+  alignas(ws::internal::CacheLineSize()) std::atomic<size_type> size_{0};
+};
+
+template <typename TKey, typename T, typename THash, typename TKeyEqual,
+          typename TAllocator>
+void Swap(ConcurrentFlatMap<TKey, T, THash, TKeyEqual, TAllocator>& lhs,
+          ConcurrentFlatMap<TKey, T, THash, TKeyEqual, TAllocator>& rhs) {
+  lhs.Swap(rhs);
+}
+}  // namespace concurrency
+}  // namespace ws
+
+namespace ws {
+template <typename TKey, typename T, typename THash = std::hash<TKey>,
+          typename TKeyEqual = std::equal_to<TKey>,
+          typename TAllocator = std::allocator<std::pair<const TKey, T>>>
+class concurrent_flat_map {
+ public:
+  using hashtable_type =
+      ws::concurrency::ConcurrentFlatMap<TKey, T, THash, TKeyEqual,
+                                         TAllocator>;
+  using key_type = typename hashtable_type::key_type;
+  using mapped_type = typename hashtable_type::mapped_type;
+  using value_type = typename hashtable_type::value_type;
+  using size_type = typename hashtable_type::size_type;
+  using difference_type = typename hashtable_type::difference_type;
+  using hasher = typename hashtable_type::hasher;
+  using key_equal = typename hashtable_type::key_equal;
+  using allocator_type = typename hashtable_type::allocator_type;
+  using reference = typename hashtable_type::reference;
+  using const_reference = typename hashtable_type::const_reference;
+  using pointer = typename hashtable_type::pointer;
+  using const_pointer = typename hashtable_type::const_pointer;
+  using iterator = typename hashtable_type::iterator;
+  using const_iterator = typename hashtable_type::const_iterator;
+
+ private:
+  hashtable_type internal_instance_;
+
+ public:
+  concurrent_flat_map() = default;
+
+  concurrent_flat_map(const concurrent_flat_map& other)
+      : internal_instance_(other.internal_instance_) {}
+
+  concurrent_flat_map(concurrent_flat_map&& other) noexcept
+      : internal_instance_(std::move(other.internal_instance_)) {}
+
+  explicit concurrent_flat_map(const allocator_type& alloc)
+      : internal_instance_(alloc) {}
+
+  explicit concurrent_flat_map(size_type n, const hasher& hf = hasher(),
+                               const key_equal& eql = key_equal(),
+                               const allocator_type& a = allocator_type())
+      : internal_instance_(n, hf, eql, a) {}
+
+  concurrent_flat_map(std::initializer_list<value_type> il, size_type n = 0,
+                      const hasher& hf = hasher(),
+                      const key_equal& eql = key_equal(),
+                      const allocator_type& a = allocator_type())
+      : internal_instance_(il, n, hf, eql, a) {}
+
+  template <typename InputIt>
+  concurrent_flat_map(InputIt first, InputIt last, size_type n = 0,
+                      const hasher& hf = hasher(),
+                      const key_equal& eql = key_equal(),
+                      const allocator_type& a = allocator_type())
+      : internal_instance_(first, last, n, hf, eql, a) {}
+
+  concurrent_flat_map& operator=(const concurrent_flat_map& other) {
+    internal_instance_ = other.internal_instance_;
+    return *this;
+  }
+
+  concurrent_flat_map& operator=(concurrent_flat_map&& other) noexcept {
+    internal_instance_ = std::move(other.internal_instance_);
+    return *this;
+  }
+
+  concurrent_flat_map& operator=(std::initializer_list<value_type> il) {
+    internal_instance_ = il;
+    return *this;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return internal_instance_.get_allocator();
+  }
+
+  bool empty() const noexcept { return internal_instance_.Empty(); }
+
+  size_type size() const noexcept { return internal_instance_.Size(); }
+
+  iterator begin() noexcept { return internal_instance_.begin(); }
+
+  const_iterator begin() const noexcept { return internal_instance_.begin(); }
+
+  const_iterator cbegin() const noexcept { return internal_instance_.cbegin(); }
+
+  iterator end() noexcept { return internal_instance_.end(); }
+
+  const_iterator end() const noexcept { return internal_instance_.end(); }
+
+  const_iterator cend() const noexcept { return internal_instance_.cend(); }
+
+  template <typename... TArgs>
+  std::pair<iterator, bool> emplace(TArgs&&... __args) {
+    return internal_instance_.Emplace(std::forward<TArgs>(__args)...);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& __x) {
+    return internal_instance_.Insert(__x);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& __x) {
+    return internal_instance_.Insert(std::move(__x));
+  }
+
+  template <typename TPair>
+  typename std::enable_if<std::is_constructible<value_type, TPair&&>::value,
+                          std::pair<iterator, bool>>::type
+  insert(TPair&& __x) {
+    return internal_instance_.Insert(std::forward<TPair>(__x));
+  }
+
+  template <typename TInputIterator>
+  void insert(TInputIterator __first, TInputIterator __last) {
+    internal_instance_.Insert(__first, __last);
+  }
+
+  void insert(std::initializer_list<value_type> __l) {
+    internal_instance_.Insert(__l);
+  }
+
+  size_type erase(const key_type& __x) {
+    return internal_instance_.UnsafeErase(__x);
+  }
+
+  void clear() noexcept { internal_instance_.Clear(); }
+
+  void swap(concurrent_flat_map& __x) {
+    internal_instance_.Swap(__x.internal_instance_);
+  }
+
+  hasher hash_function() const { return internal_instance_.HashFunction(); }
+
+  key_equal key_eq() const { return internal_instance_.KeyEq(); }
+
+  iterator find(const key_type& __x) { return internal_instance_.Find(__x); }
+
+  template <typename _Kt>
+  auto find(const _Kt& __x) -> decltype(internal_instance_.Find(__x)) {
+    return internal_instance_.Find(__x);
+  }
+
+  const_iterator find(const key_type& __x) const {
+    return internal_instance_.Find(__x);
+  }
+
+  template <typename _Kt>
+  auto find(const _Kt& __x) const -> decltype(internal_instance_.Find(__x)) {
+    return internal_instance_.Find(__x);
+  }
+
+  size_type count(const key_type& __x) const {
+    return internal_instance_.Count(__x);
+  }
+
+  bool contains(const key_type& __x) const {
+    return internal_instance_.Contains(__x);
+  }
+
+  mapped_type& operator[](const key_type& __k) {
+    return internal_instance_[__k];
+  }
+
+  mapped_type& operator[](key_type&& __k) {
+    return internal_instance_[std::move(__k)];
+  }
+
+  mapped_type& at(const key_type& __k) { return internal_instance_.At(__k); }
+
+  const mapped_type& at(const key_type& __k) const {
+    return internal_instance_.At(__k);
+  }
+
+  size_type capacity() const { return internal_instance_.Capacity(); }
+};
+}  // namespace ws
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ws/concurrency/internal/atomic_backoff.h"
+#include "ws/concurrency/internal/helpers.h"
+#include "ws/concurrency/sharded_counter.h"
+#include "ws/concurrency/spin_mutex.h"
+#include "ws/machine.h"
+
+namespace ws {
+namespace concurrency {
+/** Relaxed concurrent priority queue (a MultiQueue). Items live in several
+    binary heaps, each behind its own SpinMutex. Push adds to a random heap
+    it can lock without waiting. TryPop locks two random heaps and pops the
+    larger top, so concurrent threads rarely contend. As with
+    std::priority_queue, TCompare orders items and the largest comes out
+    first.
+
+    The order is relaxed: an item is not always popped before every smaller
+    one, but high-priority items reliably overtake bulk work after a few
+    pops. TryPop only returns false after finding every heap empty. */
+template <typename T, typename TCompare = std::less<T>,
+          typename TAllocator = std::allocator<T>>
+class ConcurrentPriorityQueue {
+  using heap_type = std::vector<T, TAllocator>;
+  using allocator_traits_type = std::allocator_traits<TAllocator>;
+
+ public:
+  using size_type = std::size_t;
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using difference_type = std::ptrdiff_t;
+  using value_compare = TCompare;
+
+  using allocator_type = TAllocator;
+  using pointer = typename allocator_traits_type::pointer;
+  using const_pointer = typename allocator_traits_type::const_pointer;
+
+  ConcurrentPriorityQueue() : ConcurrentPriorityQueue(TCompare()) {}
+
+  explicit ConcurrentPriorityQueue(const TCompare& compare,
+                                   const allocator_type& a = allocator_type())
+      : ConcurrentPriorityQueue(DefaultShards(), compare, a) {}
+
+  /** num_shards is rounded up to a power of two. */
+  explicit ConcurrentPriorityQueue(size_type num_shards,
+                                   const TCompare& compare = TCompare(),
+                                   const allocator_type& a = allocator_type())
+      : compare_(compare),
+        allocator_(a),
+        mask_(RoundUpToPowerOfTwo(num_shards) - 1),
+        shards_(std::make_unique<Shard[]>(mask_ + 1)) {
+    for (size_type i = 0; i <= mask_; ++i) {
+      shards_[i].heap = heap_type(allocator_);
+    }
+  }
+
+  template <typename TInputIterator>
+  ConcurrentPriorityQueue(TInputIterator first, TInputIterator last,
+                          const TCompare& compare = TCompare(),
+                          const allocator_type& a = allocator_type())
+      : ConcurrentPriorityQueue(compare, a) {
+    PushRange(first, last);
+  }
+
+  ConcurrentPriorityQueue(const ConcurrentPriorityQueue&) = delete;
+  ConcurrentPriorityQueue& operator=(const ConcurrentPriorityQueue&) = delete;
+
+  ~ConcurrentPriorityQueue() = default;
+
+  void Push(const T& value) { InternalPush(value); }
+
+  void Push(T&& value) { InternalPush(std::move(value)); }
+
+  template <typename... TArgs>
+  void Emplace(TArgs&&... args) {
+    InternalPush(std::forward<TArgs>(args)...);
+  }
+
+  /** Pushes [first, last) into a single heap under one lock. */
+  template <typename TInputIterator>
+  void PushRange(TInputIterator first, TInputIterator last) {
+    if (first == last) return;
+    Shard& shard = LockAnyShard();
+    std::unique_lock<SpinMutex> lock(shard.mutex, std::adopt_lock);
+    for (; first != last; ++first) {
+      shard.heap.push_back(*first);
+      std::push_heap(shard.heap.begin(), shard.heap.end(), compare_);
+    }
+    shard.size.store(shard.heap.size(), std::memory_order_relaxed);
+  }
+
+  bool TryPop(T& result) { return InternalTryPop(result); }
+
+  /** Pops up to max_count items into out, each the larger top of two
+      random heaps. Returns the number of items written. */
+  template <typename TOutputIterator>
+  size_type TryPopBulk(TOutputIterator out, size_type max_count) {
+    size_type popped = 0;
+    for (; popped < max_count; ++popped) {
+      if (!InternalTryPopWith([&out](T& item) {
+            *out = std::move(item);
+            ++out;
+          })) {
+        break;
+      }
+    }
+    return popped;
+  }
+
+  size_type UnsafeSize() const {
+    size_type size = 0;
+    for (size_type i = 0; i <= mask_; ++i) {
+      size += shards_[i].size.load(std::memory_order_relaxed);
+    }
+    return size;
+  }
+
+  [[nodiscard]] bool Empty() const {
+    for (size_type i = 0; i <= mask_; ++i) {
+      if (shards_[i].size.load(std::memory_order_relaxed) != 0) return false;
+    }
+    return true;
+  }
+
+  /** Items pushed concurrently with Clear may survive it. */
+  void Clear() {
+    for (size_type i = 0; i <= mask_; ++i) {
+      Shard& shard = shards_[i];
+      SpinMutex::ScopedLock lock(shard.mutex);
+      shard.heap.clear();
+      shard.size.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  size_type NumShards() const { return mask_ + 1; }
+
+  allocator_type get_allocator() const { return allocator_; }
+
+  /** Two heaps per hardware thread keep try-lock collisions rare. */
+  static size_type DefaultShards() {
+    return 2 * ShardedCounter::DefaultShards();
+  }
+
+ private:
+  struct alignas(ws::internal::CacheLineSize()) Shard {
+    SpinMutex mutex;
+    heap_type heap;
+    // Mirrors heap.size() so that emptiness checks need no lock.
+    std::atomic<size_type> size{0};
+  };
+
+  template <typename... TArgs>
+  void InternalPush(TArgs&&... args) {
+    Shard& shard = LockAnyShard();
+    std::unique_lock<SpinMutex> lock(shard.mutex, std::adopt_lock);
+    shard.heap.emplace_back(std::forward<TArgs>(args)...);
+    std::push_heap(shard.heap.begin(), shard.heap.end(), compare_);
+    shard.size.store(shard.heap.size(), std::memory_order_relaxed);
+  }
+
+  bool InternalTryPop(T& result) {
+    return InternalTryPopWith(
+        [&result](T& item) { result = std::move(item); });
+  }
+
+  template <typename TConsumer>
+  bool InternalTryPopWith(TConsumer&& consume) {
+    ws::concurrency::internal::AtomicBackoff backoff;
+    for (;;) {
+      Shard& first = shards_[NextRandom() & mask_];
+      Shard& second = shards_[NextRandom() & mask_];
+      std::unique_lock<SpinMutex> first_lock(first.mutex, std::try_to_lock);
+      std::unique_lock<SpinMutex> second_lock;
+      if (&second != &first) {
+        second_lock = std::unique_lock<SpinMutex>(second.mutex,
+                                                  std::try_to_lock);
+      }
+
+      Shard* best = nullptr;
+      if (first_lock.owns_lock() && !first.heap.empty()) best = &first;
+      if (second_lock.owns_lock() && !second.heap.empty() &&
+          (best == nullptr ||
+           compare_(best->heap.front(), second.heap.front()))) {
+        best = &second;
+      }
+      if (best != nullptr) {
+        PopTop(*best, consume);
+        return true;
+      }
+      if (first_lock.owns_lock()) first_lock.unlock();
+      if (second_lock.owns_lock()) second_lock.unlock();
+
+      // Both choices were empty or busy: sweep every heap before giving up.
+      bool saw_items = false;
+      const size_type start = NextRandom() & mask_;
+      for (size_type i = 0; i <= mask_; ++i) {
+        Shard& shard = shards_[(start + i) & mask_];
+        if (shard.size.load(std::memory_order_relaxed) == 0) continue;
+        saw_items = true;
+        std::unique_lock<SpinMutex> lock(shard.mutex, std::try_to_lock);
+        if (lock.owns_lock() && !shard.heap.empty()) {
+          PopTop(shard, consume);
+          return true;
+        }
+      }
+      if (!saw_items) return false;
+      backoff.Wait();
+    }
+  }
+
+  /** pop_heap leaves the top at the back, outside the heap order, so it
+      is removed even if consume throws; the heap stays valid. */
+  template <typename TConsumer>
+  void PopTop(Shard& shard, TConsumer& consume) {
+    std::pop_heap(shard.heap.begin(), shard.heap.end(), compare_);
+    auto pop_guard = ws::concurrency::internal::templates::MakeRaiiGuard([&] {
+      shard.heap.pop_back();
+      shard.size.store(shard.heap.size(), std::memory_order_relaxed);
+    });
+    consume(shard.heap.back());
+  }
+
+  /** Returns a random shard whose mutex the caller now holds. */
+  Shard& LockAnyShard() {
+    ws::concurrency::internal::AtomicBackoff backoff;
+    for (;;) {
+      for (size_type attempt = 0; attempt <= mask_; ++attempt) {
+        Shard& shard = shards_[NextRandom() & mask_];
+        if (shard.mutex.try_lock()) return shard;
+      }
+      backoff.Wait();
+    }
+  }
+
+  static std::uint32_t NextRandom() {
+    static thread_local std::uint32_t state =
+        static_cast<std::uint32_t>(
+            ws::concurrency::internal::ThisThreadOrdinal() * 0x9E3779B9u) |
+        1u;
+    std::uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state = x;
+    return x;
+  }
+
+  static size_type RoundUpToPowerOfTwo(size_type n) {
+    size_type result = 1;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  TCompare compare_;
+  allocator_type allocator_;
+  const size_type mask_;
+  std::unique_ptr<Shard[]> shards_;
+};
+}  // namespace concurrency
+}  // namespace ws
+
+namespace ws {
+template <typename T, typename TCompare = std::less<T>,
+          typename TAllocator = std::allocator<T>>
+class concurrent_priority_queue {
+ public:
+  using queue_type =
+      ws::concurrency::ConcurrentPriorityQueue<T, TCompare, TAllocator>;
+
+  using value_type = typename queue_type::value_type;
+  using size_type = typename queue_type::size_type;
+  using reference = typename queue_type::reference;
+  using const_reference = typename queue_type::const_reference;
+  using difference_type = typename queue_type::difference_type;
+  using value_compare = typename queue_type::value_compare;
+  using allocator_type = typename queue_type::allocator_type;
+  using pointer = typename queue_type::pointer;
+  using const_pointer = typename queue_type::const_pointer;
+
+ private:
+  queue_type internal_instance_;
+
+ public:
+  concurrent_priority_queue() = default;
+
+  explicit concurrent_priority_queue(
+      const value_compare& compare,
+      const allocator_type& alloc = allocator_type())
+      : internal_instance_(compare, alloc) {}
+
+  template <typename TInputIt>
+  concurrent_priority_queue(TInputIt first, TInputIt last,
+                            const value_compare& compare = value_compare(),
+                            const allocator_type& alloc = allocator_type())
+      : internal_instance_(first, last, compare, alloc) {}
+
+  [[nodiscard]] bool empty() const { return internal_instance_.Empty(); }
+
+  [[nodiscard]]
+  size_type size() const {
+    return internal_instance_.UnsafeSize();
+  }
+
+  void push(const value_type& __x) { internal_instance_.Push(__x); }
+
+  void push(value_type&& __x) { internal_instance_.Push(std::move(__x)); }
+
+  template <typename... TArgs>
+  void emplace(TArgs&&... __args) {
+    internal_instance_.Emplace(std::forward<TArgs>(__args)...);
+  }
+
+  template <typename TInputIt>
+  void push_range(TInputIt __first, TInputIt __last) {
+    internal_instance_.PushRange(__first, __last);
+  }
+
+  bool try_pop(value_type& __x) { return internal_instance_.TryPop(__x); }
+
+  template <typename TOutputIt>
+  size_type try_pop_bulk(TOutputIt __out, size_type __max_count) {
+    return internal_instance_.TryPopBulk(__out, __max_count);
+  }
+
+  void clear() { internal_instance_.Clear(); }
+
+  allocator_type get_allocator() const {
+    return internal_instance_.get_allocator();
+  }
+};
+}  // namespace ws
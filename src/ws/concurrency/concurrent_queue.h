@@ -4,6 +4,8 @@
 #pragma once
 
 #include <functional>
+#include <iterator>
+#include <type_traits>
 #include <utility>
 
 #include "ws/concurrency/internal/concurrent_queue_base.h"
@@ -53,6 +55,13 @@ class ConcurrentQueue {
            "alignment error");
   }
 
+  template <typename TInputIterator>
+  ConcurrentQueue(TInputIterator first, TInputIterator last,
+                  const allocator_type& a = allocator_type())
+      : ConcurrentQueue(a) {
+    PushRange(first, last);
+  }
+
   ConcurrentQueue(const ConcurrentQueue& src, const allocator_type& a)
       : ConcurrentQueue(a) {
     queue_rep_ptr->Assign(*src.queue_rep_ptr, allocator_, CopyConstructItem);
@@ -125,8 +134,39 @@ class ConcurrentQueue {
     InternalPush(std::forward<TArgs>(args)...);
   }
 
+  /** Pushes [first, last) claiming all tickets with a single atomic
+      operation. Forward ranges are written page by page into each
+      micro-queue; input ranges fall back to one Push per element. */
+  template <typename TInputIterator>
+  void PushRange(TInputIterator first, TInputIterator last) {
+    using iterator_category =
+        typename std::iterator_traits<TInputIterator>::iterator_category;
+    if constexpr (std::is_base_of<std::forward_iterator_tag,
+                                  iterator_category>::value) {
+      InternalPushRange(first, std::distance(first, last));
+    } else {
+      for (; first != last; ++first) {
+        InternalPush(*first);
+      }
+    }
+  }
+
   bool TryPop(T& result) { return InternalTryPop(&result); }
 
+  /** Pops up to max_count items into out, in FIFO order, claiming the
+      available tickets in one atomic operation. Returns the number of items
+      written. */
+  template <typename TOutputIterator>
+  size_type TryPopBulk(TOutputIterator out, size_type max_count) {
+    return ws::concurrency::internal::InternalTryPopBulkImpl(
+               *queue_rep_ptr, allocator_, max_count,
+               [&out](reference item) {
+                 *out = std::move(item);
+                 ++out;
+               })
+        .first;
+  }
+
   size_type UnsafeSize() const {
     std::ptrdiff_t size = queue_rep_ptr->Size();
     return size < 0 ? 0 : size_type(size);
@@ -151,6 +191,17 @@ class ConcurrentQueue {
                                   std::forward<TArgs>(args)...);
   }
 
+  template <typename TForwardIterator>
+  void InternalPushRange(TForwardIterator first,
+                         typename std::iterator_traits<
+                             TForwardIterator>::difference_type count) {
+    if (count <= 0) return;
+    ws::concurrency::internal::ticket_type k =
+        queue_rep_ptr->tail_counter_.fetch_add(size_type(count));
+    ws::concurrency::internal::InternalPushRangeImpl(
+        *queue_rep_ptr, allocator_, k, size_type(count), first);
+  }
+
   bool InternalTryPop(void* dst) {
     return ws::concurrency::internal::InternalTryPopImpl(dst, *queue_rep_ptr,
                                                          allocator_)
@@ -252,8 +303,18 @@ class concurrent_queue {
     internal_instance_.Emplace(std::forward<TArgs>(__args)...);
   }
 
+  template <typename TInputIt>
+  void push_range(TInputIt __first, TInputIt __last) {
+    internal_instance_.PushRange(__first, __last);
+  }
+
   bool try_pop(value_type& __x) { return internal_instance_.TryPop(__x); }
 
+  template <typename TOutputIt>
+  size_type try_pop_bulk(TOutputIt __out, size_type __max_count) {
+    return internal_instance_.TryPopBulk(__out, __max_count);
+  }
+
   void pop(value_type& __x) { internal_instance_.TryPop(__x); }
 
   void pop() {
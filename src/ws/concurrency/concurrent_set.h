@@ -0,0 +1,380 @@
+// Based on oneTBB (https://github.com/uxlfoundation/oneTBB)
+// See THIRD-PARTY-NOTICES
+
+#pragma once
+
+#include <functional>
+
+#include "ws/concurrency/internal/concurrent_skip_list.h"
+#include "ws/concurrency/internal/helpers.h"
+
+namespace ws {
+namespace concurrency {
+template <typename TKey, typename TCompare, typename TAllocator,
+          bool AllowMultimapping>
+struct ConcurrentSetTraits {
+  static constexpr std::size_t kMaxLevel = 32;
+  using key_type = TKey;
+  using value_type = key_type;
+  using key_compare = TCompare;
+  using value_compare = TCompare;
+  using allocator_type = TAllocator;
+  static constexpr bool kAllowMultimapping = AllowMultimapping;
+
+  static constexpr const key_type& GetKey(const value_type& value) {
+    return value;
+  }
+
+  static value_compare ValueComp(key_compare comp) { return comp; }
+};
+
+/** Ordered set on a lock-free skip list. Insert, Find, LowerBound and
+    iteration may run concurrently; erasing is not thread-safe. */
+template <typename TKey, typename TCompare = std::less<TKey>,
+          typename TAllocator = std::allocator<TKey>>
+class ConcurrentSet
+    : public ws::concurrency::internal::ConcurrentSkipList<
+          ConcurrentSetTraits<TKey, TCompare, TAllocator, false>> {
+  using traits_type = ConcurrentSetTraits<TKey, TCompare, TAllocator, false>;
+  using base_type = ws::concurrency::internal::ConcurrentSkipList<traits_type>;
+
+ public:
+  using key_type = typename base_type::key_type;
+  using value_type = typename base_type::value_type;
+  using size_type = typename base_type::size_type;
+  using difference_type = typename base_type::difference_type;
+  using key_compare = typename base_type::key_compare;
+  using value_compare = typename base_type::value_compare;
+  using allocator_type = typename base_type::allocator_type;
+  using reference = typename base_type::reference;
+  using const_reference = typename base_type::const_reference;
+  using pointer = typename base_type::pointer;
+  using const_pointer = typename base_type::const_pointer;
+  using iterator = typename base_type::iterator;
+  using const_iterator = typename base_type::const_iterator;
+  using node_type = typename base_type::node_type;
+
+  using base_type::base_type;
+
+  ConcurrentSet() = default;
+  ConcurrentSet(const ConcurrentSet&) = default;
+  ConcurrentSet(const ConcurrentSet& other, const allocator_type& alloc)
+      : base_type(other, alloc) {}
+  ConcurrentSet(ConcurrentSet&&) = default;
+  ConcurrentSet(ConcurrentSet&& other, const allocator_type& alloc)
+      : base_type(std::move(other), alloc) {}
+
+  ConcurrentSet& operator=(const ConcurrentSet&) = default;
+  ConcurrentSet& operator=(ConcurrentSet&&) = default;
+
+  ConcurrentSet& operator=(std::initializer_list<value_type> il) {
+    base_type::operator=(il);
+    return *this;
+  }
+
+  template <typename TOtherCompare>
+  void Merge(ConcurrentSet<key_type, TOtherCompare, allocator_type>& source) {
+    this->InternalMerge(source);
+  }
+
+  template <typename TOtherCompare>
+  void Merge(ConcurrentSet<key_type, TOtherCompare, allocator_type>&& source) {
+    this->InternalMerge(std::move(source));
+  }
+};
+
+#if _CPP17_DEDUCTION_GUIDES_PRESENT
+
+template <typename It,
+          typename TComp = std::less<
+              ws::concurrency::internal::templates::iterator_value_t<It>>,
+          typename TAlloc = std::allocator<
+              ws::concurrency::internal::templates::iterator_value_t<It>>,
+          typename = std::enable_if_t<
+              ws::concurrency::internal::containers::is_input_iterator_v<It>>,
+          typename = std::enable_if_t<
+              ws::concurrency::internal::templates::is_allocator_v<TAlloc>>,
+          typename = std::enable_if_t<
+              !ws::concurrency::internal::templates::is_allocator_v<TComp>>>
+ConcurrentSet(It, It, TComp = TComp(), TAlloc = TAlloc())
+    -> ConcurrentSet<ws::concurrency::internal::templates::iterator_value_t<It>,
+                     TComp, TAlloc>;
+
+template <typename T, typename TComp = std::less<T>,
+          typename TAlloc = std::allocator<T>,
+          typename = std::enable_if_t<
+              ws::concurrency::internal::templates::is_allocator_v<TAlloc>>,
+          typename = std::enable_if_t<
+              !ws::concurrency::internal::templates::is_allocator_v<TComp>>>
+ConcurrentSet(std::initializer_list<T>, TComp = TComp(), TAlloc = TAlloc())
+    -> ConcurrentSet<T, TComp, TAlloc>;
+
+#endif
+
+template <typename TKey, typename TCompare, typename TAllocator>
+void Swap(ConcurrentSet<TKey, TCompare, TAllocator>& lhs,
+          ConcurrentSet<TKey, TCompare, TAllocator>& rhs) {
+  lhs.Swap(rhs);
+}
+}  // namespace concurrency
+}  // namespace ws
+
+namespace ws {
+template <typename TKey, typename TCompare = std::less<TKey>,
+          typename TAllocator = std::allocator<TKey>>
+class concurrent_set {
+ public:
+  using skip_list_type =
+      ws::concurrency::ConcurrentSet<TKey, TCompare, TAllocator>;
+  using key_type = typename skip_list_type::key_type;
+  using value_type = typename skip_list_type::value_type;
+  using size_type = typename skip_list_type::size_type;
+  using difference_type = typename skip_list_type::difference_type;
+  using key_compare = typename skip_list_type::key_compare;
+  using value_compare = typename skip_list_type::value_compare;
+  using allocator_type = typename skip_list_type::allocator_type;
+  using reference = typename skip_list_type::reference;
+  using const_reference = typename skip_list_type::const_reference;
+  using pointer = typename skip_list_type::pointer;
+  using const_pointer = typename skip_list_type::const_pointer;
+  using iterator = typename skip_list_type::iterator;
+  using const_iterator = typename skip_list_type::const_iterator;
+  using node_type = typename skip_list_type::node_type;
+
+ private:
+  skip_list_type internal_instance_;
+
+ public:
+  concurrent_set() = default;
+
+  explicit concurrent_set(const key_compare& comp,
+                          const allocator_type& alloc = allocator_type())
+      : internal_instance_(comp, alloc) {}
+
+  explicit concurrent_set(const allocator_type& alloc)
+      : internal_instance_(alloc) {}
+
+  template <typename InputIt>
+  concurrent_set(InputIt first, InputIt last,
+                 const key_compare& comp = key_compare(),
+                 const allocator_type& alloc = allocator_type())
+      : internal_instance_(first, last, comp, alloc) {}
+
+  template <typename InputIt>
+  concurrent_set(InputIt first, InputIt last, const allocator_type& alloc)
+      : internal_instance_(first, last, alloc) {}
+
+  concurrent_set(std::initializer_list<value_type> il,
+                 const key_compare& comp = key_compare(),
+                 const allocator_type& alloc = allocator_type())
+      : internal_instance_(il, comp, alloc) {}
+
+  concurrent_set(std::initializer_list<value_type> il,
+                 const allocator_type& alloc)
+      : internal_instance_(il, alloc) {}
+
+  concurrent_set(const concurrent_set& other)
+      : internal_instance_(other.internal_instance_) {}
+
+  concurrent_set(const concurrent_set& other, const allocator_type& alloc)
+      : internal_instance_(other.internal_instance_, alloc) {}
+
+  concurrent_set(concurrent_set&& other) noexcept
+      : internal_instance_(std::move(other.internal_instance_)) {}
+
+  concurrent_set(concurrent_set&& other, const allocator_type& alloc)
+      : internal_instance_(std::move(other.internal_instance_), alloc) {}
+
+  concurrent_set& operator=(const concurrent_set& other) {
+    internal_instance_ = other.internal_instance_;
+    return *this;
+  }
+
+  concurrent_set& operator=(concurrent_set&& other) noexcept {
+    internal_instance_ = std::move(other.internal_instance_);
+    return *this;
+  }
+
+  concurrent_set& operator=(std::initializer_list<value_type> il) {
+    internal_instance_ = il;
+    return *this;
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return internal_instance_.get_allocator();
+  }
+
+  bool empty() const noexcept { return internal_instance_.Empty(); }
+
+  size_type size() const noexcept { return internal_instance_.Size(); }
+
+  size_type max_size() const noexcept { return internal_instance_.MaxSize(); }
+
+  iterator begin() noexcept { return internal_instance_.begin(); }
+
+  const_iterator begin() const noexcept { return internal_instance_.begin(); }
+
+  const_iterator cbegin() const noexcept { return internal_instance_.cbegin(); }
+
+  iterator end() noexcept { return internal_instance_.end(); }
+
+  const_iterator end() const noexcept { return internal_instance_.end(); }
+
+  const_iterator cend() const noexcept { return internal_instance_.cend(); }
+
+  template <typename... TArgs>
+  std::pair<iterator, bool> emplace(TArgs&&... __args) {
+    return internal_instance_.Emplace(std::forward<TArgs>(__args)...);
+  }
+
+  template <typename... TArgs>
+  iterator emplace_hint(const_iterator __pos, TArgs&&... __args) {
+    return internal_instance_.EmplaceHint(__pos,
+                                          std::forward<TArgs>(__args)...);
+  }
+
+  node_type extract(const_iterator __pos) {
+    return internal_instance_.UnsafeExtract(__pos);
+  }
+
+  node_type extract(const key_type& __key) {
+    return internal_instance_.UnsafeExtract(__key);
+  }
+
+  std::pair<iterator, bool> insert(node_type&& __nh) {
+    return internal_instance_.Insert(std::move(__nh));
+  }
+
+  iterator insert(const_iterator __hint, node_type&& __nh) {
+    return internal_instance_.Insert(__hint, std::move(__nh));
+  }
+
+  std::pair<iterator, bool> insert(const value_type& __x) {
+    return internal_instance_.Insert(__x);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& __x) {
+    return internal_instance_.Insert(std::move(__x));
+  }
+
+  iterator insert(const_iterator __hint, const value_type& __x) {
+    return internal_instance_.Insert(__hint, __x);
+  }
+
+  iterator insert(const_iterator __hint, value_type&& __x) {
+    return internal_instance_.Insert(__hint, std::move(__x));
+  }
+
+  template <typename TInputIterator>
+  void insert(TInputIterator __first, TInputIterator __last) {
+    internal_instance_.Insert(__first, __last);
+  }
+
+  void insert(std::initializer_list<value_type> __l) {
+    internal_instance_.Insert(__l);
+  }
+
+  /** Not safe to call while other threads use the set. */
+  iterator erase(const_iterator __position) {
+    return internal_instance_.UnsafeErase(__position);
+  }
+
+  iterator erase(iterator __position) {
+    return internal_instance_.UnsafeErase(__position);
+  }
+
+  size_type erase(const key_type& __x) {
+    return internal_instance_.UnsafeErase(__x);
+  }
+
+  iterator erase(const_iterator __first, const_iterator __last) {
+    return internal_instance_.UnsafeErase(__first, __last);
+  }
+
+  void clear() noexcept { internal_instance_.Clear(); }
+
+  void swap(concurrent_set& __x) {
+    internal_instance_.Swap(__x.internal_instance_);
+  }
+
+  template <typename TC2>
+  void merge(concurrent_set<TKey, TC2, TAllocator>& __source) {
+    internal_instance_.Merge(__source.internal_instance_);
+  }
+
+  template <typename TC2>
+  void merge(concurrent_set<TKey, TC2, TAllocator>&& __source) {
+    internal_instance_.Merge(__source.internal_instance_);
+  }
+
+  key_compare key_comp() const { return internal_instance_.KeyComp(); }
+
+  value_compare value_comp() const { return internal_instance_.ValueComp(); }
+
+  iterator find(const key_type& __x) { return internal_instance_.Find(__x); }
+
+  template <typename _Kt>
+  auto find(const _Kt& __x) -> decltype(internal_instance_.Find(__x)) {
+    return internal_instance_.Find(__x);
+  }
+
+  const_iterator find(const key_type& __x) const {
+    return internal_instance_.Find(__x);
+  }
+
+  template <typename _Kt>
+  auto find(const _Kt& __x) const -> decltype(internal_instance_.Find(__x)) {
+    return internal_instance_.Find(__x);
+  }
+
+  size_type count(const key_type& __x) const {
+    return internal_instance_.Count(__x);
+  }
+
+  bool contains(const key_type& __x) const {
+    return internal_instance_.Contains(__x);
+  }
+
+  /** Safe during concurrent inserts; iterating from the result is too. */
+  iterator lower_bound(const key_type& __x) {
+    return internal_instance_.LowerBound(__x);
+  }
+
+  const_iterator lower_bound(const key_type& __x) const {
+    return internal_instance_.LowerBound(__x);
+  }
+
+  iterator upper_bound(const key_type& __x) {
+    return internal_instance_.UpperBound(__x);
+  }
+
+  const_iterator upper_bound(const key_type& __x) const {
+    return internal_instance_.UpperBound(__x);
+  }
+
+  std::pair<iterator, iterator> equal_range(const key_type& __x) {
+    return internal_instance_.EqualRange(__x);
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(
+      const key_type& __x) const {
+    return internal_instance_.EqualRange(__x);
+  }
+
+  template <typename TKey1, typename TCompare1, typename TAllocator1>
+  friend bool operator==(
+      const concurrent_set<TKey1, TCompare1, TAllocator1>& lhs,
+      const concurrent_set<TKey1, TCompare1, TAllocator1>& rhs);
+};
+
+template <typename TKey1, typename TCompare1, typename TAllocator1>
+inline bool operator==(
+    const concurrent_set<TKey1, TCompare1, TAllocator1>& lhs,
+    const concurrent_set<TKey1, TCompare1, TAllocator1>& rhs) {
+  if (&lhs == &rhs) {
+    return true;
+  }
+
+  return lhs.internal_instance_ == rhs.internal_instance_;
+}
+}  // namespace ws
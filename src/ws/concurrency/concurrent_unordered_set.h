@@ -54,6 +54,7 @@ class ConcurrentUnorderedSet
   using local_iterator = typename base_type::local_iterator;
   using const_local_iterator = typename base_type::const_local_iterator;
   using node_type = typename base_type::node_type;
+  using snapshot_type = typename base_type::snapshot_type;
 
   using base_type::base_type;
 
@@ -194,7 +195,6 @@ class concurrent_unordered_set {
       ws::concurrency::ConcurrentUnorderedSet<TKey, THash, TKeyEqual,
                                               TAllocator>;
   using key_type = typename hashtable_type::key_type;
-  using mapped_type = typename hashtable_type::mapped_type;
   using value_type = typename hashtable_type::value_type;
   using size_type = typename hashtable_type::size_type;
   using difference_type = typename hashtable_type::difference_type;
@@ -210,6 +210,8 @@ class concurrent_unordered_set {
   using local_iterator = typename hashtable_type::local_iterator;
   using const_local_iterator = typename hashtable_type::const_local_iterator;
   using node_type = typename hashtable_type::node_type;
+  using epoch_guard_type = typename hashtable_type::epoch_guard_type;
+  using snapshot_type = typename hashtable_type::snapshot_type;
 
  private:
   hashtable_type internal_instance_;
@@ -374,6 +376,25 @@ class concurrent_unordered_set {
     return internal_instance_.UnsafeErase(__first, __last);
   }
 
+  /** Safe to call while other threads insert, look up or erase. */
+  size_type concurrent_erase(const key_type& __x) {
+    return internal_instance_.Erase(__x);
+  }
+
+  template <typename _Kt>
+  auto concurrent_erase(const _Kt& __x)
+      -> decltype(internal_instance_.Erase(__x)) {
+    return internal_instance_.Erase(__x);
+  }
+
+  /** Keeps elements alive for iteration while other threads call
+      concurrent_erase. */
+  epoch_guard_type pin() const { return internal_instance_.Pin(); }
+
+  /** Contiguous, immutable copy of the elements, taken without blocking
+      concurrent writers. */
+  snapshot_type snapshot() const { return internal_instance_.Snapshot(); }
+
   void clear() noexcept { internal_instance_.Clear(); }
 
   void swap(concurrent_unordered_set& __x) noexcept(
@@ -464,6 +485,14 @@ class concurrent_unordered_set {
 
   void rehash(size_type __n) { internal_instance_.ReHash(__n); }
 
+  ws::concurrency::NumaPolicy numa_policy() const noexcept {
+    return internal_instance_.GetNumaPolicy();
+  }
+
+  void numa_policy(ws::concurrency::NumaPolicy __policy) {
+    internal_instance_.SetNumaPolicy(__policy);
+  }
+
   void reserve(size_type __n) { internal_instance_.Reserve(__n); }
 };
 
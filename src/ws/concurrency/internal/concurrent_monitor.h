@@ -4,6 +4,8 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <new>
 #include <semaphore>
 
 #include "ws/concurrency/internal/aligned_space.h"
@@ -112,6 +114,9 @@ class WaitNode : public base_node {
 
   virtual void Wait() = 0;
 
+  /** Returns false if deadline passed before the node was notified. */
+  virtual bool WaitUntil(std::chrono::steady_clock::time_point deadline) = 0;
+
   virtual void Reset() {
     assert(skipped_wakeup_);
     skipped_wakeup_ = false;
@@ -165,6 +170,16 @@ class SleepNode : public WaitNode<TContext> {
     if (this->aborted_) throw std::runtime_error("user_abort");
   }
 
+  bool WaitUntil(std::chrono::steady_clock::time_point deadline) override {
+    assert(this->initialized_ &&
+           "Use of CommitWait() without prior PrepareWait()");
+    if (!Semaphore().try_acquire_until(deadline)) return false;
+    assert(!this->is_in_list_.load(std::memory_order_relaxed) &&
+           "Still in the queue?");
+    if (this->aborted_) throw std::runtime_error("user_abort");
+    return true;
+  }
+
   void Reset() override {
     base_type::Reset();
     Semaphore().acquire();
@@ -247,6 +262,41 @@ class ConcurrentMonitorBase {
     return false;
   }
 
+  /** Like Wait, but gives up once deadline passes. Returns false on
+      timeout and true when the predicate held or the node was notified. A
+      notification that races with the timeout is absorbed by the node's
+      next PrepareWait. */
+  template <typename TNodeType, typename TPred>
+  bool WaitUntil(TPred&& pred, TNodeType&& node,
+                 std::chrono::steady_clock::time_point deadline) {
+    PrepareWait(node);
+    while (!GuardedCall(std::forward<TPred>(pred), node)) {
+      if (node.epoch_ == epoch_.load(std::memory_order_relaxed)) {
+        if (node.WaitUntil(deadline)) return true;
+        CancelWait(node);
+        return false;
+      }
+
+      CancelWait(node);
+      PrepareWait(node);
+    }
+
+    CancelWait(node);
+    return true;
+  }
+
+  /** Wakes node alone if it is currently waiting on this monitor. */
+  void NotifyNode(WaitNode<TContext>& node) {
+    AtomicFenceSeqCst();
+    {
+      ConcurrentMonitorMutex::scoped_lock l(mutex_);
+      if (!node.is_in_list_.load(std::memory_order_relaxed)) return;
+      waitset_.Remove(node);
+      node.is_in_list_.store(false, std::memory_order_relaxed);
+    }
+    node.Notify();
+  }
+
   void NotifyOne() {
     AtomicFenceSeqCst();
     NotifyOneRelaxed();
@@ -426,8 +476,12 @@ class ConcurrentMonitorBase {
   base_list waitset_{};
   std::atomic<unsigned> epoch_{};
 
+  /** The wait set's sentinel is a bare base_node, so GCC assumes a node
+      taken from the list may be the sentinel and flags stores to
+      WaitNode fields with -Wstringop-overflow. Laundering drops that
+      provenance; every caller stops before reaching the sentinel. */
   WaitNode<TContext>* ToWaitNode(base_node* node) {
-    return static_cast<WaitNode<TContext>*>(node);
+    return std::launder(static_cast<WaitNode<TContext>*>(node));
   }
 };
 
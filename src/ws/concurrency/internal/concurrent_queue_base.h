@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+
 #include "ws/concurrency/internal/allocator_traits.h"
 #include "ws/concurrency/internal/atomic_backoff.h"
 #include "ws/concurrency/internal/concurrent_monitor.h"
@@ -27,7 +30,7 @@ struct ConcurrentQueueRep;
 template <typename TContainer, typename T, typename TAllocator>
 class MicroQueuePopFinalizer;
 
-#if _MSC_VER && !defined(__INTEL_COMPILER)
+#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
 #pragma warning(push)
 #pragma warning(disable : 4146)
 #endif
@@ -151,8 +154,64 @@ class MicroQueue {
     tail_counter_.fetch_add(queue_rep_type::kNQueue);
   }
 
+  template <typename TIterator>
+  void PushRun(ticket_type k, size_type count, queue_rep_type& base,
+               queue_allocator_type& allocator, TIterator it,
+               typename std::iterator_traits<TIterator>::difference_type
+                   stride) {
+    assert(count > 0 && "Empty runs must not be pushed");
+    page_allocator_type page_allocator(allocator);
+    PaddedPage* p = PrepareRun(k, count, base, page_allocator);
+    size_type index = ws::internal::ModulusPowerOfTwo(
+        (k & -queue_rep_type::kNQueue) / queue_rep_type::kNQueue,
+        kItemsPerPage);
+
+    size_type constructed = 0;
+    std::uintptr_t page_mask = 0;
+    auto publish_guard =
+        ws::concurrency::internal::templates::MakeRaiiGuard([&] {
+          p->mask.store(p->mask.load(std::memory_order_relaxed) | page_mask,
+                        std::memory_order_relaxed);
+          if (constructed != count) {
+            base.n_invalid_entries_ += count - constructed;
+          }
+          tail_counter_.fetch_add(count * queue_rep_type::kNQueue);
+        });
+
+    for (;;) {
+      page_allocator_traits::construct(page_allocator, &(*p)[index], *it);
+      page_mask |= std::uintptr_t(1) << index;
+      if (++constructed == count) break;
+
+      std::advance(it, stride);
+      if (++index == kItemsPerPage) {
+        p->mask.store(p->mask.load(std::memory_order_relaxed) | page_mask,
+                      std::memory_order_relaxed);
+        page_mask = 0;
+        index = 0;
+        p = p->next;
+      }
+    }
+  }
+
+  void AbortPushRun(ticket_type k, size_type count, queue_rep_type& base,
+                    queue_allocator_type& allocator) {
+    page_allocator_type page_allocator(allocator);
+    PrepareRun(k, count, base, page_allocator);
+    base.n_invalid_entries_ += count;
+    tail_counter_.fetch_add(count * queue_rep_type::kNQueue);
+  }
+
   bool Pop(void* dst, ticket_type k, queue_rep_type& base,
            queue_allocator_type& allocator) {
+    return PopInto(k, base, allocator, [dst](reference from) {
+      *static_cast<T*>(dst) = std::move(from);
+    });
+  }
+
+  template <typename TConsumer>
+  bool PopInto(ticket_type k, queue_rep_type& base,
+               queue_allocator_type& allocator, TConsumer&& consumer) {
     k &= -queue_rep_type::kNQueue;
     ws::concurrency::SpinWaitUntilEq(head_counter_, k);
     ws::concurrency::SpinWaitWhileEq(tail_counter_, k);
@@ -169,7 +228,7 @@ class MicroQueue {
       if (p->mask.load(std::memory_order_relaxed) &
           (std::uintptr_t(1) << index)) {
         success = true;
-        AssignAndDestroyItem(dst, *p, index);
+        ConsumeAndDestroyItem(*p, index, consumer);
       } else {
         --base.n_invalid_entries_;
       }
@@ -310,7 +369,7 @@ class MicroQueue {
 
   void ClearAndInvalidate(queue_allocator_type& allocator) {
     PaddedPage* invalid_page = reinterpret_cast<PaddedPage*>(std::uintptr_t(1));
-    clear(allocator, invalid_page, invalid_page);
+    Clear(allocator, invalid_page, invalid_page);
   }
 
  protected:
@@ -336,10 +395,67 @@ class MicroQueue {
     construct_item(&dst[dindex], static_cast<const void*>(&src_item));
   }
 
-  void AssignAndDestroyItem(void* dst, PaddedPage& src, size_type index) {
+  template <typename TConsumer>
+  void ConsumeAndDestroyItem(PaddedPage& src, size_type index,
+                             TConsumer& consumer) {
     auto& from = src[index];
     Destroyer d(from);
-    *static_cast<T*>(dst) = std::move(from);
+    consumer(from);
+  }
+
+  PaddedPage* PrepareRun(ticket_type k, size_type count, queue_rep_type& base,
+                         page_allocator_type& page_allocator) {
+    k &= -queue_rep_type::kNQueue;
+    size_type index = ws::internal::ModulusPowerOfTwo(
+        k / queue_rep_type::kNQueue, kItemsPerPage);
+    size_type n_pages = (index + count - 1) / kItemsPerPage + (index ? 0 : 1);
+
+    PaddedPage* first_page = nullptr;
+    PaddedPage* last_page = nullptr;
+    auto release_pages = [&] {
+      while (first_page) {
+        PaddedPage* next_page = first_page->next;
+        page_allocator_traits::destroy(page_allocator, first_page);
+        page_allocator_traits::deallocate(page_allocator, first_page, 1);
+        first_page = next_page;
+      }
+    };
+
+    ws::concurrency::internal::templates::TryCall([&] {
+      for (size_type i = 0; i < n_pages; ++i) {
+        PaddedPage* page = page_allocator_traits::allocate(page_allocator, 1);
+        page_allocator_traits::construct(page_allocator, page);
+        if (last_page) {
+          last_page->next = page;
+        } else {
+          first_page = page;
+        }
+        last_page = page;
+      }
+    }).OnException([&] {
+      release_pages();
+      base.n_invalid_entries_ += count;
+      InvalidatePage(k);
+    });
+
+    ws::concurrency::internal::templates::TryCall([&] {
+      SpinWaitUntilTurn(tail_counter_, k, base);
+    }).OnException([&] {
+      release_pages();
+      base.n_invalid_entries_ += count - 1;
+    });
+
+    ws::concurrency::SpinMutex::ScopedLock lock(page_mutex_);
+    PaddedPage* q = tail_page_.load(std::memory_order_relaxed);
+    if (first_page) {
+      if (IsValidPage(q)) {
+        q->next = first_page;
+      } else {
+        head_page_.store(first_page, std::memory_order_relaxed);
+      }
+      tail_page_.store(last_page, std::memory_order_relaxed);
+    }
+    return index ? q : first_page;
   }
 
   void SpinWaitUntilTurn(std::atomic<ticket_type>& counter, ticket_type k,
@@ -364,7 +480,7 @@ class MicroQueue {
   ws::concurrency::SpinMutex page_mutex_{};
 };
 
-#if _MSC_VER && !defined(__INTEL_COMPILER)
+#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
 #pragma warning(pop)
 #endif
 
@@ -407,7 +523,7 @@ class MicroQueuePopFinalizer {
   TAllocator& allocator_;
 };
 
-#if _MSC_VER && !defined(__INTEL_COMPILER)
+#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
 #pragma warning(push)
 #pragma warning(disable : 4324)
 #endif
@@ -462,7 +578,7 @@ struct ConcurrentQueueRep {
     size_type queue_idx = 0;
     ws::concurrency::internal::templates::TryCall([&] {
       for (; queue_idx < kNQueue; ++queue_idx) {
-        array_[queue_idx].assign(src.array_[queue_idx], alloc, construct_item);
+        array_[queue_idx].Assign(src.array_[queue_idx], alloc, construct_item);
       }
     }).OnException([&] {
       for (size_type i = 0; i < queue_idx + 1; ++i) {
@@ -515,10 +631,72 @@ struct ConcurrentQueueRep {
       std::atomic<size_type> n_invalid_entries_{};
 };
 
-#if _MSC_VER && !defined(__INTEL_COMPILER)
+#if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
 #pragma warning(pop)
 #endif
 
+template <typename TQueueRep, typename TAllocator, typename TForwardIterator>
+inline void InternalPushRangeImpl(TQueueRep& queue, TAllocator& alloc,
+                                  ticket_type k, std::size_t count,
+                                  TForwardIterator first) {
+  constexpr std::size_t kNQueue = TQueueRep::kNQueue;
+  const std::size_t n_runs = count < kNQueue ? count : kNQueue;
+
+  std::size_t run = 0;
+  ws::concurrency::internal::templates::TryCall([&] {
+    for (; run < n_runs; ++run) {
+      queue.Choose(k + run).PushRun(k + run,
+                                    (count - run + kNQueue - 1) / kNQueue,
+                                    queue, alloc, first, kNQueue);
+      if (run + 1 < n_runs) ++first;
+    }
+  }).OnException([&] {
+    for (++run; run < n_runs; ++run) {
+      queue.Choose(k + run).AbortPushRun(
+          k + run, (count - run + kNQueue - 1) / kNQueue, queue, alloc);
+    }
+  });
+}
+
+template <typename TQueueRep, typename TAllocator, typename TConsumer>
+inline std::pair<std::size_t, ticket_type> InternalTryPopBulkImpl(
+    TQueueRep& queue, TAllocator& alloc, std::size_t max_count,
+    TConsumer&& consumer) {
+  std::size_t popped = 0;
+  ticket_type ticket{};
+  while (popped < max_count) {
+    std::size_t claimed{};
+    ticket = queue.head_counter_.load(std::memory_order_acquire);
+    do {
+      std::ptrdiff_t available = static_cast<std::ptrdiff_t>(
+          queue.tail_counter_.load(std::memory_order_relaxed) - ticket);
+      if (available <= 0) {
+        return {popped, ticket};
+      }
+
+      claimed = std::min(static_cast<std::size_t>(available),
+                         max_count - popped);
+    } while (
+        !queue.head_counter_.compare_exchange_strong(ticket, ticket + claimed));
+
+    const ticket_type end = ticket + claimed;
+    ws::concurrency::internal::templates::TryCall([&] {
+      for (; ticket != end; ++ticket) {
+        if (queue.Choose(ticket).PopInto(ticket, queue, alloc, consumer)) {
+          ++popped;
+        }
+      }
+    }).OnException([&] {
+      // Claimed tickets must still be drained, otherwise the micro-queues
+      // they belong to would never advance past them.
+      for (++ticket; ticket != end; ++ticket) {
+        queue.Choose(ticket).PopInto(ticket, queue, alloc, [](auto&) {});
+      }
+    });
+  }
+  return {popped, ticket};
+}
+
 template <typename TQueueRep, typename TAllocator>
 inline std::pair<bool, ticket_type> InternalTryPopImpl(void* dst,
                                                        TQueueRep& queue,
@@ -0,0 +1,965 @@
+// Based on oneTBB (https://github.com/uxlfoundation/oneTBB)
+// See THIRD-PARTY-NOTICES
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "ws/concurrency/internal/allocator_traits.h"
+#include "ws/concurrency/internal/helpers.h"
+#include "ws/concurrency/internal/node_handle.h"
+
+namespace ws {
+namespace concurrency {
+namespace internal {
+
+template <typename TTraits>
+class ConcurrentSkipList;
+
+/** Skip list node. The value is followed in the same allocation by one
+    atomic next pointer per level, so a node only pays for the levels it is
+    linked into. */
+template <typename TValue, typename TAllocator>
+class SkipListNode {
+  using self_type = SkipListNode<TValue, TAllocator>;
+  using atomic_node_ptr = std::atomic<self_type*>;
+  using node_allocator_type = typename std::allocator_traits<
+      TAllocator>::template rebind_alloc<self_type>;
+  using node_allocator_traits = std::allocator_traits<node_allocator_type>;
+
+ public:
+  using value_type = TValue;
+  using size_type = std::size_t;
+
+  SkipListNode(const SkipListNode&) = delete;
+  SkipListNode& operator=(const SkipListNode&) = delete;
+
+  /** Allocates a node of the given height with all next pointers null. The
+      value is left for the caller to construct in Storage(). */
+  static self_type* Allocate(const TAllocator& alloc, size_type height) {
+    node_allocator_type node_allocator(alloc);
+    self_type* node = node_allocator_traits::allocate(node_allocator,
+                                                      NodeUnits(height));
+    ::new (static_cast<void*>(node)) self_type(height);
+    return node;
+  }
+
+  /** Releases a node whose value is already destroyed. */
+  static void Deallocate(const TAllocator& alloc, self_type* node) {
+    node_allocator_type node_allocator(alloc);
+    const size_type height = node->Height();
+    node->~self_type();
+    node_allocator_traits::deallocate(node_allocator, node, NodeUnits(height));
+  }
+
+  value_type* Storage() { return &value_; }
+
+  value_type& Value() { return *Storage(); }
+
+  size_type Height() const { return height_; }
+
+  self_type* Next(size_type level) const {
+    assert(level < Height() && "Level is out of the node height");
+    return AtomicNext(level).load(std::memory_order_acquire);
+  }
+
+  /** Only for nodes that are not yet reachable, or under exclusive
+      access. */
+  void SetNext(size_type level, self_type* next) {
+    assert(level < Height() && "Level is out of the node height");
+    AtomicNext(level).store(next, std::memory_order_relaxed);
+  }
+
+  /** Links new_node after this node if the successor is still expected. */
+  bool TryInsertNext(size_type level, self_type* expected,
+                     self_type* new_node) {
+    assert(level < Height() && "Level is out of the node height");
+    return AtomicNext(level).compare_exchange_strong(
+        expected, new_node, std::memory_order_release,
+        std::memory_order_relaxed);
+  }
+
+ private:
+  explicit SkipListNode(size_type height) : height_(height) {
+    for (size_type level = 0; level < height_; ++level) {
+      ::new (static_cast<void*>(&AtomicNext(level))) atomic_node_ptr(nullptr);
+    }
+  }
+
+  ~SkipListNode() {
+    for (size_type level = 0; level < height_; ++level) {
+      AtomicNext(level).~atomic_node_ptr();
+    }
+  }
+
+  atomic_node_ptr& AtomicNext(size_type level) const {
+    return reinterpret_cast<atomic_node_ptr*>(const_cast<self_type*>(this) +
+                                              1)[level];
+  }
+
+  /** Number of node-sized units holding the node and its pointers, which
+      keeps the allocation aligned for both. */
+  static size_type NodeUnits(size_type height) {
+    return 1 + (height * sizeof(atomic_node_ptr) + sizeof(self_type) - 1) /
+                   sizeof(self_type);
+  }
+
+  union {
+    value_type value_;
+  };
+  size_type height_;
+};
+
+template <typename TContainer, typename TValue>
+class SkipListIterator {
+ private:
+  using node_ptr = typename TContainer::node_ptr;
+  template <typename TTraits>
+  friend class ConcurrentSkipList;
+  template <typename TM, typename TV>
+  friend class SkipListIterator;
+  template <typename TM, typename T, typename TU>
+  friend bool operator==(const SkipListIterator<TM, T>& i,
+                         const SkipListIterator<TM, TU>& j);
+  template <typename TM, typename T, typename TU>
+  friend bool operator!=(const SkipListIterator<TM, T>& i,
+                         const SkipListIterator<TM, TU>& j);
+
+ public:
+  using value_type = TValue;
+  using difference_type = typename TContainer::difference_type;
+  using pointer = value_type*;
+  using reference = value_type&;
+  using iterator_category = std::forward_iterator_tag;
+
+  SkipListIterator() : node_ptr_(nullptr) {}
+  SkipListIterator(
+      const SkipListIterator<TContainer, typename TContainer::value_type>&
+          other)
+      : node_ptr_(other.node_ptr_) {}
+
+  SkipListIterator& operator=(
+      const SkipListIterator<TContainer, typename TContainer::value_type>&
+          other) {
+    node_ptr_ = other.node_ptr_;
+    return *this;
+  }
+
+  reference operator*() const { return node_ptr_->Value(); }
+
+  pointer operator->() const { return node_ptr_->Storage(); }
+
+  SkipListIterator& operator++() {
+    node_ptr_ = node_ptr_->Next(0);
+    return *this;
+  }
+
+  SkipListIterator operator++(int) {
+    SkipListIterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+ private:
+  SkipListIterator(node_ptr pnode) : node_ptr_(pnode) {}
+
+  node_ptr NodePtr() const { return node_ptr_; }
+
+  node_ptr node_ptr_;
+};
+
+template <typename TContainer, typename T, typename TU>
+bool operator==(const SkipListIterator<TContainer, T>& i,
+                const SkipListIterator<TContainer, TU>& j) {
+  return i.node_ptr_ == j.node_ptr_;
+}
+
+template <typename TContainer, typename T, typename TU>
+bool operator!=(const SkipListIterator<TContainer, T>& i,
+                const SkipListIterator<TContainer, TU>& j) {
+  return i.node_ptr_ != j.node_ptr_;
+}
+
+/** Ordered container on a lock-free skip list. Insert, lookup and
+    iteration are safe to run concurrently: a node is published by a single
+    CAS on the bottom level, so a reader either sees it fully constructed or
+    not at all, and upper levels are only shortcuts for the search. Erase,
+    extract, Clear and assignment are not thread-safe. */
+template <typename TTraits>
+class ConcurrentSkipList {
+  using self_type = ConcurrentSkipList<TTraits>;
+  using traits_type = TTraits;
+
+ public:
+  using value_type = typename traits_type::value_type;
+  using key_type = typename traits_type::key_type;
+  using key_compare = typename traits_type::key_compare;
+  using value_compare = typename traits_type::value_compare;
+  using allocator_type = typename traits_type::allocator_type;
+
+ private:
+  using allocator_traits_type = std::allocator_traits<allocator_type>;
+
+  static_assert(
+      std::is_same<typename allocator_traits_type::value_type,
+                   value_type>::value,
+      "value_type of the container must be the same as its allocator");
+
+ public:
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = typename allocator_traits_type::pointer;
+  using const_pointer = typename allocator_traits_type::const_pointer;
+
+  using iterator = SkipListIterator<self_type, value_type>;
+  using const_iterator = SkipListIterator<self_type, const value_type>;
+
+ private:
+  template <typename TM, typename TV>
+  friend class SkipListIterator;
+
+  using node_type_impl = SkipListNode<value_type, allocator_type>;
+  using node_ptr = node_type_impl*;
+
+  static constexpr size_type kMaxLevel = traits_type::kMaxLevel;
+  using array_type = std::array<node_ptr, kMaxLevel>;
+
+  template <typename T>
+  using is_transparent = ws::concurrency::internal::containers::DependentBool<
+      ws::concurrency::internal::containers::CompIsTransparent<key_compare>,
+      T>;
+
+ public:
+  using node_type =
+      ws::concurrency::internal::NodeHandle<key_type, value_type,
+                                            node_type_impl, allocator_type>;
+
+  ConcurrentSkipList() : ConcurrentSkipList(key_compare()) {}
+
+  explicit ConcurrentSkipList(const key_compare& compare,
+                              const allocator_type& alloc = allocator_type())
+      : allocator_(alloc),
+        compare_(compare),
+        head_(nullptr),
+        size_(0),
+        max_height_(1) {}
+
+  explicit ConcurrentSkipList(const allocator_type& alloc)
+      : ConcurrentSkipList(key_compare(), alloc) {}
+
+  template <typename TInputIterator>
+  ConcurrentSkipList(TInputIterator first, TInputIterator last,
+                     const key_compare& compare = key_compare(),
+                     const allocator_type& alloc = allocator_type())
+      : ConcurrentSkipList(compare, alloc) {
+    Insert(first, last);
+  }
+
+  template <typename TInputIterator>
+  ConcurrentSkipList(TInputIterator first, TInputIterator last,
+                     const allocator_type& alloc)
+      : ConcurrentSkipList(first, last, key_compare(), alloc) {}
+
+  ConcurrentSkipList(std::initializer_list<value_type> init,
+                     const key_compare& compare = key_compare(),
+                     const allocator_type& alloc = allocator_type())
+      : ConcurrentSkipList(init.begin(), init.end(), compare, alloc) {}
+
+  ConcurrentSkipList(std::initializer_list<value_type> init,
+                     const allocator_type& alloc)
+      : ConcurrentSkipList(init, key_compare(), alloc) {}
+
+  ConcurrentSkipList(const ConcurrentSkipList& other)
+      : ConcurrentSkipList(other.compare_,
+                           allocator_traits_type::
+                               select_on_container_copy_construction(
+                                   other.get_allocator())) {
+    InternalCopy(other);
+  }
+
+  ConcurrentSkipList(const ConcurrentSkipList& other,
+                     const allocator_type& alloc)
+      : ConcurrentSkipList(other.compare_, alloc) {
+    InternalCopy(other);
+  }
+
+  ConcurrentSkipList(ConcurrentSkipList&& other)
+      : ConcurrentSkipList(other.compare_, std::move(other.allocator_)) {
+    InternalSteal(other);
+  }
+
+  ConcurrentSkipList(ConcurrentSkipList&& other, const allocator_type& alloc)
+      : ConcurrentSkipList(other.compare_, alloc) {
+    if (allocator_ == other.allocator_) {
+      InternalSteal(other);
+    } else {
+      InternalMoveElements(other);
+    }
+  }
+
+  ~ConcurrentSkipList() {
+    Clear();
+    DestroyHead();
+  }
+
+  ConcurrentSkipList& operator=(const ConcurrentSkipList& other) {
+    if (this != &other) {
+      Clear();
+      DestroyHead();
+      CopyAssignAllocators(allocator_, other.allocator_);
+      compare_ = other.compare_;
+      InternalCopy(other);
+    }
+    return *this;
+  }
+
+  ConcurrentSkipList& operator=(ConcurrentSkipList&& other) {
+    if (this != &other) {
+      Clear();
+      DestroyHead();
+      compare_ = other.compare_;
+      if (allocator_traits_type::propagate_on_container_move_assignment::
+              value ||
+          allocator_ == other.allocator_) {
+        MoveAssignAllocators(allocator_, other.allocator_);
+        InternalSteal(other);
+      } else {
+        InternalMoveElements(other);
+      }
+    }
+    return *this;
+  }
+
+  ConcurrentSkipList& operator=(std::initializer_list<value_type> init) {
+    Clear();
+    Insert(init);
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return allocator_; }
+
+  key_compare KeyComp() const { return compare_; }
+
+  value_compare ValueComp() const { return traits_type::ValueComp(compare_); }
+
+  [[nodiscard]] bool Empty() const { return Size() == 0; }
+
+  size_type Size() const { return size_.load(std::memory_order_relaxed); }
+
+  size_type MaxSize() const {
+    using node_allocator_type =
+        typename allocator_traits_type::template rebind_alloc<node_type_impl>;
+    return std::allocator_traits<node_allocator_type>::max_size(
+        node_allocator_type(allocator_));
+  }
+
+  iterator begin() { return iterator(FirstNode()); }
+
+  const_iterator begin() const { return const_iterator(FirstNode()); }
+
+  const_iterator cbegin() const { return const_iterator(FirstNode()); }
+
+  iterator end() { return iterator(nullptr); }
+
+  const_iterator end() const { return const_iterator(nullptr); }
+
+  const_iterator cend() const { return const_iterator(nullptr); }
+
+  std::pair<iterator, bool> Insert(const value_type& value) {
+    return Emplace(value);
+  }
+
+  std::pair<iterator, bool> Insert(value_type&& value) {
+    return Emplace(std::move(value));
+  }
+
+  iterator Insert(const_iterator, const value_type& value) {
+    return Insert(value).first;
+  }
+
+  iterator Insert(const_iterator, value_type&& value) {
+    return Insert(std::move(value)).first;
+  }
+
+  template <typename TInputIterator>
+  void Insert(TInputIterator first, TInputIterator last) {
+    for (; first != last; ++first) {
+      Emplace(*first);
+    }
+  }
+
+  void Insert(std::initializer_list<value_type> init) {
+    Insert(init.begin(), init.end());
+  }
+
+  std::pair<iterator, bool> Insert(node_type&& nh) {
+    if (!nh.Empty()) {
+      node_ptr insert_node =
+          ws::concurrency::internal::NodeHandleAccessor::GetNodePtr(nh);
+      for (size_type level = 0; level < insert_node->Height(); ++level) {
+        insert_node->SetNext(level, nullptr);
+      }
+      std::pair<node_ptr, bool> insert_result = InternalInsert(insert_node);
+      if (insert_result.second) {
+        ws::concurrency::internal::NodeHandleAccessor::Deactivate(nh);
+      }
+      return {iterator(insert_result.first), insert_result.second};
+    }
+    return {end(), false};
+  }
+
+  iterator Insert(const_iterator, node_type&& nh) {
+    return Insert(std::move(nh)).first;
+  }
+
+  template <typename... TArgs>
+  std::pair<iterator, bool> Emplace(TArgs&&... args) {
+    node_ptr insert_node = CreateNode(std::forward<TArgs>(args)...);
+    std::pair<node_ptr, bool> insert_result = InternalInsert(insert_node);
+    if (!insert_result.second) {
+      DestroyNode(insert_node);
+    }
+    return {iterator(insert_result.first), insert_result.second};
+  }
+
+  template <typename... TArgs>
+  iterator EmplaceHint(const_iterator, TArgs&&... args) {
+    return Emplace(std::forward<TArgs>(args)...).first;
+  }
+
+  iterator UnsafeErase(iterator pos) {
+    return UnsafeErase(const_iterator(pos));
+  }
+
+  iterator UnsafeErase(const_iterator pos) {
+    node_ptr next = pos.NodePtr()->Next(0);
+    DestroyNode(InternalExtract(pos.NodePtr()));
+    return iterator(next);
+  }
+
+  iterator UnsafeErase(const_iterator first, const_iterator last) {
+    while (first != last) {
+      first = UnsafeErase(first);
+    }
+    return iterator(first.NodePtr());
+  }
+
+  size_type UnsafeErase(const key_type& key) {
+    return InternalEraseByKey(key);
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value &&
+                              !std::is_convertible<TK, const_iterator>::value &&
+                              !std::is_convertible<TK, iterator>::value,
+                          size_type>::type
+  UnsafeErase(const TK& key) {
+    return InternalEraseByKey(key);
+  }
+
+  node_type UnsafeExtract(const_iterator pos) {
+    return ws::concurrency::internal::NodeHandleAccessor::Construct<node_type>(
+        InternalExtract(pos.NodePtr()));
+  }
+
+  node_type UnsafeExtract(iterator pos) {
+    return UnsafeExtract(const_iterator(pos));
+  }
+
+  node_type UnsafeExtract(const key_type& key) {
+    const_iterator item = Find(key);
+    return item == end() ? node_type() : UnsafeExtract(item);
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value &&
+                              !std::is_convertible<TK, const_iterator>::value &&
+                              !std::is_convertible<TK, iterator>::value,
+                          node_type>::type
+  UnsafeExtract(const TK& key) {
+    const_iterator item = Find(key);
+    return item == end() ? node_type() : UnsafeExtract(item);
+  }
+
+  void Clear() {
+    node_ptr head = head_.load(std::memory_order_relaxed);
+    if (head == nullptr) return;
+
+    node_ptr current = head->Next(0);
+    while (current != nullptr) {
+      node_ptr next = current->Next(0);
+      DestroyNode(current);
+      current = next;
+    }
+    for (size_type level = 0; level < head->Height(); ++level) {
+      head->SetNext(level, nullptr);
+    }
+    size_.store(0, std::memory_order_relaxed);
+    max_height_.store(1, std::memory_order_relaxed);
+  }
+
+  void Swap(ConcurrentSkipList& other) {
+    if (this != &other) {
+      using std::swap;
+      SwapAllocators(allocator_, other.allocator_);
+      swap(compare_, other.compare_);
+
+      node_ptr head = head_.load(std::memory_order_relaxed);
+      head_.store(other.head_.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+      other.head_.store(head, std::memory_order_relaxed);
+
+      size_type size = size_.load(std::memory_order_relaxed);
+      size_.store(other.size_.load(std::memory_order_relaxed),
+                  std::memory_order_relaxed);
+      other.size_.store(size, std::memory_order_relaxed);
+
+      size_type height = max_height_.load(std::memory_order_relaxed);
+      max_height_.store(other.max_height_.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+      other.max_height_.store(height, std::memory_order_relaxed);
+    }
+  }
+
+  iterator Find(const key_type& key) { return InternalFind<iterator>(key); }
+
+  const_iterator Find(const key_type& key) const {
+    return InternalFind<const_iterator>(key);
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, iterator>::type Find(
+      const TK& key) {
+    return InternalFind<iterator>(key);
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, const_iterator>::type
+  Find(const TK& key) const {
+    return InternalFind<const_iterator>(key);
+  }
+
+  size_type Count(const key_type& key) const { return InternalCount(key); }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, size_type>::type Count(
+      const TK& key) const {
+    return InternalCount(key);
+  }
+
+  bool Contains(const key_type& key) const { return Find(key) != end(); }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, bool>::type Contains(
+      const TK& key) const {
+    return Find(key) != end();
+  }
+
+  /** First element not ordered before key. Safe during concurrent inserts;
+      iterating from the result sees every element that was inserted
+      before the call, plus possibly some inserted during it. */
+  iterator LowerBound(const key_type& key) {
+    return iterator(InternalGetBound(key, compare_));
+  }
+
+  const_iterator LowerBound(const key_type& key) const {
+    return const_iterator(InternalGetBound(key, compare_));
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, iterator>::type
+  LowerBound(const TK& key) {
+    return iterator(InternalGetBound(key, compare_));
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, const_iterator>::type
+  LowerBound(const TK& key) const {
+    return const_iterator(InternalGetBound(key, compare_));
+  }
+
+  /** First element ordered after key. */
+  iterator UpperBound(const key_type& key) {
+    return iterator(InternalGetBound(key, NotGreaterCompare(compare_)));
+  }
+
+  const_iterator UpperBound(const key_type& key) const {
+    return const_iterator(InternalGetBound(key, NotGreaterCompare(compare_)));
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, iterator>::type
+  UpperBound(const TK& key) {
+    return iterator(InternalGetBound(key, NotGreaterCompare(compare_)));
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value, const_iterator>::type
+  UpperBound(const TK& key) const {
+    return const_iterator(InternalGetBound(key, NotGreaterCompare(compare_)));
+  }
+
+  std::pair<iterator, iterator> EqualRange(const key_type& key) {
+    return InternalEqualRange<iterator>(key);
+  }
+
+  std::pair<const_iterator, const_iterator> EqualRange(
+      const key_type& key) const {
+    return InternalEqualRange<const_iterator>(key);
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value,
+                          std::pair<iterator, iterator>>::type
+  EqualRange(const TK& key) {
+    return InternalEqualRange<iterator>(key);
+  }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value,
+                          std::pair<const_iterator, const_iterator>>::type
+  EqualRange(const TK& key) const {
+    return InternalEqualRange<const_iterator>(key);
+  }
+
+ protected:
+  /** Moves every node of source whose key is not yet present here (all of
+      them for multi-containers). Not thread-safe for source. */
+  template <typename TSourceType>
+  void InternalMerge(TSourceType&& source) {
+    static_assert(
+        std::is_same<node_type,
+                     typename std::decay<TSourceType>::type::node_type>::value,
+        "Incompatible containers cannot be merged");
+
+    for (auto it = source.begin(); it != source.end();) {
+      auto where = it++;
+      if (traits_type::kAllowMultimapping ||
+          !Contains(traits_type::GetKey(*where))) {
+        node_type handle = source.UnsafeExtract(where);
+        auto insert_result = Insert(std::move(handle));
+        assert(insert_result.second && "Merged node must be inserted");
+        (void)insert_result;
+      }
+    }
+  }
+
+ private:
+  /** Orders a node after every element with an equal key. */
+  template <typename TCompare>
+  class NotGreaterCompareImpl {
+   public:
+    explicit NotGreaterCompareImpl(const TCompare& compare)
+        : compare_(compare) {}
+
+    template <typename TK1, typename TK2>
+    bool operator()(const TK1& first, const TK2& second) const {
+      return !compare_(second, first);
+    }
+
+   private:
+    const TCompare& compare_;
+  };
+
+  static NotGreaterCompareImpl<key_compare> NotGreaterCompare(
+      const key_compare& compare) {
+    return NotGreaterCompareImpl<key_compare>(compare);
+  }
+
+  static const key_type& GetKey(node_ptr node) {
+    return traits_type::GetKey(node->Value());
+  }
+
+  node_ptr FirstNode() const {
+    node_ptr head = head_.load(std::memory_order_acquire);
+    return head == nullptr ? nullptr : head->Next(0);
+  }
+
+  /** Advances prev along level while its successor is ordered before key
+      and returns that successor. */
+  template <typename TK, typename TCompare>
+  static node_ptr InternalFindPosition(size_type level, node_ptr& prev,
+                                       const TK& key, const TCompare& cmp) {
+    node_ptr curr = prev->Next(level);
+    while (curr != nullptr && cmp(GetKey(curr), key)) {
+      prev = curr;
+      curr = prev->Next(level);
+    }
+    return curr;
+  }
+
+  template <typename TK, typename TCompare>
+  node_ptr InternalGetBound(const TK& key, const TCompare& cmp) const {
+    node_ptr prev = head_.load(std::memory_order_acquire);
+    if (prev == nullptr) return nullptr;
+
+    node_ptr curr = nullptr;
+    for (size_type level = max_height_.load(std::memory_order_acquire);
+         level > 0; --level) {
+      curr = InternalFindPosition(level - 1, prev, key, cmp);
+    }
+    return curr;
+  }
+
+  template <typename TIterator, typename TK>
+  TIterator InternalFind(const TK& key) const {
+    node_ptr node = InternalGetBound(key, compare_);
+    return node != nullptr && !compare_(key, GetKey(node)) ? TIterator(node)
+                                                           : TIterator(nullptr);
+  }
+
+  template <typename TK>
+  size_type InternalCount(const TK& key) const {
+    if (traits_type::kAllowMultimapping) {
+      auto range = InternalEqualRange<const_iterator>(key);
+      return std::distance(range.first, range.second);
+    }
+    return InternalFind<const_iterator>(key) != end() ? 1 : 0;
+  }
+
+  template <typename TIterator, typename TK>
+  std::pair<TIterator, TIterator> InternalEqualRange(const TK& key) const {
+    node_ptr first = InternalGetBound(key, compare_);
+    if (first == nullptr || compare_(key, GetKey(first))) {
+      return {TIterator(first), TIterator(first)};
+    }
+    if (!traits_type::kAllowMultimapping) {
+      return {TIterator(first), TIterator(first->Next(0))};
+    }
+    return {TIterator(first),
+            TIterator(InternalGetBound(key, NotGreaterCompare(compare_)))};
+  }
+
+  /** Links an unlinked node, or returns the node holding its key when the
+      container does not allow duplicates. */
+  std::pair<node_ptr, bool> InternalInsert(node_ptr new_node) {
+    const key_type& key = GetKey(new_node);
+    if (traits_type::kAllowMultimapping) {
+      return InternalInsertNode(new_node, key, NotGreaterCompare(compare_));
+    }
+    return InternalInsertNode(new_node, key, compare_);
+  }
+
+  template <typename TCompare>
+  std::pair<node_ptr, bool> InternalInsertNode(node_ptr new_node,
+                                               const key_type& key,
+                                               const TCompare& cmp) {
+    node_ptr head = GetOrCreateHead();
+    const size_type height = new_node->Height();
+    array_type prev_nodes;
+    array_type curr_nodes;
+
+    const size_type max_height = max_height_.load(std::memory_order_acquire);
+    node_ptr prev = head;
+    for (size_type level = std::max(max_height, height); level > 0; --level) {
+      curr_nodes[level - 1] = InternalFindPosition(level - 1, prev, key, cmp);
+      prev_nodes[level - 1] = prev;
+    }
+
+    // The bottom level decides whether and where the node lands; once the
+    // CAS succeeds it is visible to readers.
+    for (;;) {
+      node_ptr curr = curr_nodes[0];
+      if (!traits_type::kAllowMultimapping && curr != nullptr &&
+          !compare_(key, GetKey(curr))) {
+        return {curr, false};
+      }
+      new_node->SetNext(0, curr);
+      if (prev_nodes[0]->TryInsertNext(0, curr, new_node)) break;
+      curr_nodes[0] = InternalFindPosition(0, prev_nodes[0], key, cmp);
+    }
+
+    for (size_type level = 1; level < height; ++level) {
+      for (;;) {
+        node_ptr curr = curr_nodes[level];
+        new_node->SetNext(level, curr);
+        if (prev_nodes[level]->TryInsertNext(level, curr, new_node)) break;
+        curr_nodes[level] =
+            InternalFindPosition(level, prev_nodes[level], key, cmp);
+      }
+    }
+
+    size_type current_height = max_height;
+    while (current_height < height &&
+           !max_height_.compare_exchange_weak(current_height, height,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+    }
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return {new_node, true};
+  }
+
+  /** Unlinks node from every level it is part of and returns it. */
+  node_ptr InternalExtract(node_ptr node) {
+    node_ptr head = head_.load(std::memory_order_relaxed);
+    const key_type& key = GetKey(node);
+    node_ptr prev = head;
+    for (size_type level = max_height_.load(std::memory_order_relaxed);
+         level > 0; --level) {
+      InternalFindPosition(level - 1, prev, key, compare_);
+      if (level - 1 < node->Height()) {
+        // Equal keys may precede the node, so walk to its predecessor
+        // without moving prev for the levels below.
+        node_ptr predecessor = prev;
+        while (predecessor->Next(level - 1) != node) {
+          predecessor = predecessor->Next(level - 1);
+        }
+        predecessor->SetNext(level - 1, node->Next(level - 1));
+      }
+    }
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    return node;
+  }
+
+  template <typename TK>
+  size_type InternalEraseByKey(const TK& key) {
+    auto range = EqualRange(key);
+    size_type count = 0;
+    while (range.first != range.second) {
+      range.first = UnsafeErase(range.first);
+      ++count;
+    }
+    return count;
+  }
+
+  /** Appends the elements of other, which are already in order, by
+      tracking the last node of each level instead of searching. */
+  void InternalCopy(const ConcurrentSkipList& other) {
+    if (other.Empty()) return;
+
+    node_ptr head = GetOrCreateHead();
+    array_type tails;
+    tails.fill(head);
+    size_type max_height = 1;
+    size_type count = 0;
+    for (auto it = other.begin(); it != other.end(); ++it) {
+      node_ptr node = CreateNode(*it);
+      for (size_type level = 0; level < node->Height(); ++level) {
+        tails[level]->SetNext(level, node);
+        tails[level] = node;
+      }
+      max_height = std::max(max_height, node->Height());
+      ++count;
+    }
+    max_height_.store(max_height, std::memory_order_relaxed);
+    size_.store(count, std::memory_order_relaxed);
+  }
+
+  void InternalMoveElements(ConcurrentSkipList& other) {
+    for (auto it = other.begin(); it != other.end(); ++it) {
+      Emplace(std::move(*it));
+    }
+    other.Clear();
+  }
+
+  void InternalSteal(ConcurrentSkipList& other) {
+    head_.store(other.head_.exchange(nullptr, std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    size_.store(other.size_.exchange(0, std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    max_height_.store(other.max_height_.exchange(1, std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+  }
+
+  /** The head is created by the first insert, so that empty and moved-from
+      containers allocate nothing. */
+  node_ptr GetOrCreateHead() {
+    node_ptr head = head_.load(std::memory_order_acquire);
+    if (head != nullptr) return head;
+
+    node_ptr new_head = node_type_impl::Allocate(allocator_, kMaxLevel);
+    if (head_.compare_exchange_strong(head, new_head,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+      return new_head;
+    }
+    node_type_impl::Deallocate(allocator_, new_head);
+    return head;
+  }
+
+  void DestroyHead() {
+    node_ptr head = head_.exchange(nullptr, std::memory_order_relaxed);
+    if (head != nullptr) {
+      node_type_impl::Deallocate(allocator_, head);
+    }
+  }
+
+  template <typename... TArgs>
+  node_ptr CreateNode(TArgs&&... args) {
+    node_ptr node = node_type_impl::Allocate(allocator_, RandomLevel());
+    ws::concurrency::internal::templates::TryCall([&] {
+      allocator_traits_type::construct(allocator_, node->Storage(),
+                                       std::forward<TArgs>(args)...);
+    }).OnException([&] { node_type_impl::Deallocate(allocator_, node); });
+    return node;
+  }
+
+  void DestroyNode(node_ptr node) {
+    allocator_traits_type::destroy(allocator_, node->Storage());
+    node_type_impl::Deallocate(allocator_, node);
+  }
+
+  /** Geometric height with p = 1/2, drawn from a per-thread xorshift so
+      that concurrent inserts share no generator state. */
+  static size_type RandomLevel() {
+    static thread_local std::uint32_t state =
+        static_cast<std::uint32_t>(
+            ws::concurrency::internal::ThisThreadOrdinal() * 0x9E3779B9u) |
+        1u;
+    std::uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state = x;
+    return std::min<size_type>(std::countr_one(x) + 1, kMaxLevel);
+  }
+
+  allocator_type allocator_;
+  key_compare compare_;
+  std::atomic<node_ptr> head_;
+  std::atomic<size_type> size_;
+  std::atomic<size_type> max_height_;
+
+  template <typename TOtherTraits>
+  friend class ConcurrentSkipList;
+};
+
+template <typename TTraits>
+bool operator==(const ConcurrentSkipList<TTraits>& lhs,
+                const ConcurrentSkipList<TTraits>& rhs) {
+  if (&lhs == &rhs) {
+    return true;
+  }
+
+  if (lhs.Size() != rhs.Size()) {
+    return false;
+  }
+
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+#if !_CPP20_COMPARISONS_PRESENT
+template <typename TTraits>
+bool operator!=(const ConcurrentSkipList<TTraits>& lhs,
+                const ConcurrentSkipList<TTraits>& rhs) {
+  return !(lhs == rhs);
+}
+#endif
+
+}  // namespace internal
+}  // namespace concurrency
+}  // namespace ws
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
@@ -12,6 +13,8 @@
 #include <utility>
 
 #include "ws/concurrency/internal/allocator_traits.h"
+#include "ws/concurrency/internal/container_snapshot.h"
+#include "ws/concurrency/internal/epoch_reclamation.h"
 #include "ws/concurrency/internal/hash_compare.h"
 #include "ws/concurrency/internal/helpers.h"
 #include "ws/concurrency/internal/node_handle.h"
@@ -71,7 +74,7 @@ class SolistIterator {
 
   SolistIterator& operator++() {
     auto next_node = node_ptr_->Next();
-    while (next_node && next_node->IsDummy()) {
+    while (next_node && (next_node->IsDummy() || next_node->IsErased())) {
       next_node = next_node->Next();
     }
     node_ptr_ = static_cast<node_ptr>(next_node);
@@ -110,7 +113,7 @@ class ListNode {
   using node_ptr = ListNode*;
   using sokey_type = TSokeyType;
 
-  ListNode(sokey_type key) : next_(nullptr), order_key_(key) {}
+  ListNode(sokey_type key) : next_(0), order_key_(key) {}
 
   void Init(sokey_type key) { order_key_ = key; }
 
@@ -118,18 +121,42 @@ class ListNode {
 
   bool IsDummy() { return (order_key_ & 0x1) == 0; }
 
-  node_ptr Next() const { return next_.load(std::memory_order_acquire); }
+  node_ptr Next() const {
+    return reinterpret_cast<node_ptr>(next_.load(std::memory_order_acquire) &
+                                      ~kErasedMark);
+  }
 
   void SetNext(node_ptr next_node) {
-    next_.store(next_node, std::memory_order_release);
+    next_.store(reinterpret_cast<std::uintptr_t>(next_node),
+                std::memory_order_release);
   }
 
+  /** Fails if this node has been marked erased, so nothing can be linked
+      after a node that is being unlinked. */
   bool TrySetNext(node_ptr expected_next, node_ptr new_next) {
-    return next_.compare_exchange_strong(expected_next, new_next);
+    std::uintptr_t expected = reinterpret_cast<std::uintptr_t>(expected_next);
+    return next_.compare_exchange_strong(
+        expected, reinterpret_cast<std::uintptr_t>(new_next));
+  }
+
+  bool IsErased() const {
+    return (next_.load(std::memory_order_acquire) & kErasedMark) != 0;
+  }
+
+  /** Marks the node as logically erased, freezing its next pointer. Returns
+      false if another thread marked it first. */
+  bool TryMarkErased() {
+    std::uintptr_t next = next_.load(std::memory_order_acquire);
+    while ((next & kErasedMark) == 0) {
+      if (next_.compare_exchange_weak(next, next | kErasedMark)) return true;
+    }
+    return false;
   }
 
  private:
-  std::atomic<node_ptr> next_;
+  static constexpr std::uintptr_t kErasedMark = 0x1;
+
+  std::atomic<std::uintptr_t> next_;
   sokey_type order_key_;
 };
 
@@ -190,6 +217,8 @@ class ConcurrentUnorderedBase {
   using hasher = typename hash_compare_type::hasher;
   using key_equal = typename hash_compare_type::key_equal;
 
+  using epoch_guard_type = ws::concurrency::internal::EpochGuard;
+
  private:
   using list_node_type = ListNode<sokey_type>;
   using value_node_type = ValueNode<value_type, sokey_type>;
@@ -220,6 +249,8 @@ class ConcurrentUnorderedBase {
   using node_type =
       ws::concurrency::internal::NodeHandle<key_type, value_type,
                                             value_node_type, allocator_type>;
+  using snapshot_type =
+      ws::concurrency::internal::ContainerSnapshot<value_type, allocator_type>;
 
   explicit ConcurrentUnorderedBase(
       size_type bucket_count, const hasher& hash = hasher(),
@@ -381,6 +412,8 @@ class ConcurrentUnorderedBase {
   void Swap(ConcurrentUnorderedBase& other) noexcept(
       UnorderedSegmentTable::kIsNoExceptSwap) {
     if (this != &other) {
+      reclamation_.Drain();
+      other.reclamation_.Drain();
       using pocs_type =
           typename allocator_traits_type::propagate_on_container_swap;
       using is_always_equal = typename allocator_traits_type::is_always_equal;
@@ -545,6 +578,43 @@ class ConcurrentUnorderedBase {
     return item == end() ? node_type() : UnsafeExtract(item);
   }
 
+  /** Unlike UnsafeErase, may run concurrently with insertion, lookup and
+      other Erase calls. Erased nodes are retired to the container's epoch
+      domain and freed in batches once no pinned reader can reach them, so
+      iterators to an erased element stay valid only while the caller holds
+      a Pin() taken before the erase. */
+  size_type Erase(const key_type& key) { return InternalConcurrentErase(key); }
+
+  template <typename TK>
+  typename std::enable_if<is_transparent<TK>::value &&
+                              !std::is_convertible<TK, const_iterator>::value &&
+                              !std::is_convertible<TK, iterator>::value,
+                          size_type>::type
+  Erase(const TK& key) {
+    return InternalConcurrentErase(key);
+  }
+
+  /** Keeps every element reachable at the time of the call alive until the
+      guard is released, even if it is concurrently erased. Lookups and
+      insertions pin internally; hold a guard to use iterators safely while
+      other threads call Erase. */
+  epoch_guard_type Pin() const { return reclamation_.Pin(); }
+
+  /** Copies the elements into one contiguous, immutable array. The walk is
+      pinned and takes no locks, so it neither waits for nor delays
+      concurrent Insert and Erase; elements inserted or erased while it runs
+      may or may not be included. Copying is cheaper to iterate, serialize
+      or hand to another thread than walking the list node by node. */
+  snapshot_type Snapshot() const {
+    typename snapshot_type::storage_type items(get_allocator());
+    items.reserve(Size());
+    epoch_guard_type guard = Pin();
+    for (const_iterator it = begin(), last = end(); it != last; ++it) {
+      items.push_back(*it);
+    }
+    return snapshot_type(std::move(items));
+  }
+
   iterator Find(const key_type& key) {
     value_node_ptr result = InternalFind(key);
     return result == nullptr ? end() : iterator(result);
@@ -697,6 +767,12 @@ class ConcurrentUnorderedBase {
     }
   }
 
+  /** Bucket segments allocated from now on follow policy. Not
+      thread-safe. */
+  void SetNumaPolicy(NumaPolicy policy) { segments_.SetNumaPolicy(policy); }
+
+  NumaPolicy GetNumaPolicy() const { return segments_.GetNumaPolicy(); }
+
   hasher HashFunction() const { return hash_compare_.HashFunction(); }
 
   key_equal KeyEq() const { return hash_compare_.KeyEq(); }
@@ -854,8 +930,10 @@ class ConcurrentUnorderedBase {
         typename base_type::segment_index_type segment_index, size_type) {
       segment_allocator_type alloc(this->get_allocator());
       size_type seg_size = this->SegmentSize(segment_index);
-      segment_type new_segment =
-          segment_allocator_traits::allocate(alloc, seg_size);
+      segment_type new_segment = this->MapSegment(segment_index);
+      if (new_segment == nullptr) {
+        new_segment = segment_allocator_traits::allocate(alloc, seg_size);
+      }
       for (size_type i = 0; i != seg_size; ++i) {
         segment_allocator_traits::construct(alloc, new_segment + i, nullptr);
       }
@@ -879,8 +957,10 @@ class ConcurrentUnorderedBase {
       for (size_type i = 0; i != this->SegmentSize(index); ++i) {
         segment_allocator_traits::destroy(alloc, address + i);
       }
-      segment_allocator_traits::deallocate(alloc, address,
-                                           this->SegmentSize(index));
+      if (!this->UnmapSegment(address, index)) {
+        segment_allocator_traits::deallocate(alloc, address,
+                                             this->SegmentSize(index));
+      }
     }
 
     void CopySegment(size_type index, segment_type, segment_type to) {
@@ -930,6 +1010,7 @@ class ConcurrentUnorderedBase {
 
     size_.store(0, std::memory_order_relaxed);
     segments_.Clear();
+    reclamation_.Drain();
   }
 
   void DestroyNode(node_ptr node) {
@@ -987,13 +1068,15 @@ class ConcurrentUnorderedBase {
     static_assert(
         std::is_same<typename std::decay<TValueType>::type, value_type>::value,
         "Incorrect type in internal_insert");
+    epoch_guard_type guard = reclamation_.Pin();
     const key_type& key = traits_type::GetKey(value);
     sokey_type hash_key = sokey_type(hash_compare_(key));
 
     sokey_type order_key = SplitOrderKeyRegular(hash_key);
-    node_ptr prev = PrepareBucket(hash_key);
-    assert(prev != nullptr && "Invalid head node");
+    node_ptr bucket = PrepareBucket(hash_key);
+    assert(bucket != nullptr && "Invalid head node");
 
+    node_ptr prev = bucket;
     auto search_result = SearchAfter(prev, order_key, key);
 
     if (search_result.second) {
@@ -1004,6 +1087,7 @@ class ConcurrentUnorderedBase {
     node_ptr curr = search_result.first;
 
     while (!TryInsert(prev, new_node, curr)) {
+      prev = bucket;
       search_result = SearchAfter(prev, order_key, key);
       if (search_result.second) {
         return InternalInsertReturnType{new_node, search_result.first, false};
@@ -1017,20 +1101,17 @@ class ConcurrentUnorderedBase {
         nullptr, static_cast<value_node_ptr>(new_node), true};
   }
 
+  template <typename TK>
   std::pair<value_node_ptr, bool> SearchAfter(node_ptr& prev,
                                               sokey_type order_key,
-                                              const key_type& key) {
-    node_ptr curr = prev->Next();
-
-    while (curr != nullptr &&
-           (curr->OrderKey() < order_key ||
-            (curr->OrderKey() == order_key &&
-             !hash_compare_(traits_type::GetKey(
-                                static_cast<value_node_ptr>(curr)->Value()),
-                            key)))) {
-      prev = curr;
-      curr = curr->Next();
-    }
+                                              const TK& key) {
+    node_ptr curr = SearchFrom(prev, prev, [&](node_ptr node) {
+      return node->OrderKey() < order_key ||
+             (node->OrderKey() == order_key &&
+              !hash_compare_(traits_type::GetKey(
+                                 static_cast<value_node_ptr>(node)->Value()),
+                             key));
+    });
 
     if (curr != nullptr && curr->OrderKey() == order_key &&
         !kAllowMultimapping) {
@@ -1045,19 +1126,42 @@ class ConcurrentUnorderedBase {
     }
   }
 
+  /** Returns the first node, starting after start, for which before
+      returns false, and its predecessor in prev. Unlinks the erased nodes it
+      passes and restarts from start when a predecessor changes under it,
+      so start must be a node that is never erased. */
+  template <typename TBefore>
+  node_ptr SearchFrom(node_ptr start, node_ptr& prev, TBefore before) {
+    node_ptr curr;
+    do {
+      prev = start;
+      curr = prev->Next();
+      while (curr != nullptr) {
+        if (curr->IsErased()) {
+          node_ptr next = curr->Next();
+          if (!prev->TrySetNext(curr, next)) break;
+          curr = next;
+        } else if (before(curr)) {
+          prev = curr;
+          curr = curr->Next();
+        } else {
+          return curr;
+        }
+      }
+    } while (curr != nullptr);
+    return nullptr;
+  }
+
   node_ptr InsertDummyNode(node_ptr parent_dummy_node, sokey_type order_key) {
-    node_ptr prev_node = parent_dummy_node;
+    node_ptr prev_node;
 
     node_ptr dummy_node = CreateDummyNode(order_key);
     node_ptr next_node;
 
     do {
-      next_node = prev_node->Next();
-
-      while (next_node != nullptr && next_node->OrderKey() < order_key) {
-        prev_node = next_node;
-        next_node = next_node->Next();
-      }
+      next_node = SearchFrom(
+          parent_dummy_node, prev_node,
+          [order_key](node_ptr node) { return node->OrderKey() < order_key; });
 
       if (next_node != nullptr && next_node->OrderKey() == order_key) {
         DestroyNode(dummy_node);
@@ -1143,7 +1247,8 @@ class ConcurrentUnorderedBase {
   }
 
   value_node_ptr FirstValueNode(node_ptr first_node) const {
-    while (first_node != nullptr && first_node->IsDummy()) {
+    while (first_node != nullptr &&
+           (first_node->IsDummy() || first_node->IsErased())) {
       first_node = first_node->Next();
     }
     return static_cast<value_node_ptr>(first_node);
@@ -1169,6 +1274,44 @@ class ConcurrentUnorderedBase {
     return erased_count;
   }
 
+  template <typename TK>
+  size_type InternalConcurrentErase(const TK& key) {
+    epoch_guard_type guard = reclamation_.Pin();
+    sokey_type hash_key = sokey_type(hash_compare_(key));
+    sokey_type order_key = SplitOrderKeyRegular(hash_key);
+    node_ptr bucket = PrepareBucket(hash_key);
+
+    size_type erased_count = 0;
+    for (;;) {
+      node_ptr prev = bucket;
+      value_node_ptr curr = SearchAfter(prev, order_key, key).first;
+      // curr may be a dummy node, so read the order key through node_ptr.
+      if (curr == nullptr ||
+          static_cast<node_ptr>(curr)->OrderKey() != order_key) {
+        break;
+      }
+      if (!curr->TryMarkErased()) continue;
+
+      size_.fetch_sub(1, std::memory_order_relaxed);
+      if (!prev->TrySetNext(curr, curr->Next())) {
+        // Searching from the bucket unlinks every erased node on the way.
+        prev = bucket;
+        SearchAfter(prev, order_key, key);
+      }
+
+      reclamation_.Retire(guard, static_cast<node_ptr>(curr), this,
+                          &DestroyRetiredNode);
+      ++erased_count;
+      if (!kAllowMultimapping) break;
+    }
+    return erased_count;
+  }
+
+  static void DestroyRetiredNode(void* container, void* node) {
+    static_cast<self_type*>(container)->DestroyNode(
+        static_cast<node_ptr>(node));
+  }
+
   void InternalExtract(value_node_ptr node_to_extract) {
     const key_type& key = traits_type::GetKey(node_to_extract->Value());
     sokey_type hash_key = sokey_type(hash_compare_(key));
@@ -1256,6 +1399,7 @@ class ConcurrentUnorderedBase {
 
   template <typename TK>
   value_node_ptr InternalFind(const TK& key) {
+    epoch_guard_type guard = reclamation_.Pin();
     sokey_type hash_key = sokey_type(hash_compare_(key));
     sokey_type order_key = SplitOrderKeyRegular(hash_key);
 
@@ -1264,7 +1408,7 @@ class ConcurrentUnorderedBase {
     while (curr != nullptr) {
       if (curr->OrderKey() > order_key) {
         return nullptr;
-      } else if (curr->OrderKey() == order_key &&
+      } else if (curr->OrderKey() == order_key && !curr->IsErased() &&
                  hash_compare_(traits_type::GetKey(
                                    static_cast<value_node_ptr>(curr)->Value()),
                                key)) {
@@ -1278,6 +1422,7 @@ class ConcurrentUnorderedBase {
 
   template <typename TK>
   std::pair<value_node_ptr, value_node_ptr> InternalEqualRange(const TK& key) {
+    epoch_guard_type guard = reclamation_.Pin();
     sokey_type hash_key = sokey_type(hash_compare_(key));
     sokey_type order_key = SplitOrderKeyRegular(hash_key);
 
@@ -1286,7 +1431,7 @@ class ConcurrentUnorderedBase {
     while (curr != nullptr) {
       if (curr->OrderKey() > order_key) {
         return std::make_pair(nullptr, nullptr);
-      } else if (curr->OrderKey() == order_key &&
+      } else if (curr->OrderKey() == order_key && !curr->IsErased() &&
                  hash_compare_(traits_type::GetKey(
                                    static_cast<value_node_ptr>(curr)->Value()),
                                key)) {
@@ -1465,6 +1610,7 @@ class ConcurrentUnorderedBase {
 
   list_node_type head_;
   UnorderedSegmentTable segments_;
+  mutable ws::concurrency::internal::EpochDomain reclamation_;
 
   template <typename TContainer, typename Value>
   friend class SolistIterator;
@@ -1484,7 +1630,7 @@ bool operator==(const ConcurrentUnorderedBase<TTraits>& lhs,
     return false;
   }
 
-#if _MSC_VER
+#if defined(_MSC_VER)
   return std::is_permutation(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 #else
   return std::is_permutation(lhs.begin(), lhs.end(), rhs.begin());
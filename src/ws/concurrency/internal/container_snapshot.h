@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ws {
+namespace concurrency {
+namespace internal {
+/** Immutable copy of a concurrent container's elements in one contiguous
+    array. Copies share the array, so a snapshot is cheap to pass around
+    and stays valid after the container changes or is destroyed. */
+template <typename TValue, typename TAllocator>
+class ContainerSnapshot {
+ public:
+  using value_type = TValue;
+  using allocator_type = TAllocator;
+  using storage_type = std::vector<TValue, TAllocator>;
+  using size_type = typename storage_type::size_type;
+  using difference_type = typename storage_type::difference_type;
+  using const_reference = typename storage_type::const_reference;
+  using const_pointer = typename storage_type::const_pointer;
+  using const_iterator = typename storage_type::const_iterator;
+  using iterator = const_iterator;
+
+  ContainerSnapshot() = default;
+
+  explicit ContainerSnapshot(storage_type&& items)
+      : items_(std::make_shared<const storage_type>(std::move(items))) {}
+
+  const_iterator begin() const { return Items().begin(); }
+
+  const_iterator end() const { return Items().end(); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  const_reference operator[](size_type index) const { return Items()[index]; }
+
+  const_pointer Data() const { return Items().data(); }
+
+  size_type Size() const { return Items().size(); }
+
+  [[nodiscard]] bool Empty() const { return Items().empty(); }
+
+ private:
+  const storage_type& Items() const {
+    static const storage_type empty;
+    return items_ ? *items_ : empty;
+  }
+
+  std::shared_ptr<const storage_type> items_;
+};
+}  // namespace internal
+}  // namespace concurrency
+}  // namespace ws
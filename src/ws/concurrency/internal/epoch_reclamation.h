@@ -0,0 +1,368 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#define KEEP_WS_ORDER
+#include "ws/machine.h"
+#undef KEEP_WS_ORDER
+
+#include "ws/concurrency/internal/helpers.h"
+
+namespace ws {
+namespace concurrency {
+namespace internal {
+class EpochGuard;
+
+/** Epoch-based reclamation domain. Readers pin the domain for the duration
+    of a traversal; writers retire objects once they are unreachable, and a
+    retired object is freed after the global epoch has advanced twice past
+    the epoch it was retired in, at which point no pinned reader can still
+    hold it. Retired objects wait in limbo lists attached to the pin records
+    (three per record, rotated by epoch) and are freed in batches, so the
+    domain holds at most a few batches per record as long as no thread stays
+    pinned indefinitely. */
+class EpochDomain {
+ public:
+  using size_type = std::size_t;
+  using deleter_type = void (*)(void* context, void* object);
+
+  /** Retirements per record between attempts to advance the epoch. */
+  static constexpr size_type kRetireBatch = 64;
+
+  /** Records spread over by thread ordinal. A pin made while all of them
+      are in use takes a record from an overflow list instead, which grows
+      by one record whenever every record in it is in use too. */
+  static constexpr size_type kMaxRecords = 64;
+
+  EpochDomain();
+
+  EpochDomain(const EpochDomain&) = delete;
+  EpochDomain& operator=(const EpochDomain&) = delete;
+
+  /** Frees every object still in limbo. No thread may be pinned. */
+  ~EpochDomain();
+
+  /** Pins the calling thread. Pins nest; the returned guard must be
+      released on the thread that created it. */
+  EpochGuard Pin();
+
+  /** Schedules deleter(context, object) to run once no reader pinned before
+      this call can reach object. The caller must hold guard and must have
+      made object unreachable for new readers. */
+  void Retire(EpochGuard& guard, void* object, void* context,
+              deleter_type deleter);
+
+  /** Frees every object in limbo regardless of epochs. No thread may be
+      pinned. */
+  void Drain();
+
+ private:
+  friend class EpochGuard;
+
+  struct Retired {
+    void* object;
+    void* context;
+    deleter_type deleter;
+  };
+
+  struct Limbo {
+    std::uint64_t epoch = 0;
+    std::vector<Retired> items;
+  };
+
+  struct alignas(ws::internal::CacheLineSize()) Record {
+    std::atomic<std::uint64_t> announced{0};
+    std::atomic<bool> in_use{false};
+    size_type depth = 0;
+    size_type retired_count = 0;
+    size_type pending = 0;
+    Limbo limbo[3];
+    Record* next = nullptr;
+  };
+
+  struct ThreadCache {
+    std::uint64_t domain_id = 0;
+    Record* record = nullptr;
+    bool held = false;
+  };
+
+  static ThreadCache& CurrentCache();
+
+  static std::uint64_t NextDomainId();
+
+  static std::uint64_t Announcement(std::uint64_t epoch) {
+    return (epoch << 1) | 1;
+  }
+
+  Record* Enter();
+
+  void Exit(Record* record);
+
+  Record* Acquire(Record* hint);
+
+  Record* RecordAt(size_type index);
+
+  Record* AcquireOverflow();
+
+  /** Calls visit on every record created so far until it returns false. */
+  template <typename TVisit>
+  void ForEachRecord(TVisit&& visit);
+
+  static bool TryClaim(Record* record);
+
+  void TryAdvance();
+
+  void Collect(Record& record);
+
+  static void Free(Record& record, Limbo& limbo);
+
+  const std::uint64_t id_;
+  alignas(ws::internal::CacheLineSize()) std::atomic<std::uint64_t>
+      global_epoch_{0};
+  alignas(ws::internal::CacheLineSize()) std::atomic<Record*>
+      records_[kMaxRecords];
+  std::atomic<Record*> overflow_{nullptr};
+};
+
+/** Keeps an EpochDomain pinned until destroyed or released. */
+class EpochGuard {
+ public:
+  EpochGuard() = default;
+
+  EpochGuard(const EpochGuard&) = delete;
+  EpochGuard& operator=(const EpochGuard&) = delete;
+
+  EpochGuard(EpochGuard&& other) noexcept
+      : domain_(other.domain_), record_(other.record_) {
+    other.domain_ = nullptr;
+    other.record_ = nullptr;
+  }
+
+  EpochGuard& operator=(EpochGuard&& other) noexcept {
+    if (this != &other) {
+      Release();
+      domain_ = other.domain_;
+      record_ = other.record_;
+      other.domain_ = nullptr;
+      other.record_ = nullptr;
+    }
+    return *this;
+  }
+
+  ~EpochGuard() { Release(); }
+
+  void Release() {
+    if (domain_ != nullptr) {
+      domain_->Exit(record_);
+      domain_ = nullptr;
+      record_ = nullptr;
+    }
+  }
+
+  bool Pinned() const { return domain_ != nullptr; }
+
+ private:
+  friend class EpochDomain;
+
+  EpochGuard(EpochDomain* domain, EpochDomain::Record* record)
+      : domain_(domain), record_(record) {}
+
+  EpochDomain* domain_ = nullptr;
+  EpochDomain::Record* record_ = nullptr;
+};
+
+// ============================================================================
+// Implementation details for EpochDomain
+// ============================================================================
+
+inline EpochDomain::EpochDomain() : id_(NextDomainId()) {
+  for (auto& record : records_) {
+    record.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+inline EpochDomain::~EpochDomain() {
+  Drain();
+  for (auto& record : records_) {
+    delete record.load(std::memory_order_relaxed);
+  }
+  Record* record = overflow_.load(std::memory_order_relaxed);
+  while (record != nullptr) {
+    delete std::exchange(record, record->next);
+  }
+}
+
+inline EpochGuard EpochDomain::Pin() { return EpochGuard(this, Enter()); }
+
+inline void EpochDomain::Retire(EpochGuard& guard, void* object,
+                                void* context, deleter_type deleter) {
+  Record& record = *guard.record_;
+  const std::uint64_t epoch = global_epoch_.load(std::memory_order_acquire);
+
+  // A slot still tagged with an older epoch is at least three epochs old.
+  Limbo& limbo = record.limbo[epoch % 3];
+  if (limbo.epoch != epoch) {
+    Free(record, limbo);
+    limbo.epoch = epoch;
+  }
+
+  limbo.items.push_back(Retired{object, context, deleter});
+  ++record.pending;
+  if (++record.retired_count % kRetireBatch == 0) {
+    TryAdvance();
+    Collect(record);
+  }
+}
+
+inline void EpochDomain::Drain() {
+  ForEachRecord([](Record& record) {
+    for (Limbo& limbo : record.limbo) {
+      Free(record, limbo);
+    }
+    return true;
+  });
+}
+
+inline EpochDomain::ThreadCache& EpochDomain::CurrentCache() {
+  static thread_local ThreadCache cache;
+  return cache;
+}
+
+inline std::uint64_t EpochDomain::NextDomainId() {
+  static std::atomic<std::uint64_t> next_id{1};
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline EpochDomain::Record* EpochDomain::Enter() {
+  ThreadCache& cache = CurrentCache();
+  if (cache.held && cache.domain_id == id_) {
+    ++cache.record->depth;
+    return cache.record;
+  }
+
+  Record* record = Acquire(cache.domain_id == id_ ? cache.record : nullptr);
+  record->depth = 1;
+  record->announced.store(
+      Announcement(global_epoch_.load(std::memory_order_relaxed)),
+      std::memory_order_release);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (!cache.held) {
+    cache = ThreadCache{id_, record, true};
+  }
+  return record;
+}
+
+inline void EpochDomain::Exit(Record* record) {
+  if (--record->depth != 0) return;
+
+  record->announced.store(0, std::memory_order_release);
+  if (record->pending != 0) {
+    Collect(*record);
+  }
+  record->in_use.store(false, std::memory_order_release);
+
+  ThreadCache& cache = CurrentCache();
+  if (cache.domain_id == id_ && cache.record == record) {
+    cache.held = false;
+  }
+}
+
+inline EpochDomain::Record* EpochDomain::Acquire(Record* hint) {
+  if (hint != nullptr && TryClaim(hint)) return hint;
+
+  const size_type start = ThisThreadOrdinal() % kMaxRecords;
+  for (size_type i = 0; i < kMaxRecords; ++i) {
+    Record* record = RecordAt((start + i) % kMaxRecords);
+    if (TryClaim(record)) return record;
+  }
+  return AcquireOverflow();
+}
+
+inline EpochDomain::Record* EpochDomain::RecordAt(size_type index) {
+  Record* record = records_[index].load(std::memory_order_acquire);
+  if (record == nullptr) {
+    Record* new_record = new Record();
+    if (records_[index].compare_exchange_strong(record, new_record,
+                                                std::memory_order_acq_rel)) {
+      record = new_record;
+    } else {
+      delete new_record;
+    }
+  }
+  return record;
+}
+
+inline EpochDomain::Record* EpochDomain::AcquireOverflow() {
+  Record* head = overflow_.load(std::memory_order_acquire);
+  for (Record* record = head; record != nullptr; record = record->next) {
+    if (TryClaim(record)) return record;
+  }
+
+  // Records are never unlinked, so pushing needs no ABA protection.
+  Record* new_record = new Record();
+  new_record->in_use.store(true, std::memory_order_relaxed);
+  new_record->next = head;
+  while (!overflow_.compare_exchange_weak(new_record->next, new_record,
+                                          std::memory_order_acq_rel)) {
+  }
+  return new_record;
+}
+
+template <typename TVisit>
+inline void EpochDomain::ForEachRecord(TVisit&& visit) {
+  for (auto& slot : records_) {
+    Record* record = slot.load(std::memory_order_acquire);
+    if (record != nullptr && !visit(*record)) return;
+  }
+  for (Record* record = overflow_.load(std::memory_order_acquire);
+       record != nullptr; record = record->next) {
+    if (!visit(*record)) return;
+  }
+}
+
+inline bool EpochDomain::TryClaim(Record* record) {
+  return !record->in_use.load(std::memory_order_relaxed) &&
+         !record->in_use.exchange(true, std::memory_order_acquire);
+}
+
+inline void EpochDomain::TryAdvance() {
+  std::uint64_t epoch = global_epoch_.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  bool behind = false;
+  ForEachRecord([&](Record& record) {
+    const std::uint64_t announced =
+        record.announced.load(std::memory_order_acquire);
+    behind = announced != 0 && announced != Announcement(epoch);
+    return !behind;
+  });
+  if (behind) return;
+
+  global_epoch_.compare_exchange_strong(epoch, epoch + 1,
+                                        std::memory_order_acq_rel);
+}
+
+inline void EpochDomain::Collect(Record& record) {
+  const std::uint64_t epoch = global_epoch_.load(std::memory_order_acquire);
+  for (Limbo& limbo : record.limbo) {
+    if (limbo.epoch + 2 <= epoch) {
+      Free(record, limbo);
+    }
+  }
+}
+
+inline void EpochDomain::Free(Record& record, Limbo& limbo) {
+  for (const Retired& retired : limbo.items) {
+    retired.deleter(retired.context, retired.object);
+  }
+  record.pending -= limbo.items.size();
+  limbo.items.clear();
+}
+}  // namespace internal
+}  // namespace concurrency
+}  // namespace ws
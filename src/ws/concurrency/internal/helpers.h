@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+
 #define KEEP_WS_ORDER
 #include "ws/machine.h"
 #undef KEEP_WS_ORDER
@@ -218,6 +221,15 @@ T ReverseNBits(T src, std::size_t n) {
   return ReverseBits(src) >> (ws::internal::NumberOfBits<T>() - n);
 }
 
+/** Small dense number assigned to each thread on first use, for spreading
+    threads over per-thread slots. */
+inline std::size_t ThisThreadOrdinal() {
+  static std::atomic<std::size_t> next_ordinal{0};
+  static thread_local const std::size_t ordinal =
+      next_ordinal.fetch_add(1, std::memory_order_relaxed);
+  return ordinal;
+}
+
 }  // namespace internal
 }  // namespace concurrency
 }  // namespace ws
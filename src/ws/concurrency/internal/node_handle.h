@@ -69,9 +69,15 @@ class NodeHandleBase {
   void InternalDestroy() {
     if (node_ != nullptr) {
       allocator_traits_type::destroy(allocator_, node_->Storage());
-      typename allocator_traits_type::template rebind_alloc<node>
-          node_allocator(allocator_);
-      node_allocator.deallocate(node_, 1);
+      // Nodes with a variable size, such as skip list nodes, release
+      // themselves.
+      if constexpr (requires { node::Deallocate(allocator_, node_); }) {
+        node::Deallocate(allocator_, node_);
+      } else {
+        typename allocator_traits_type::template rebind_alloc<node>
+            node_allocator(allocator_);
+        node_allocator.deallocate(node_, 1);
+      }
     }
   }
 
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ws {
+namespace concurrency {
+namespace internal {
+
+/** NUMA node of the CPU the calling thread runs on, or -1 when unknown. */
+inline int CurrentNumaNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+  return -1;
+}
+
+/** Size of the pages that BindToNumaNode places, or 0 where placement is
+    not implemented. */
+inline std::size_t NumaPageSize() {
+#if defined(__linux__) && defined(SYS_mbind)
+  static const std::size_t page_size =
+      static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+#else
+  return 0;
+#endif
+}
+
+/** Maps bytes of zeroed, page-aligned memory that shares its pages with no
+    other allocation, or returns nullptr when the mapping fails or
+    NumaPageSize() is 0. Release it with UnmapNumaPages. */
+inline void* MapNumaPages(std::size_t bytes) {
+#if defined(__linux__) && defined(SYS_mbind)
+  void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return address == MAP_FAILED ? nullptr : address;
+#else
+  (void)bytes;
+  return nullptr;
+#endif
+}
+
+/** Releases memory from MapNumaPages together with its placement. */
+inline void UnmapNumaPages(void* address, std::size_t bytes) {
+#if defined(__linux__) && defined(SYS_mbind)
+  munmap(address, bytes);
+#else
+  (void)address;
+  (void)bytes;
+#endif
+}
+
+/** Asks the kernel to back the whole pages of [address, address + bytes)
+    with memory from node, migrating pages that are already resident. The
+    policy is a preference, so allocation still succeeds when the node is
+    full. Calls mbind directly to avoid a libnuma dependency; once the
+    kernel reports that NUMA placement is unsupported or not permitted,
+    later calls return false without a system call.
+
+    The policy belongs to the pages rather than to the allocation: it
+    outlives free(), applies to whatever the heap later puts there and
+    splits the surrounding mapping. Only bind memory from MapNumaPages. */
+inline bool BindToNumaNode(void* address, std::size_t bytes, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  static std::atomic<bool> unavailable{false};
+  constexpr int kBitsPerMask = sizeof(unsigned long) * 8;
+  if (node < 0 || node >= kBitsPerMask ||
+      unavailable.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  const std::uintptr_t page_size = NumaPageSize();
+  const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(address);
+  const std::uintptr_t begin = (first + page_size - 1) & ~(page_size - 1);
+  const std::uintptr_t end = (first + bytes) & ~(page_size - 1);
+  if (begin >= end) return false;
+
+  // Values from <numaif.h>, which is part of libnuma.
+  constexpr int kMpolPreferred = 1;
+  constexpr unsigned int kMpolMfMove = 1u << 1;
+  const unsigned long node_mask = 1ul << node;
+  // The kernel reads maxnode - 1 bits of the mask.
+  if (syscall(SYS_mbind, begin, end - begin, kMpolPreferred, &node_mask,
+              static_cast<unsigned long>(kBitsPerMask + 1),
+              kMpolMfMove) == 0) {
+    return true;
+  }
+  if (errno == ENOSYS || errno == EPERM) {
+    unavailable.store(true, std::memory_order_relaxed);
+  }
+#else
+  (void)address;
+  (void)bytes;
+  (void)node;
+#endif
+  return false;
+}
+
+}  // namespace internal
+}  // namespace concurrency
+}  // namespace ws
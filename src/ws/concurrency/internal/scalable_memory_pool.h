@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#define KEEP_WS_ORDER
+#include "ws/machine.h"
+#undef KEEP_WS_ORDER
+
+#include "ws/concurrency/spin_mutex.h"
+
+namespace ws {
+namespace concurrency {
+namespace internal {
+/** Process-wide pool of small blocks in fixed size classes. Each thread
+    keeps a magazine of free blocks per size class and allocates and frees
+    without synchronisation; magazines exchange whole batches with a shared
+    depot when they run empty or overflow, and the depot carves new blocks
+    from large chunks. Blocks may be freed on any thread. Memory is recycled
+    between threads but never returned to the system, so the footprint
+    follows the peak number of live blocks. Requests larger than
+    kMaxSmallSize or more aligned than kGranularity go to operator new. */
+class ScalableMemoryPool {
+ public:
+  using size_type = std::size_t;
+
+  static constexpr size_type kGranularity = 16;
+  static constexpr size_type kMaxSmallSize = 1024;
+  static constexpr size_type kNumClasses = kMaxSmallSize / kGranularity;
+  static constexpr size_type kBatchSize = 32;
+  static constexpr size_type kMagazineCapacity = 2 * kBatchSize;
+  static constexpr size_type kChunkSize = 256 * 1024;
+
+  static void* Allocate(size_type bytes, size_type alignment);
+
+  static void Deallocate(void* pointer, size_type bytes,
+                         size_type alignment) noexcept;
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+    FreeBlock* next_batch;
+  };
+
+  struct Magazine {
+    FreeBlock* head = nullptr;
+    size_type count = 0;
+  };
+
+  struct ThreadCache {
+    ~ThreadCache();
+
+    Magazine magazines[kNumClasses];
+  };
+
+  struct alignas(ws::internal::CacheLineSize()) Depot {
+    SpinMutex mutex;
+    FreeBlock* batches = nullptr;
+    char* chunk_cursor = nullptr;
+    char* chunk_end = nullptr;
+    void* chunks = nullptr;
+  };
+
+  static bool IsSmall(size_type bytes, size_type alignment) {
+    return bytes <= kMaxSmallSize && alignment <= kGranularity;
+  }
+
+  static size_type ClassIndex(size_type bytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / kGranularity;
+  }
+
+  static size_type ClassSize(size_type index) {
+    return (index + 1) * kGranularity;
+  }
+
+  /** Returns nullptr once the calling thread's cache has been destroyed,
+      e.g. when thread_local objects free memory during thread exit. */
+  static ThreadCache* CurrentCache();
+
+  static bool& CacheDestroyed();
+
+  static Depot& DepotAt(size_type index);
+
+  static void Refill(Magazine& magazine, size_type index);
+
+  static void Flush(Magazine& magazine, size_type index, size_type count);
+};
+
+// ============================================================================
+// Implementation details for ScalableMemoryPool
+// ============================================================================
+
+inline void* ScalableMemoryPool::Allocate(size_type bytes,
+                                          size_type alignment) {
+  if (!IsSmall(bytes, alignment)) {
+    return ::operator new(bytes, std::align_val_t(alignment));
+  }
+
+  const size_type index = ClassIndex(bytes);
+  ThreadCache* cache = CurrentCache();
+  if (cache == nullptr) {
+    Magazine magazine;
+    Refill(magazine, index);
+    FreeBlock* block = magazine.head;
+    magazine.head = block->next;
+    if (--magazine.count != 0) {
+      Flush(magazine, index, magazine.count);
+    }
+    return block;
+  }
+
+  Magazine& magazine = cache->magazines[index];
+  if (magazine.head == nullptr) {
+    Refill(magazine, index);
+  }
+
+  FreeBlock* block = magazine.head;
+  magazine.head = block->next;
+  --magazine.count;
+  return block;
+}
+
+inline void ScalableMemoryPool::Deallocate(void* pointer, size_type bytes,
+                                           size_type alignment) noexcept {
+  if (pointer == nullptr) return;
+  if (!IsSmall(bytes, alignment)) {
+    ::operator delete(pointer, std::align_val_t(alignment));
+    return;
+  }
+
+  const size_type index = ClassIndex(bytes);
+  FreeBlock* block = static_cast<FreeBlock*>(pointer);
+  ThreadCache* cache = CurrentCache();
+  if (cache == nullptr) {
+    block->next = nullptr;
+    Magazine magazine{block, 1};
+    Flush(magazine, index, 1);
+    return;
+  }
+
+  Magazine& magazine = cache->magazines[index];
+  block->next = magazine.head;
+  magazine.head = block;
+  if (++magazine.count == kMagazineCapacity) {
+    Flush(magazine, index, kBatchSize);
+  }
+}
+
+inline ScalableMemoryPool::ThreadCache::~ThreadCache() {
+  CacheDestroyed() = true;
+  for (size_type index = 0; index < kNumClasses; ++index) {
+    Magazine& magazine = magazines[index];
+    while (magazine.count != 0) {
+      Flush(magazine, index,
+            magazine.count < kBatchSize ? magazine.count : kBatchSize);
+    }
+  }
+}
+
+inline ScalableMemoryPool::ThreadCache* ScalableMemoryPool::CurrentCache() {
+  if (CacheDestroyed()) return nullptr;
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+inline bool& ScalableMemoryPool::CacheDestroyed() {
+  static thread_local bool destroyed = false;
+  return destroyed;
+}
+
+inline ScalableMemoryPool::Depot& ScalableMemoryPool::DepotAt(
+    size_type index) {
+  static Depot depots[kNumClasses];
+  return depots[index];
+}
+
+inline void ScalableMemoryPool::Refill(Magazine& magazine, size_type index) {
+  Depot& depot = DepotAt(index);
+  SpinMutex::ScopedLock lock(depot.mutex);
+
+  if (depot.batches != nullptr) {
+    FreeBlock* batch = depot.batches;
+    depot.batches = batch->next_batch;
+    size_type count = 0;
+    for (FreeBlock* block = batch; block != nullptr; block = block->next) {
+      ++count;
+    }
+    magazine.head = batch;
+    magazine.count = count;
+    return;
+  }
+
+  const size_type block_size = ClassSize(index);
+  if (static_cast<size_type>(depot.chunk_end - depot.chunk_cursor) <
+      kBatchSize * block_size) {
+    char* chunk = static_cast<char*>(
+        ws::internal::AlignedAllocate(kChunkSize, kGranularity));
+    if (chunk == nullptr) throw std::bad_alloc();
+
+    // The first block of every chunk links the chunks together.
+    *reinterpret_cast<void**>(chunk) = depot.chunks;
+    depot.chunks = chunk;
+    depot.chunk_cursor = chunk + kGranularity;
+    depot.chunk_end = chunk + kChunkSize;
+  }
+
+  FreeBlock* head = nullptr;
+  for (size_type i = 0; i < kBatchSize; ++i) {
+    depot.chunk_end -= block_size;
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(depot.chunk_end);
+    block->next = head;
+    head = block;
+  }
+  magazine.head = head;
+  magazine.count = kBatchSize;
+}
+
+inline void ScalableMemoryPool::Flush(Magazine& magazine, size_type index,
+                                      size_type count) {
+  FreeBlock* batch = magazine.head;
+  FreeBlock* last = batch;
+  for (size_type i = 1; i < count; ++i) {
+    last = last->next;
+  }
+  magazine.head = last->next;
+  magazine.count -= count;
+  last->next = nullptr;
+
+  Depot& depot = DepotAt(index);
+  SpinMutex::ScopedLock lock(depot.mutex);
+  batch->next_batch = depot.batches;
+  depot.batches = batch;
+}
+}  // namespace internal
+}  // namespace concurrency
+}  // namespace ws
@@ -8,10 +8,13 @@
 #include <cstring>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 #include "ws/concurrency/internal/allocator_traits.h"
 #include "ws/concurrency/internal/atomic_backoff.h"
 #include "ws/concurrency/internal/helpers.h"
+#include "ws/concurrency/internal/numa.h"
+#include "ws/concurrency/numa_policy.h"
 
 #if defined(_MSC_VER) && !defined(__INTEL_COMPILER)
 #pragma warning(push)
@@ -55,7 +58,9 @@ class SegmentTable {
         segment_table_(nullptr),
         first_block_{},
         size_{},
-        segment_table_allocation_failed_{} {
+        segment_table_allocation_failed_{},
+        mapped_segments_{},
+        numa_policy_(NumaPolicy::kDefault) {
     segment_table_.store(my_embedded_table_, std::memory_order_relaxed);
     ZeroTable(my_embedded_table_, kPointersPerEmbeddedTable);
   }
@@ -67,7 +72,9 @@ class SegmentTable {
         segment_table_(nullptr),
         first_block_{},
         size_{},
-        segment_table_allocation_failed_{} {
+        segment_table_allocation_failed_{},
+        mapped_segments_{},
+        numa_policy_(other.numa_policy_) {
     segment_table_.store(my_embedded_table_, std::memory_order_relaxed);
     ZeroTable(my_embedded_table_, kPointersPerEmbeddedTable);
     ws::concurrency::internal::templates::TryCall([&] {
@@ -80,7 +87,9 @@ class SegmentTable {
         segment_table_(nullptr),
         first_block_{},
         size_{},
-        segment_table_allocation_failed_{} {
+        segment_table_allocation_failed_{},
+        mapped_segments_{},
+        numa_policy_(other.numa_policy_) {
     segment_table_.store(my_embedded_table_, std::memory_order_relaxed);
     ZeroTable(my_embedded_table_, kPointersPerEmbeddedTable);
     TryCall([&] {
@@ -93,7 +102,9 @@ class SegmentTable {
         segment_table_(nullptr),
         first_block_{},
         size_{},
-        segment_table_allocation_failed_{} {
+        segment_table_allocation_failed_{},
+        mapped_segments_{},
+        numa_policy_(other.numa_policy_) {
     segment_table_.store(my_embedded_table_, std::memory_order_relaxed);
     ZeroTable(my_embedded_table_, kPointersPerEmbeddedTable);
     InternalMove(std::move(other));
@@ -104,7 +115,9 @@ class SegmentTable {
         segment_table_(nullptr),
         first_block_{},
         size_{},
-        segment_table_allocation_failed_{} {
+        segment_table_allocation_failed_{},
+        mapped_segments_{},
+        numa_policy_(other.numa_policy_) {
     segment_table_.store(my_embedded_table_, std::memory_order_relaxed);
     ZeroTable(my_embedded_table_, kPointersPerEmbeddedTable);
     using is_equal_type =
@@ -119,6 +132,7 @@ class SegmentTable {
     if (this != &other) {
       CopyAssignAllocators(segment_table_allocator_,
                            other.segment_table_allocator_);
+      numa_policy_ = other.numa_policy_;
       InternalTransfer(other, CopySegmentBodyType{*this});
     }
 
@@ -135,6 +149,7 @@ class SegmentTable {
     if (this != &other) {
       MoveAssignAllocators(segment_table_allocator_,
                            other.segment_table_allocator_);
+      numa_policy_ = other.numa_policy_;
       InternalMoveAssign(std::move(other),
                          std::disjunction<is_equal_type, pocma_type>());
     }
@@ -173,6 +188,11 @@ class SegmentTable {
     return segment_table_allocator_;
   }
 
+  /** Applies to segments allocated from now on. Not thread-safe. */
+  void SetNumaPolicy(NumaPolicy policy) { numa_policy_ = policy; }
+
+  NumaPolicy GetNumaPolicy() const { return numa_policy_; }
+
   void EnableSegment(segment_type& segment, segment_table_type table,
                      segment_index_type seg_index, size_type index) {
     segment_type new_segment = Self()->CreateSegment(table, seg_index, index);
@@ -403,6 +423,12 @@ class SegmentTable {
                                  std::memory_order_relaxed);
       ZeroTable(other.my_embedded_table_, kPointersPerEmbeddedTable);
     }
+    for (size_type i = 0; i != kPointersPerLongTable; ++i) {
+      mapped_segments_[i].store(
+          other.mapped_segments_[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+      other.mapped_segments_[i].store(nullptr, std::memory_order_relaxed);
+    }
     other.size_.store(0, std::memory_order_relaxed);
   }
 
@@ -490,6 +516,17 @@ class SegmentTable {
     other.size_.store(size_.load(std::memory_order_relaxed),
                       std::memory_order_relaxed);
     size_.store(size, std::memory_order_relaxed);
+
+    for (size_type i = 0; i != kPointersPerLongTable; ++i) {
+      segment_type mapped_segment =
+          other.mapped_segments_[i].load(std::memory_order_relaxed);
+      other.mapped_segments_[i].store(
+          mapped_segments_[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+      mapped_segments_[i].store(mapped_segment, std::memory_order_relaxed);
+    }
+
+    std::swap(numa_policy_, other.numa_policy_);
   }
 
  protected:
@@ -498,6 +535,50 @@ class SegmentTable {
   static constexpr size_type kEmbeddedTableSize =
       SegmentSize(kPointersPerEmbeddedTable);
 
+  /** Called by the derived CreateSegment before it falls back to its
+      allocator. Under NumaPolicy::kLocal, a segment of at least one page
+      gets a mapping of its own, bound to the calling thread's node before
+      the elements are constructed so that the first touch already happens
+      there. Binding allocator memory instead would leave the policy on
+      heap pages shared with unrelated allocations. Returns nullptr when
+      the segment should come from the allocator: placement is a hint, so
+      a failed mapping does not fail the allocation. */
+  segment_type MapSegment(segment_index_type seg_index) {
+    const size_type bytes = SegmentSize(seg_index) * sizeof(value_type);
+    const size_type page_size = NumaPageSize();
+    if (numa_policy_ != NumaPolicy::kLocal || page_size == 0 ||
+        bytes < page_size ||
+        mapped_segments_[seg_index].load(std::memory_order_relaxed) !=
+            nullptr) {
+      return nullptr;
+    }
+
+    segment_type pages = static_cast<segment_type>(MapNumaPages(bytes));
+    if (pages == nullptr) return nullptr;
+    // Threads racing in EnableSegment keep at most one mapping per index,
+    // so that UnmapSegment can tell it apart from allocator segments.
+    segment_type unmapped = nullptr;
+    if (!mapped_segments_[seg_index].compare_exchange_strong(
+            unmapped, pages, std::memory_order_relaxed)) {
+      UnmapNumaPages(pages, bytes);
+      return nullptr;
+    }
+    BindToNumaNode(pages, bytes, CurrentNumaNode());
+    return pages;
+  }
+
+  /** Called by the derived DestroySegment after destroying the elements.
+      Returns false when the segment belongs to the allocator. */
+  bool UnmapSegment(segment_type segment, segment_index_type seg_index) {
+    segment_type mapped = segment;
+    if (!mapped_segments_[seg_index].compare_exchange_strong(
+            mapped, nullptr, std::memory_order_relaxed)) {
+      return false;
+    }
+    UnmapNumaPages(segment, SegmentSize(seg_index) * sizeof(value_type));
+    return true;
+  }
+
   template <bool allow_out_of_range_access>
   value_type& InternalSubscript(size_type index) {
     segment_index_type seg_index = SegmentIndexOf(index);
@@ -551,6 +632,12 @@ class SegmentTable {
   std::atomic<size_type> size_;
 
   std::atomic<bool> segment_table_allocation_failed_;
+
+  /** The MapSegment mapping made for each segment index, if any. It may
+      belong to a segment that lost the race in EnableSegment. */
+  atomic_segment mapped_segments_[kPointersPerLongTable];
+
+  NumaPolicy numa_policy_;
 };
 
 }  // namespace internal
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#define KEEP_WS_ORDER
+#include "ws/machine.h"
+#undef KEEP_WS_ORDER
+
+#include "ws/concurrency/internal/atomic_backoff.h"
+
+namespace ws {
+namespace concurrency {
+namespace internal {
+/** Bounded Chase-Lev deque. The owning thread pushes and pops at the bottom
+    (LIFO); any other thread steals from the top (FIFO). Items are moved out
+    only after the slot has been claimed, and each slot carries a flag so the
+    owner never overwrites an item a thief is still moving out. */
+template <typename T>
+class WorkStealingDeque {
+  struct Slot {
+    std::atomic<bool> full{false};
+    T item{};
+  };
+
+ public:
+  using size_type = std::size_t;
+  using value_type = T;
+
+  explicit WorkStealingDeque(size_type capacity)
+      : capacity_(static_cast<std::int64_t>(capacity)),
+        mask_(capacity - 1),
+        slots_(std::make_unique<Slot[]>(capacity)) {
+    assert(ws::internal::IsPowerOfTwo(capacity) &&
+           "Capacity should be a power of two");
+  }
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  /** Owner only. Leaves item untouched and returns false when full. */
+  bool TryPush(T&& item) {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t >= capacity_) return false;
+
+    Slot& slot = SlotAt(b);
+    for (AtomicBackoff backoff; slot.full.load(std::memory_order_acquire);
+         backoff.Wait()) {
+    }
+    slot.item = std::move(item);
+    slot.full.store(true, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** Owner only. Takes the most recently pushed item. */
+  bool TryPop(T& result) {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(b, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_release);
+      return false;
+    }
+
+    if (t == b) {
+      const bool won = top_.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_release);
+      if (!won) return false;
+    }
+
+    Take(SlotAt(b), result);
+    return true;
+  }
+
+  /** Any thread. Takes the oldest item. Fails spuriously under contention. */
+  bool TrySteal(T& result) {
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) return false;
+
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+
+    Take(SlotAt(t), result);
+    return true;
+  }
+
+  [[nodiscard]] bool Empty() const {
+    return bottom_.load(std::memory_order_relaxed) -
+               top_.load(std::memory_order_relaxed) <=
+           0;
+  }
+
+  size_type Capacity() const { return static_cast<size_type>(capacity_); }
+
+ private:
+  Slot& SlotAt(std::int64_t index) {
+    return slots_[static_cast<size_type>(index) & mask_];
+  }
+
+  static void Take(Slot& slot, T& result) {
+    result = std::move(slot.item);
+    slot.full.store(false, std::memory_order_release);
+  }
+
+  alignas(ws::internal::CacheLineSize()) std::atomic<std::int64_t> top_{0};
+  alignas(ws::internal::CacheLineSize()) std::atomic<std::int64_t> bottom_{0};
+  const std::int64_t capacity_;
+  const size_type mask_;
+  std::unique_ptr<Slot[]> slots_;
+};
+}  // namespace internal
+}  // namespace concurrency
+}  // namespace ws
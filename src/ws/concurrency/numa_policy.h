@@ -0,0 +1,17 @@
+#pragma once
+
+namespace ws {
+namespace concurrency {
+/** Where containers built on SegmentTable place newly allocated segments
+    on machines with several NUMA nodes. */
+enum class NumaPolicy {
+  /** Leave placement to the allocator and the OS first-touch rule. */
+  kDefault,
+  /** Prefer memory on the NUMA node of the thread that allocates the
+      segment. Segments of at least one page are mapped directly from the
+      OS rather than taken from the allocator. Falls back to kDefault where
+      NUMA placement is unavailable. */
+  kLocal,
+};
+}  // namespace concurrency
+}  // namespace ws
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include "ws/concurrency/internal/scalable_memory_pool.h"
+
+namespace ws {
+namespace concurrency {
+/** Stateless allocator backed by ScalableMemoryPool. Small allocations are
+    served from per-thread magazines of fixed size classes, so container
+    nodes and queue pages allocated under contention avoid the global heap
+    lock. Suitable as the TAllocator argument of the concurrent containers;
+    all instances compare equal. */
+template <typename T>
+class ScalableAllocator {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using propagate_on_container_move_assignment = std::true_type;
+  using is_always_equal = std::true_type;
+
+  ScalableAllocator() noexcept = default;
+
+  template <typename TU>
+  ScalableAllocator(const ScalableAllocator<TU>&) noexcept {}
+
+  T* allocate(size_type n) {
+    if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T*>(
+        ws::concurrency::internal::ScalableMemoryPool::Allocate(n * sizeof(T),
+                                                                alignof(T)));
+  }
+
+  void deallocate(T* p, size_type n) noexcept {
+    ws::concurrency::internal::ScalableMemoryPool::Deallocate(
+        p, n * sizeof(T), alignof(T));
+  }
+};
+
+template <typename T, typename TU>
+bool operator==(const ScalableAllocator<T>&, const ScalableAllocator<TU>&) {
+  return true;
+}
+
+template <typename T, typename TU>
+bool operator!=(const ScalableAllocator<T>&, const ScalableAllocator<TU>&) {
+  return false;
+}
+}  // namespace concurrency
+}  // namespace ws
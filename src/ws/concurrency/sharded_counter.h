@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "ws/concurrency/internal/helpers.h"
+#include "ws/machine.h"
+
+namespace ws {
+namespace concurrency {
+/** Counter for hot paths. Each thread adds into its own cache-line-sized
+    slot, so concurrent increments do not contend on a shared line; Load
+    sums the slots and is therefore only a snapshot while writers are
+    active. */
+class ShardedCounter {
+ public:
+  using size_type = std::size_t;
+  using value_type = std::int64_t;
+
+  /** num_shards is rounded up to a power of two. */
+  explicit ShardedCounter(size_type num_shards = DefaultShards())
+      : mask_(RoundUpToPowerOfTwo(num_shards) - 1),
+        slots_(std::make_unique<Slot[]>(mask_ + 1)) {}
+
+  ShardedCounter(const ShardedCounter&) = delete;
+  ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+  void Add(value_type delta) {
+    slots_[ws::concurrency::internal::ThisThreadOrdinal() & mask_]
+        .value.fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  void Increment() { Add(1); }
+
+  value_type Load() const {
+    value_type total = 0;
+    for (size_type i = 0; i <= mask_; ++i) {
+      total += slots_[i].value.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  /** Increments racing with Reset may survive it. */
+  void Reset() {
+    for (size_type i = 0; i <= mask_; ++i) {
+      slots_[i].value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  size_type NumShards() const { return mask_ + 1; }
+
+  static size_type DefaultShards() {
+    const unsigned concurrency = std::thread::hardware_concurrency();
+    return concurrency == 0 ? 1 : concurrency;
+  }
+
+ private:
+  struct alignas(ws::internal::CacheLineSize()) Slot {
+    std::atomic<value_type> value{0};
+  };
+
+  static size_type RoundUpToPowerOfTwo(size_type n) {
+    size_type result = 1;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  const size_type mask_;
+  std::unique_ptr<Slot[]> slots_;
+};
+}  // namespace concurrency
+}  // namespace ws
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "ws/concurrency/internal/helpers.h"
+#include "ws/concurrency/sharded_counter.h"
+#include "ws/machine.h"
+
+namespace ws {
+namespace concurrency {
+/** Histogram of non-negative samples with power-of-two buckets: bucket 0
+    holds zeros and bucket b holds values in [2^(b-1), 2^b). Like
+    ShardedCounter, each thread records into its own cache-line-aligned
+    shard and Load merges the shards. */
+class ShardedHistogram {
+ public:
+  using size_type = std::size_t;
+  using value_type = std::uint64_t;
+
+  static constexpr size_type kNumBuckets =
+      std::numeric_limits<value_type>::digits + 1;
+
+  struct Snapshot {
+    value_type count = 0;
+    value_type sum = 0;
+    std::array<value_type, kNumBuckets> buckets{};
+
+    double Mean() const {
+      return count == 0 ? 0.0 : static_cast<double>(sum) / count;
+    }
+
+    /** Upper bound of the bucket holding the q-th quantile, q in [0, 1]. */
+    value_type Quantile(double q) const {
+      if (count == 0) return 0;
+      const value_type rank =
+          q <= 0 ? 1
+                 : static_cast<value_type>(q * static_cast<double>(count) +
+                                           0.5);
+      value_type seen = 0;
+      for (size_type b = 0; b < kNumBuckets; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) return BucketUpperBound(b);
+      }
+      return BucketUpperBound(kNumBuckets - 1);
+    }
+  };
+
+  /** num_shards is rounded up to a power of two. */
+  explicit ShardedHistogram(
+      size_type num_shards = ShardedCounter::DefaultShards())
+      : mask_(RoundUpToPowerOfTwo(num_shards) - 1),
+        shards_(std::make_unique<Shard[]>(mask_ + 1)) {}
+
+  ShardedHistogram(const ShardedHistogram&) = delete;
+  ShardedHistogram& operator=(const ShardedHistogram&) = delete;
+
+  void Record(value_type value) {
+    Shard& shard =
+        shards_[ws::concurrency::internal::ThisThreadOrdinal() & mask_];
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    shard.buckets[std::bit_width(value)].fetch_add(1,
+                                                   std::memory_order_relaxed);
+  }
+
+  Snapshot Load() const {
+    Snapshot snapshot;
+    for (size_type i = 0; i <= mask_; ++i) {
+      const Shard& shard = shards_[i];
+      snapshot.count += shard.count.load(std::memory_order_relaxed);
+      snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+      for (size_type b = 0; b < kNumBuckets; ++b) {
+        snapshot.buckets[b] += shard.buckets[b].load(std::memory_order_relaxed);
+      }
+    }
+    return snapshot;
+  }
+
+  /** Samples racing with Reset may survive it. */
+  void Reset() {
+    for (size_type i = 0; i <= mask_; ++i) {
+      Shard& shard = shards_[i];
+      shard.count.store(0, std::memory_order_relaxed);
+      shard.sum.store(0, std::memory_order_relaxed);
+      for (auto& bucket : shard.buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  size_type NumShards() const { return mask_ + 1; }
+
+  static value_type BucketUpperBound(size_type bucket) {
+    if (bucket == 0) return 0;
+    if (bucket >= kNumBuckets - 1) {
+      return std::numeric_limits<value_type>::max();
+    }
+    return (value_type(1) << bucket) - 1;
+  }
+
+ private:
+  struct alignas(ws::internal::CacheLineSize()) Shard {
+    std::atomic<value_type> count{0};
+    std::atomic<value_type> sum{0};
+    std::atomic<value_type> buckets[kNumBuckets] = {};
+  };
+
+  static size_type RoundUpToPowerOfTwo(size_type n) {
+    size_type result = 1;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  const size_type mask_;
+  std::unique_ptr<Shard[]> shards_;
+};
+}  // namespace concurrency
+}  // namespace ws
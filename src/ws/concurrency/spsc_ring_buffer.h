@@ -0,0 +1,290 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "ws/concurrency/internal/atomic_backoff.h"
+#include "ws/concurrency/internal/concurrent_monitor.h"
+#include "ws/concurrency/internal/helpers.h"
+#include "ws/machine.h"
+
+namespace ws {
+namespace concurrency {
+/** Bounded wait-free ring buffer for exactly one producer thread and one
+    consumer thread. The Try* operations never block; Push and Pop wait for
+    space or items, parking on a ConcurrentMonitor when blocking waits are
+    enabled and spinning with AtomicBackoff otherwise. */
+template <typename T, typename TAllocator = std::allocator<T>>
+class SpscRingBuffer {
+  using allocator_traits_type = std::allocator_traits<TAllocator>;
+  using monitor_type = ws::concurrency::internal::ConcurrentMonitor;
+
+ public:
+  using size_type = std::size_t;
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using difference_type = std::ptrdiff_t;
+
+  using allocator_type = TAllocator;
+  using pointer = typename allocator_traits_type::pointer;
+  using const_pointer = typename allocator_traits_type::const_pointer;
+
+  /** Capacity is rounded up to the next power of two. With blocking_waits
+      every operation pays a fence to wake a parked peer; without it the
+      Try* paths are fence-free and Push/Pop spin. */
+  explicit SpscRingBuffer(size_type capacity, bool blocking_waits = false,
+                          const allocator_type& a = allocator_type())
+      : allocator_(a),
+        capacity_(RoundUpToPowerOfTwo(capacity)),
+        mask_(capacity_ - 1),
+        blocking_waits_(blocking_waits),
+        buffer_(allocator_traits_type::allocate(allocator_, capacity_)) {
+    assert(ws::internal::IsAligned(&head_, ws::internal::CacheLineSize()) &&
+           "alignment error");
+    assert(ws::internal::IsAligned(&tail_, ws::internal::CacheLineSize()) &&
+           "alignment error");
+  }
+
+  SpscRingBuffer(const SpscRingBuffer&) = delete;
+  SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+  ~SpscRingBuffer() {
+    Clear();
+    allocator_traits_type::deallocate(allocator_, buffer_, capacity_);
+  }
+
+  void Push(const T& value) { InternalPush(value); }
+
+  void Push(T&& value) { InternalPush(std::move(value)); }
+
+  template <typename... TArgs>
+  void Emplace(TArgs&&... args) {
+    InternalPush(std::forward<TArgs>(args)...);
+  }
+
+  bool TryPush(const T& value) { return InternalTryPush(value); }
+
+  bool TryPush(T&& value) { return InternalTryPush(std::move(value)); }
+
+  template <typename... TArgs>
+  bool TryEmplace(TArgs&&... args) {
+    return InternalTryPush(std::forward<TArgs>(args)...);
+  }
+
+  /** Pushes [first, last), waiting for space as needed. Each batch is
+      published with a single tail store. */
+  template <typename TInputIterator>
+  void PushRange(TInputIterator first, TInputIterator last) {
+    first = TryPushRange(first, last);
+    while (first != last) {
+      WaitFor(slots_avail_, [this] { return HasSpace(); });
+      first = TryPushRange(first, last);
+    }
+  }
+
+  /** Pushes as many items of [first, last) as fit without waiting and
+      returns the first item that was not pushed. */
+  template <typename TInputIterator>
+  TInputIterator TryPushRange(TInputIterator first, TInputIterator last) {
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    size_type free_slots = capacity_ - (tail - cached_head_);
+    if (free_slots == 0) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      free_slots = capacity_ - (tail - cached_head_);
+    }
+
+    size_type pushed = 0;
+    auto publish_guard =
+        ws::concurrency::internal::templates::MakeRaiiGuard([&] {
+          if (pushed != 0) {
+            tail_.store(tail + pushed, std::memory_order_release);
+            NotifyIfBlocking(items_avail_);
+          }
+        });
+
+    for (; pushed != free_slots && first != last; ++first, ++pushed) {
+      allocator_traits_type::construct(allocator_,
+                                       &buffer_[(tail + pushed) & mask_],
+                                       *first);
+    }
+    return first;
+  }
+
+  void Pop(T& result) {
+    while (!TryPop(result)) {
+      WaitFor(items_avail_, [this] { return HasItems(); });
+    }
+  }
+
+  bool TryPop(T& result) {
+    const size_type head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) return false;
+    }
+
+    T& item = buffer_[head & mask_];
+    result = std::move(item);
+    allocator_traits_type::destroy(allocator_, &item);
+    head_.store(head + 1, std::memory_order_release);
+    NotifyIfBlocking(slots_avail_);
+    return true;
+  }
+
+  /** Pops up to max_count items into out, in FIFO order, with a single head
+      store. Returns the number of items written. */
+  template <typename TOutputIterator>
+  size_type TryPopBulk(TOutputIterator out, size_type max_count) {
+    const size_type head = head_.load(std::memory_order_relaxed);
+    size_type available = cached_tail_ - head;
+    if (available < max_count) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      available = cached_tail_ - head;
+    }
+    const size_type count = available < max_count ? available : max_count;
+
+    size_type popped = 0;
+    auto publish_guard =
+        ws::concurrency::internal::templates::MakeRaiiGuard([&] {
+          if (popped != 0) {
+            head_.store(head + popped, std::memory_order_release);
+            NotifyIfBlocking(slots_avail_);
+          }
+        });
+
+    while (popped != count) {
+      T* item = &buffer_[(head + popped) & mask_];
+      auto destroy_guard =
+          ws::concurrency::internal::templates::MakeRaiiGuard([&] {
+            allocator_traits_type::destroy(allocator_, item);
+            ++popped;
+          });
+      *out = std::move(*item);
+      ++out;
+    }
+    return popped;
+  }
+
+  void Abort() {
+    abort_counter_.fetch_add(1);
+    items_avail_.AbortAll();
+    slots_avail_.AbortAll();
+  }
+
+  size_type Size() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+
+  size_type Capacity() const { return capacity_; }
+
+  [[nodiscard]] bool Empty() const { return Size() == 0; }
+
+  /** Must only be called by the consumer, or when neither side is active. */
+  void Clear() {
+    size_type head = head_.load(std::memory_order_relaxed);
+    const size_type tail = tail_.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      allocator_traits_type::destroy(allocator_, &buffer_[head & mask_]);
+    }
+    head_.store(head, std::memory_order_release);
+    NotifyIfBlocking(slots_avail_);
+  }
+
+  allocator_type get_allocator() const { return allocator_; }
+
+ private:
+  static size_type RoundUpToPowerOfTwo(size_type n) {
+    size_type result = 1;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  template <typename... TArgs>
+  bool InternalTryPush(TArgs&&... args) {
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == capacity_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ == capacity_) return false;
+    }
+
+    allocator_traits_type::construct(allocator_, &buffer_[tail & mask_],
+                                     std::forward<TArgs>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    NotifyIfBlocking(items_avail_);
+    return true;
+  }
+
+  template <typename... TArgs>
+  void InternalPush(TArgs&&... args) {
+    WaitFor(slots_avail_, [this] { return HasSpace(); });
+    const bool pushed = InternalTryPush(std::forward<TArgs>(args)...);
+    assert(pushed && "Only the producer may push into the ring buffer");
+    (void)pushed;
+  }
+
+  bool HasSpace() const {
+    return tail_.load(std::memory_order_relaxed) -
+               head_.load(std::memory_order_acquire) <
+           capacity_;
+  }
+
+  bool HasItems() const {
+    return head_.load(std::memory_order_relaxed) !=
+           tail_.load(std::memory_order_acquire);
+  }
+
+  template <typename TPredicate>
+  void WaitFor(monitor_type& monitor, TPredicate ready) {
+    const unsigned old_abort_counter =
+        abort_counter_.load(std::memory_order_relaxed);
+    auto checked_ready = [&] {
+      if (abort_counter_.load(std::memory_order_relaxed) !=
+          old_abort_counter) {
+        throw std::runtime_error("user_abort");
+      }
+      return ready();
+    };
+
+    if (blocking_waits_) {
+      monitor.Wait<monitor_type::thread_context>(checked_ready,
+                                                 std::uintptr_t(0));
+    } else {
+      for (ws::concurrency::internal::AtomicBackoff backoff;
+           !checked_ready(); backoff.Wait()) {
+      }
+    }
+  }
+
+  void NotifyIfBlocking(monitor_type& monitor) {
+    if (blocking_waits_) {
+      monitor.NotifyOne();
+    }
+  }
+
+  allocator_type allocator_;
+  const size_type capacity_;
+  const size_type mask_;
+  const bool blocking_waits_;
+  T* const buffer_;
+
+  alignas(ws::internal::CacheLineSize()) std::atomic<size_type> head_{0};
+  size_type cached_tail_{0};
+
+  alignas(ws::internal::CacheLineSize()) std::atomic<size_type> tail_{0};
+  size_type cached_head_{0};
+
+  alignas(ws::internal::CacheLineSize()) std::atomic<unsigned> abort_counter_{
+      0};
+  monitor_type items_avail_;
+  monitor_type slots_avail_;
+};
+}  // namespace concurrency
+}  // namespace ws
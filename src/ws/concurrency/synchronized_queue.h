@@ -1,10 +1,23 @@
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
-#include <queue>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+
+#include "ws/concurrency/concurrent_queue.h"
+#include "ws/concurrency/internal/atomic_backoff.h"
+#include "ws/concurrency/internal/concurrent_monitor.h"
+
 namespace ws {
 namespace concurrency {
+/** Unbounded multi-producer/multi-consumer queue built on the lock-free
+    ConcurrentQueue representation. Pushes and TryPop never take a lock;
+    blocking pops spin briefly and then park on a ConcurrentMonitor, which
+    producers only touch when a consumer is actually waiting. As with
+    ConcurrentQueue, copy, move, assignment, Swap and Clear are not safe
+    against concurrent operations on either queue; callers that need them
+    while other threads push or pop must synchronize externally. */
 template <typename T>
 class SynchronizedQueue {
  public:
@@ -17,39 +30,29 @@ class SynchronizedQueue {
   SynchronizedQueue() = default;
 
   template <typename TInputIterator>
-  SynchronizedQueue(TInputIterator begin, TInputIterator end) {
-    for (; begin != end; ++begin) {
-      Push(*begin);
-    }
-  }
+  SynchronizedQueue(TInputIterator begin, TInputIterator end)
+      : queue_(begin, end) {}
 
   SynchronizedQueue(std::initializer_list<value_type> init)
       : SynchronizedQueue(init.begin(), init.end()) {}
 
-  SynchronizedQueue(const SynchronizedQueue& other) {
-    std::lock_guard<std::mutex> lock(other.mutex_);
-    queue_ = other.queue_;
-  }
+  SynchronizedQueue(const SynchronizedQueue& other) : queue_(other.queue_) {}
 
   SynchronizedQueue& operator=(const SynchronizedQueue& other) {
     if (this != &other) {
-      std::lock_guard<std::mutex> lock_this(mutex_);
-      std::lock_guard<std::mutex> lock_other(other.mutex_);
       queue_ = other.queue_;
+      monitor_.NotifyAll();
     }
     return *this;
   }
 
-  SynchronizedQueue(SynchronizedQueue&& other) noexcept {
-    std::lock_guard<std::mutex> lock(other.mutex_);
-    queue_ = std::move(other.queue_);
-  }
+  SynchronizedQueue(SynchronizedQueue&& other) noexcept
+      : queue_(std::move(other.queue_)) {}
 
   SynchronizedQueue& operator=(SynchronizedQueue&& other) noexcept {
     if (this != &other) {
-      std::lock_guard<std::mutex> lock_this(mutex_);
-      std::lock_guard<std::mutex> lock_other(other.mutex_);
       queue_ = std::move(other.queue_);
+      monitor_.NotifyAll();
     }
     return *this;
   }
@@ -57,67 +60,93 @@ class SynchronizedQueue {
   ~SynchronizedQueue() = default;
 
   void Push(const T& value) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.push(value);
-    cv_.notify_one();
+    queue_.Push(value);
+    monitor_.NotifyOne();
   }
 
   void Push(T&& value) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.push(std::move(value));
-    cv_.notify_one();
+    queue_.Push(std::move(value));
+    monitor_.NotifyOne();
   }
 
   template <typename... TArgs>
   void Emplace(TArgs&&... args) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    queue_.emplace(std::forward<TArgs>(args)...);
-    cv_.notify_one();
+    queue_.Emplace(std::forward<TArgs>(args)...);
+    monitor_.NotifyOne();
   }
 
   void Pop(T& result) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    cv_.wait(lock, [this]() { return !queue_.empty(); });
-    result = std::move(queue_.front());
-    queue_.pop();
-  }
-
-  bool TryPop(T& value) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (queue_.empty()) {
-      return false;
+    InternalWaitPop(result, [] { return false; }, std::uintptr_t(0));
+  }
+
+  /** Blocks until an item is popped into result or token is cancelled, and
+      returns false in the latter case. TCancellationToken is
+      ws::threading::CancellationToken; it is a template parameter so this
+      module does not depend on the threading module. */
+  template <typename TCancellationToken>
+  bool WaitPop(T& result, TCancellationToken token) {
+    if (TryPop(result)) return true;
+    if (token.IsCancellationRequested()) return false;
+
+    // The sleep node is tagged with the address of token, which is unique
+    // among the threads waiting right now, so cancelling wakes only this
+    // consumer.
+    const std::uintptr_t context = reinterpret_cast<std::uintptr_t>(&token);
+    auto registration = token.RegisterCallback([this, context] {
+      monitor_.Notify(
+          [context](std::uintptr_t other) { return other == context; });
+    });
+    const bool popped = InternalWaitPop(
+        result, [&token] { return token.IsCancellationRequested(); },
+        context);
+    if (registration.Ok()) {
+      registration.Value().Unregister();
     }
-    value = std::move(queue_.front());
-    queue_.pop();
-    return true;
+    return popped;
   }
 
-  size_type UnsafeSize() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.size();
-  }
+  bool TryPop(T& value) { return queue_.TryPop(value); }
 
-  bool Empty() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.empty();
-  }
+  size_type UnsafeSize() const { return queue_.UnsafeSize(); }
 
-  void Clear() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::queue<T> empty_queue;
-    std::swap(queue_, empty_queue);
-  }
+  bool Empty() const { return queue_.Empty(); }
+
+  /** Not safe against concurrent pushes or pops. */
+  void Clear() { queue_.Clear(); }
 
+  /** Not safe against concurrent operations on either queue. */
   void Swap(SynchronizedQueue& other) {
     if (this == &other) return;
-    std::scoped_lock lock(mutex_, other.mutex_);
-    queue_.swap(other.queue_);
+    queue_.Swap(other.queue_);
+    monitor_.NotifyAll();
+    other.monitor_.NotifyAll();
   }
 
  private:
-  std::queue<T> queue_;
-  mutable std::mutex mutex_;
-  std::condition_variable cv_;
+  template <typename TPredicate>
+  bool InternalWaitPop(T& result, TPredicate cancelled,
+                       std::uintptr_t context) {
+    for (ws::concurrency::internal::AtomicBackoff backoff;
+         backoff.BoundedWait();) {
+      if (TryPop(result)) return true;
+    }
+
+    while (!TryPop(result)) {
+      if (cancelled()) {
+        // The wake-up that ended our wait may have been meant for an item;
+        // hand it on so another consumer does not sleep past it.
+        if (!Empty()) monitor_.NotifyOne();
+        return false;
+      }
+      monitor_.Wait<ws::concurrency::internal::ConcurrentMonitor::
+                        thread_context>(
+          [&] { return !Empty() || cancelled(); }, context);
+    }
+    return true;
+  }
+
+  ConcurrentQueue<T> queue_;
+  ws::concurrency::internal::ConcurrentMonitor monitor_;
 };
 }  // namespace concurrency
 }  // namespace ws
@@ -126,7 +155,7 @@ namespace ws {
 template <typename T>
 class synchronized_queue {
  public:
-  using queue_type = SynchronizedQueue<T>;
+  using queue_type = ws::concurrency::SynchronizedQueue<T>;
 
   using value_type = typename queue_type::value_type;
   using size_type = typename queue_type::size_type;
@@ -175,6 +204,11 @@ class synchronized_queue {
 
   void pop(value_type& __x) { internal_instance_.Pop(__x); }
 
+  template <typename TCancellationToken>
+  bool wait_pop(value_type& __x, TCancellationToken __token) {
+    return internal_instance_.WaitPop(__x, std::move(__token));
+  }
+
   void pop() {
     value_type temp;
     internal_instance_.Pop(temp);
@@ -0,0 +1,43 @@
+#include "ws/concurrency/thread_pool.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace ws {
+namespace concurrency {
+ThreadPool::ThreadPool(size_type num_threads) {
+  num_threads = std::max<size_type>(num_threads, 1);
+  workers_.reserve(num_threads);
+  for (size_type i = 0; i < num_threads; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+    workers_.back()->random_state =
+        static_cast<std::uint32_t>(i) * 2654435761u + 1;
+  }
+
+  for (auto& worker : workers_) {
+    Worker& self = *worker;
+    self.thread = std::thread([this, &self] { WorkerLoop(self); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  stopping_.store(true, std::memory_order_release);
+  sleep_monitor_.NotifyAll();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+ThreadPool& ThreadPool::Default() {
+  static ThreadPool pool;
+  return pool;
+}
+
+ThreadPool::size_type ThreadPool::DefaultConcurrency() {
+  const unsigned concurrency = std::thread::hardware_concurrency();
+  return concurrency == 0 ? 1 : concurrency;
+}
+}  // namespace concurrency
+}  // namespace ws
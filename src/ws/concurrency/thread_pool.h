@@ -0,0 +1,283 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "ws/concurrency/concurrent_queue.h"
+#include "ws/concurrency/internal/atomic_backoff.h"
+#include "ws/concurrency/internal/concurrent_monitor.h"
+#include "ws/concurrency/internal/work_stealing_deque.h"
+#include "ws/delegate.h"
+
+namespace ws {
+namespace concurrency {
+/** Fixed-size pool of worker threads. Each worker owns a work-stealing deque;
+    tasks submitted from a worker go to its own deque, tasks submitted from
+    other threads (or that overflow a deque) go to a shared injection queue.
+    Idle workers steal from random victims and then sleep on a
+    ConcurrentMonitor until new work is submitted. Exceptions escaping a
+    submitted task terminate the program, as with std::thread. */
+class ThreadPool {
+ public:
+  using size_type = std::size_t;
+  using task_type = ws::Delegate<void()>;
+
+  static constexpr size_type kDequeCapacity = 1024;
+
+  explicit ThreadPool(size_type num_threads = DefaultConcurrency());
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /** Runs every task already submitted, then joins the workers. */
+  ~ThreadPool();
+
+  static ThreadPool& Default();
+
+  static size_type DefaultConcurrency();
+
+  void Submit(task_type task);
+
+  /** Calls body(i) for every i in [begin, end), in chunks of grain indices
+      spread over the workers and the calling thread. Returns once every
+      index has been processed and rethrows the first exception thrown by
+      body. Safe to call from inside a task of the same pool. */
+  template <typename TIndex, typename TBody>
+  void ParallelFor(TIndex begin, TIndex end, TIndex grain, const TBody& body);
+
+  size_type NumThreads() const { return workers_.size(); }
+
+ private:
+  struct alignas(ws::internal::CacheLineSize()) Worker {
+    Worker() : deque(kDequeCapacity) {}
+
+    ws::concurrency::internal::WorkStealingDeque<task_type> deque;
+    std::uint32_t random_state = 0;
+    std::thread thread;
+  };
+
+  struct WorkerContext {
+    const ThreadPool* pool = nullptr;
+    Worker* worker = nullptr;
+  };
+
+  template <typename TIndex, typename TBody>
+  struct ParallelForState {
+    TIndex begin;
+    TIndex end;
+    TIndex grain;
+    size_type num_chunks;
+    const TBody* body;
+    std::atomic<size_type> next_chunk{0};
+    std::atomic<size_type> completed_chunks{0};
+    std::atomic<bool> cancelled{false};
+    std::mutex exception_mutex;
+    std::exception_ptr exception;
+  };
+
+  static WorkerContext& CurrentContext();
+
+  template <typename TIndex, typename TBody>
+  static void RunChunks(ParallelForState<TIndex, TBody>& state);
+
+  Worker* CurrentWorker() const;
+
+  void WorkerLoop(Worker& self);
+
+  bool TryGetTask(Worker* self, task_type& task);
+
+  bool TrySteal(Worker* self, task_type& task);
+
+  bool TryRunOne(Worker* self);
+
+  bool HasWork() const;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  ws::concurrency::ConcurrentQueue<task_type> injection_queue_;
+  ws::concurrency::internal::ConcurrentMonitor sleep_monitor_;
+  std::atomic<bool> stopping_{false};
+};
+
+// ============================================================================
+// Implementation details for ThreadPool
+// ============================================================================
+
+inline void ThreadPool::Submit(task_type task) {
+  Worker* self = CurrentWorker();
+  if (!self || !self->deque.TryPush(std::move(task))) {
+    injection_queue_.Push(std::move(task));
+  }
+
+  sleep_monitor_.NotifyOne();
+}
+
+template <typename TIndex, typename TBody>
+void ThreadPool::ParallelFor(TIndex begin, TIndex end, TIndex grain,
+                             const TBody& body) {
+  static_assert(std::is_integral<TIndex>::value,
+                "ParallelFor requires an integral index type");
+  if (!(begin < end)) return;
+  if (grain < 1) grain = 1;
+
+  const size_type range = static_cast<size_type>(end - begin);
+  const size_type chunk = static_cast<size_type>(grain);
+  const size_type num_chunks = range / chunk + (range % chunk != 0);
+  if (num_chunks == 1) {
+    for (TIndex i = begin; i < end; ++i) {
+      body(i);
+    }
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState<TIndex, TBody>>();
+  state->begin = begin;
+  state->end = end;
+  state->grain = grain;
+  state->num_chunks = num_chunks;
+  state->body = &body;
+
+  const size_type num_helpers = std::min(num_chunks - 1, NumThreads());
+  for (size_type i = 0; i < num_helpers; ++i) {
+    Submit([state] { RunChunks(*state); });
+  }
+
+  RunChunks(*state);
+
+  Worker* self = CurrentWorker();
+  size_type completed;
+  ws::concurrency::internal::AtomicBackoff backoff;
+  while ((completed = state->completed_chunks.load(
+              std::memory_order_acquire)) != num_chunks) {
+    if (self) {
+      if (TryRunOne(self)) {
+        backoff.Reset();
+      } else {
+        backoff.Wait();
+      }
+    } else {
+      state->completed_chunks.wait(completed, std::memory_order_acquire);
+    }
+  }
+
+  if (state->exception) std::rethrow_exception(state->exception);
+}
+
+inline ThreadPool::WorkerContext& ThreadPool::CurrentContext() {
+  static thread_local WorkerContext context;
+  return context;
+}
+
+template <typename TIndex, typename TBody>
+void ThreadPool::RunChunks(ParallelForState<TIndex, TBody>& state) {
+  size_type index;
+  while ((index = state.next_chunk.fetch_add(1, std::memory_order_relaxed)) <
+         state.num_chunks) {
+    if (!state.cancelled.load(std::memory_order_relaxed)) {
+      const TIndex first =
+          state.begin + static_cast<TIndex>(index) * state.grain;
+      const TIndex last =
+          state.end - first > state.grain ? first + state.grain : state.end;
+      try {
+        for (TIndex i = first; i < last; ++i) {
+          (*state.body)(i);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(state.exception_mutex);
+        if (!state.exception) state.exception = std::current_exception();
+        state.cancelled.store(true, std::memory_order_relaxed);
+      }
+    }
+
+    if (state.completed_chunks.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+        state.num_chunks) {
+      state.completed_chunks.notify_all();
+    }
+  }
+}
+
+inline ThreadPool::Worker* ThreadPool::CurrentWorker() const {
+  const WorkerContext& context = CurrentContext();
+  return context.pool == this ? context.worker : nullptr;
+}
+
+inline void ThreadPool::WorkerLoop(Worker& self) {
+  CurrentContext() = WorkerContext{this, &self};
+
+  task_type task;
+  for (;;) {
+    if (TryGetTask(&self, task)) {
+      task();
+      task.Reset();
+      continue;
+    }
+
+    bool found = false;
+    for (ws::concurrency::internal::AtomicBackoff backoff;
+         !found && backoff.BoundedWait();) {
+      found = TryGetTask(&self, task);
+    }
+    if (found) {
+      task();
+      task.Reset();
+      continue;
+    }
+
+    if (stopping_.load(std::memory_order_acquire)) break;
+
+    sleep_monitor_
+        .Wait<ws::concurrency::internal::ConcurrentMonitor::thread_context>(
+            [this] {
+              return stopping_.load(std::memory_order_relaxed) || HasWork();
+            },
+            std::uintptr_t(0));
+  }
+}
+
+inline bool ThreadPool::TryGetTask(Worker* self, task_type& task) {
+  if (self && self->deque.TryPop(task)) return true;
+  if (injection_queue_.TryPop(task)) return true;
+  return TrySteal(self, task);
+}
+
+inline bool ThreadPool::TrySteal(Worker* self, task_type& task) {
+  const size_type num_workers = workers_.size();
+  size_type start = 0;
+  if (self) {
+    std::uint32_t x = self->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    self->random_state = x;
+    start = x % num_workers;
+  }
+
+  for (size_type i = 0; i < num_workers; ++i) {
+    Worker* victim = workers_[(start + i) % num_workers].get();
+    if (victim != self && victim->deque.TrySteal(task)) return true;
+  }
+  return false;
+}
+
+inline bool ThreadPool::TryRunOne(Worker* self) {
+  task_type task;
+  if (!TryGetTask(self, task)) return false;
+  task();
+  return true;
+}
+
+inline bool ThreadPool::HasWork() const {
+  if (!injection_queue_.Empty()) return true;
+  for (const auto& worker : workers_) {
+    if (!worker->deque.Empty()) return true;
+  }
+  return false;
+}
+}  // namespace concurrency
+}  // namespace ws
@@ -129,15 +129,8 @@ inline Delegate<R(Args...)>::Delegate(Delegate&& other) noexcept {
     call_fn_ = other.call_fn_;
     manager_fn_ = other.manager_fn_;
     using_sbo_ = other.using_sbo_;
-    if (using_sbo_) {
-      manager_fn_(MOVE_OP, static_cast<const void*>(other.storage_),
-                  static_cast<void*>(storage_));
-    } else {
-      std::memcpy(static_cast<void*>(storage_),
-                  static_cast<const void*>(other.storage_), sizeof(void*));
-      other.manager_fn_(DESTROY_OP, static_cast<const void*>(other.storage_),
-                        nullptr);
-    }
+    manager_fn_(MOVE_OP, static_cast<const void*>(other.storage_),
+                static_cast<void*>(storage_));
     other.call_fn_ = nullptr;
     other.manager_fn_ = nullptr;
   }
@@ -168,15 +161,8 @@ inline Delegate<R(Args...)>& Delegate<R(Args...)>::operator=(
       call_fn_ = other.call_fn_;
       manager_fn_ = other.manager_fn_;
       using_sbo_ = other.using_sbo_;
-      if (using_sbo_) {
-        manager_fn_(MOVE_OP, static_cast<const void*>(other.storage_),
-                    static_cast<void*>(storage_));
-      } else {
-        std::memcpy(static_cast<void*>(storage_),
-                    static_cast<const void*>(other.storage_), sizeof(void*));
-        other.manager_fn_(DESTROY_OP, static_cast<const void*>(other.storage_),
-                          nullptr);
-      }
+      manager_fn_(MOVE_OP, static_cast<const void*>(other.storage_),
+                  static_cast<void*>(storage_));
       other.call_fn_ = nullptr;
       other.manager_fn_ = nullptr;
     }
@@ -227,7 +213,9 @@ void Delegate<R(Args...)>::FunctionManager<F, true>::Manager(int op,
   if (op == COPY_OP) {
     new (dest) F(*reinterpret_cast<const F*>(src));
   } else if (op == MOVE_OP) {
-    new (dest) F(std::move(*reinterpret_cast<const F*>(src)));
+    F* src_f = reinterpret_cast<F*>(const_cast<void*>(src));
+    new (dest) F(std::move(*src_f));
+    src_f->~F();
   } else if (op == DESTROY_OP) {
     reinterpret_cast<const F*>(src)->~F();
   }
@@ -268,7 +256,7 @@ void Delegate<R(Args...)>::Assign(F&& f) {
   call_fn_ = &FunctionManager<DecayedF, useInline>::Call;
   manager_fn_ = &FunctionManager<DecayedF, useInline>::Manager;
   using_sbo_ = useInline;
-  if (using_sbo_) {
+  if constexpr (useInline) {
     new (static_cast<void*>(storage_)) DecayedF(std::forward<F>(f));
   } else {
     DecayedF* ptr = new DecayedF(std::forward<F>(f));
@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ws/imaging/pixel/color_formats/cmyk/cmyk_to_srgb_converter.h"
+#include "ws/imaging/pixel/color_formats/srgb/srgb_to_cmyk_converter.h"
+
+namespace ws {
+namespace imaging {
+namespace bench {
+namespace {
+constexpr std::size_t kPixels = 1920 * 64;
+
+template <typename T>
+T RandomSample(std::mt19937& random) {
+  return static_cast<T>(random());
+}
+
+void ReportMegapixels(benchmark::State& state) {
+  state.SetItemsProcessed(state.iterations() * kPixels);
+  state.counters["MPix/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * kPixels) / 1e6,
+      benchmark::Counter::kIsRate);
+}
+
+/** Interleaved CMYKA to RGBA, one pixel at a time in double precision. */
+template <typename T>
+void BM_CmykaToRgba_Convert(benchmark::State& state) {
+  const CmykToSRgbConverter<T> converter(8 * sizeof(T));
+  std::mt19937 random(42);
+  std::vector<Cmyka<T>> in(kPixels);
+  for (Cmyka<T>& pixel : in) {
+    pixel = {RandomSample<T>(random), RandomSample<T>(random),
+             RandomSample<T>(random), RandomSample<T>(random),
+             RandomSample<T>(random)};
+  }
+  std::vector<Rgba<T>> out(kPixels);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kPixels; ++i) {
+      converter.ConvertWithAlpha(in[i], out[i]);
+    }
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  ReportMegapixels(state);
+}
+
+template <typename T>
+void BM_CmykaToRgba_ConvertRow(benchmark::State& state) {
+  const CmykToSRgbConverter<T> converter(8 * sizeof(T));
+  std::mt19937 random(42);
+  std::vector<Cmyka<T>> in(kPixels);
+  for (Cmyka<T>& pixel : in) {
+    pixel = {RandomSample<T>(random), RandomSample<T>(random),
+             RandomSample<T>(random), RandomSample<T>(random),
+             RandomSample<T>(random)};
+  }
+  std::vector<Rgba<T>> out(kPixels);
+  for (auto _ : state) {
+    converter.ConvertRowWithAlpha(in, out);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  ReportMegapixels(state);
+}
+
+/** Interleaved RGBA to CMYKA, one pixel at a time in double precision. */
+template <typename T>
+void BM_RgbaToCmyka_Convert(benchmark::State& state) {
+  const SRgbToCmykConverter<T> converter(8 * sizeof(T));
+  std::mt19937 random(42);
+  std::vector<Rgba<T>> in(kPixels);
+  for (Rgba<T>& pixel : in) {
+    pixel = {RandomSample<T>(random), RandomSample<T>(random),
+             RandomSample<T>(random), RandomSample<T>(random)};
+  }
+  std::vector<Cmyka<T>> out(kPixels);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < kPixels; ++i) {
+      converter.ConvertWithAlpha(in[i], out[i]);
+    }
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  ReportMegapixels(state);
+}
+
+template <typename T>
+void BM_RgbaToCmyka_ConvertRow(benchmark::State& state) {
+  const SRgbToCmykConverter<T> converter(8 * sizeof(T));
+  std::mt19937 random(42);
+  std::vector<Rgba<T>> in(kPixels);
+  for (Rgba<T>& pixel : in) {
+    pixel = {RandomSample<T>(random), RandomSample<T>(random),
+             RandomSample<T>(random), RandomSample<T>(random)};
+  }
+  std::vector<Cmyka<T>> out(kPixels);
+  for (auto _ : state) {
+    converter.ConvertRowWithAlpha(in, out);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  ReportMegapixels(state);
+}
+
+BENCHMARK(BM_CmykaToRgba_Convert<uint8_t>);
+BENCHMARK(BM_CmykaToRgba_Convert<uint16_t>);
+BENCHMARK(BM_CmykaToRgba_ConvertRow<uint8_t>);
+BENCHMARK(BM_CmykaToRgba_ConvertRow<uint16_t>);
+BENCHMARK(BM_RgbaToCmyka_Convert<uint8_t>);
+BENCHMARK(BM_RgbaToCmyka_Convert<uint16_t>);
+BENCHMARK(BM_RgbaToCmyka_ConvertRow<uint8_t>);
+BENCHMARK(BM_RgbaToCmyka_ConvertRow<uint16_t>);
+}  // namespace
+}  // namespace bench
+}  // namespace imaging
+}  // namespace ws
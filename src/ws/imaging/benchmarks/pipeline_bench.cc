@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ws/imaging/image_buffer_converter.h"
+#include "ws/imaging/image_buffer_exporter.h"
+#include "ws/imaging/image_buffer_loader.h"
+#include "ws/imaging/pixel/color_formats/srgb/srgb_to_sycc_converter.h"
+
+namespace ws {
+namespace imaging {
+namespace bench {
+namespace {
+constexpr uint32_t kWidth = 1920;
+constexpr uint32_t kHeight = 1080;
+constexpr std::size_t kPixels = std::size_t{kWidth} * kHeight;
+
+std::vector<uint8_t> RandomRgb() {
+  std::mt19937 random(42);
+  std::vector<uint8_t> rgb(kPixels * 3);
+  for (uint8_t& sample : rgb) sample = static_cast<uint8_t>(random());
+  return rgb;
+}
+
+void ReportMegapixels(benchmark::State& state) {
+  state.SetItemsProcessed(state.iterations() * kPixels);
+  state.counters["MPix/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * kPixels) / 1e6,
+      benchmark::Counter::kIsRate);
+}
+
+/** Interleaved RGB to interleaved YCbCr in three passes: load into
+    planes, convert each row into a new image, export. */
+void BM_RgbToI444_ThreePass(benchmark::State& state) {
+  const std::vector<uint8_t> rgb = RandomRgb();
+  const SRgbToSYccConverter<uint8_t> converter(
+      8, DigitalTvStudioEncodingRec::kBT709);
+  for (auto _ : state) {
+    StatusOr<Image> source = ImageBufferLoader<uint8_t>::
+        LoadFromInterleavedBuffer(rgb, kWidth, kHeight, 8, PixelFormat::kRgb);
+    Image::container_type planes(3);
+    for (ImageComponent& plane : planes) {
+      plane = ImageComponent::Create<uint8_t>(kWidth, kPixels, 8).Value();
+    }
+
+    const Image& image = source.Value();
+    for (std::size_t row = 0; row < kPixels; row += kWidth) {
+      converter.ConvertRow(
+          std::span<const uint8_t>(image.GetComponent(0).Buffer<uint8_t>() +
+                                       row,
+                                   kWidth),
+          std::span<const uint8_t>(image.GetComponent(1).Buffer<uint8_t>() +
+                                       row,
+                                   kWidth),
+          std::span<const uint8_t>(image.GetComponent(2).Buffer<uint8_t>() +
+                                       row,
+                                   kWidth),
+          std::span<uint8_t>(planes[0].Buffer<uint8_t>() + row, kWidth),
+          std::span<uint8_t>(planes[1].Buffer<uint8_t>() + row, kWidth),
+          std::span<uint8_t>(planes[2].Buffer<uint8_t>() + row, kWidth));
+    }
+
+    StatusOr<Image> ycc =
+        Image::Create(std::move(planes), kWidth, kHeight, ColorSpace::kSYcc,
+                      ChromaSubsampling::kSamp444);
+    StatusOr<ImageBufferExporter<uint8_t>::container_type> out =
+        ImageBufferExporter<uint8_t>::ExportToInterleavedBuffer(
+            ycc.Value(), PixelFormat::kI444);
+    benchmark::DoNotOptimize(out.Value().data());
+  }
+  ReportMegapixels(state);
+}
+
+/** The same conversion fused into one pass over a caller buffer. */
+void BM_RgbToI444_Fused(benchmark::State& state) {
+  const std::vector<uint8_t> rgb = RandomRgb();
+  std::vector<uint8_t> ycc(kPixels * 3);
+  for (auto _ : state) {
+    const Status status = ImageBufferConverter<uint8_t>::
+        ConvertInterleavedBuffer(rgb, PixelFormat::kRgb, ycc,
+                                 PixelFormat::kI444, kWidth, kHeight, 8,
+                                 DigitalTvStudioEncodingRec::kBT709);
+    benchmark::DoNotOptimize(status);
+    benchmark::DoNotOptimize(ycc.data());
+    benchmark::ClobberMemory();
+  }
+  ReportMegapixels(state);
+}
+
+BENCHMARK(BM_RgbToI444_ThreePass)->UseRealTime();
+BENCHMARK(BM_RgbToI444_Fused)->UseRealTime();
+}  // namespace
+}  // namespace bench
+}  // namespace imaging
+}  // namespace ws
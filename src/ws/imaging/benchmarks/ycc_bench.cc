@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ws/imaging/pixel/color_formats/srgb/srgb_to_sycc_converter.h"
+#include "ws/imaging/pixel/color_formats/sycc/sycc_to_srgb_converter.h"
+#include "ws/imaging/pixel/pixel_converter.h"
+
+namespace ws {
+namespace imaging {
+namespace bench {
+namespace {
+constexpr std::size_t kWidth = 1920;
+constexpr std::size_t kRows = 64;
+constexpr std::size_t kPixels = kWidth * kRows;
+
+/** Three planes of random samples below 2^bits. */
+template <typename T>
+struct Planes {
+  Planes(std::size_t size, uint8_t bits)
+      : c0(size), c1(size), c2(size) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<uint32_t> sample(0, (1u << bits) - 1);
+    for (std::size_t i = 0; i < size; ++i) {
+      c0[i] = static_cast<T>(sample(random));
+      c1[i] = static_cast<T>(sample(random));
+      c2[i] = static_cast<T>(sample(random));
+    }
+  }
+
+  std::vector<T> c0;
+  std::vector<T> c1;
+  std::vector<T> c2;
+};
+
+void ReportMegapixels(benchmark::State& state) {
+  state.SetItemsProcessed(state.iterations() * kPixels);
+  state.counters["MPix/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations() * kPixels) / 1e6,
+      benchmark::Counter::kIsRate);
+}
+
+/** Converts kRows rows of kWidth pixels with ConvertRow. */
+template <typename T, typename TConverter>
+void BM_ConvertRow(benchmark::State& state) {
+  const uint8_t bits = static_cast<uint8_t>(state.range(0));
+  const TConverter converter(
+      bits, TConverter::DigitalTvStudioEncodingRec::kBT709);
+  const Planes<T> in(kPixels, bits);
+  Planes<T> out(kPixels, bits);
+  for (auto _ : state) {
+    for (std::size_t row = 0; row < kPixels; row += kWidth) {
+      converter.ConvertRow(
+          std::span<const T>(in.c0).subspan(row, kWidth),
+          std::span<const T>(in.c1).subspan(row, kWidth),
+          std::span<const T>(in.c2).subspan(row, kWidth),
+          std::span<T>(out.c0).subspan(row, kWidth),
+          std::span<T>(out.c1).subspan(row, kWidth),
+          std::span<T>(out.c2).subspan(row, kWidth));
+    }
+    benchmark::DoNotOptimize(out.c0.data());
+    benchmark::ClobberMemory();
+  }
+  ReportMegapixels(state);
+}
+
+/** The per-pixel double-precision path, as the baseline. */
+template <typename T>
+void BM_SRgbToSYcc_Convert(benchmark::State& state) {
+  const uint8_t bits = static_cast<uint8_t>(state.range(0));
+  const SRgbToSYccConverter<T> converter(
+      bits, SRgbToSYccConverter<T>::DigitalTvStudioEncodingRec::kBT709);
+  const Planes<T> in(kPixels, bits);
+  Planes<T> out(kPixels, bits);
+  for (auto _ : state) {
+    Ycc<T> ycc;
+    for (std::size_t i = 0; i < kPixels; ++i) {
+      converter.Convert({in.c0[i], in.c1[i], in.c2[i]}, ycc);
+      out.c0[i] = ycc.y;
+      out.c1[i] = ycc.cb;
+      out.c2[i] = ycc.cr;
+    }
+    benchmark::DoNotOptimize(out.c0.data());
+    benchmark::ClobberMemory();
+  }
+  ReportMegapixels(state);
+}
+
+/** Interleaved pixels through the kernel SelectPixelRowKernel picks. */
+template <typename T>
+void BM_SRgbToSYcc_PixelKernel(benchmark::State& state) {
+  const uint8_t bits = static_cast<uint8_t>(state.range(0));
+  const PixelRowKernel<Rgb<T>, Ycc<T>> kernel =
+      SelectPixelRowKernel<Rgb<T>, Ycc<T>>(
+          bits, DigitalTvStudioEncodingRec::kBT709);
+  const Planes<T> planes(kPixels, bits);
+  std::vector<Rgb<T>> in(kPixels);
+  for (std::size_t i = 0; i < kPixels; ++i)
+    in[i] = {planes.c0[i], planes.c1[i], planes.c2[i]};
+
+  std::vector<Ycc<T>> out(kPixels);
+  for (auto _ : state) {
+    for (std::size_t row = 0; row < kPixels; row += kWidth) {
+      kernel(std::span<const Rgb<T>>(in).subspan(row, kWidth),
+             std::span<Ycc<T>>(out).subspan(row, kWidth));
+    }
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  ReportMegapixels(state);
+}
+
+BENCHMARK(BM_SRgbToSYcc_Convert<uint8_t>)->Arg(8);
+BENCHMARK(BM_SRgbToSYcc_Convert<uint16_t>)->Arg(10)->Arg(16);
+BENCHMARK(BM_SRgbToSYcc_PixelKernel<uint8_t>)->Arg(8);
+BENCHMARK(BM_SRgbToSYcc_PixelKernel<uint16_t>)->Arg(10)->Arg(16);
+BENCHMARK(BM_ConvertRow<uint8_t, SRgbToSYccConverter<uint8_t>>)->Arg(8);
+BENCHMARK(BM_ConvertRow<uint16_t, SRgbToSYccConverter<uint16_t>>)
+    ->Arg(10)
+    ->Arg(16);
+BENCHMARK(BM_ConvertRow<uint8_t, SYccToRgbConverter<uint8_t>>)->Arg(8);
+BENCHMARK(BM_ConvertRow<uint16_t, SYccToRgbConverter<uint16_t>>)
+    ->Arg(10)
+    ->Arg(16);
+}  // namespace
+}  // namespace bench
+}  // namespace imaging
+}  // namespace ws
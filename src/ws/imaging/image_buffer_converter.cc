@@ -0,0 +1,317 @@
+#include "ws/imaging/image_buffer_converter.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+
+#include "ws/concurrency/thread_pool.h"
+#include "ws/imaging/pixel/pixel_converter.h"
+#include "ws/status/status_code.h"
+
+namespace ws {
+namespace imaging {
+namespace {
+/** Pixels staged per kernel call; both stages stay within L1. */
+constexpr std::size_t kChunkPixels = 512;
+
+enum class PixelKind {
+  kGray,
+  kYa,
+  kRgb,
+  kRgba,
+  kYcc,
+  kCmyk,
+  kCmyka,
+  kUnsupported
+};
+
+PixelKind GetPixelKind(const PixelFormatDetails& details) {
+  const uint8_t num_components = details.num_components;
+  const bool has_alpha = details.HasAlpha();
+  if (details.components_order.size() != num_components)
+    return PixelKind::kUnsupported;
+
+  switch (details.color_space) {
+    case ColorSpace::kGray:
+      if (num_components == 1) return PixelKind::kGray;
+      break;
+    case ColorSpace::kSYcc:
+      if (details.chroma_subsampling == ChromaSubsampling::kSamp400)
+        return has_alpha ? PixelKind::kYa : PixelKind::kGray;
+      if (details.chroma_subsampling == ChromaSubsampling::kSamp444 &&
+          num_components == 3)
+        return PixelKind::kYcc;
+      break;
+    case ColorSpace::kSRgb:
+      if (num_components == 3 && !has_alpha) return PixelKind::kRgb;
+      if (num_components == 4 && has_alpha) return PixelKind::kRgba;
+      break;
+    case ColorSpace::kCmyk:
+      if (num_components == 4 && !has_alpha) return PixelKind::kCmyk;
+      if (num_components == 5 && has_alpha) return PixelKind::kCmyka;
+      break;
+    default:
+      break;
+  }
+
+  return PixelKind::kUnsupported;
+}
+
+template <typename T>
+struct BufferConversion {
+  const T* source;
+  std::span<const uint8_t> source_order;
+  T* destination;
+  std::span<const uint8_t> destination_order;
+  std::size_t num_pixels;
+  std::size_t pixels_per_task;
+  uint8_t bit_depth;
+  DigitalTvStudioEncodingRec rec;
+};
+
+/** Pixel structs are their components in canonical order, with no
+    padding, so they round-trip through an array of samples. */
+template <typename T, typename TPixel>
+constexpr std::size_t kSamplesPerPixel = sizeof(TPixel) / sizeof(T);
+
+/** Copies whole chunks of samples into pixels and back. Ya, Rgba and
+    Cmyka default alpha to opaque and so are not trivial, but they are
+    trivially copyable, which is all memcpy needs; going through void*
+    tells -Wclass-memaccess so. A per-pixel std::bit_cast does not
+    vectorize and is several times slower. */
+template <typename TPixel>
+void CopyBytes(void* destination, const void* source, std::size_t count) {
+  static_assert(std::is_trivially_copyable_v<TPixel>,
+                "Pixels are copied as bytes");
+  std::memcpy(destination, source, count * sizeof(TPixel));
+}
+
+/** Where each component sits within an interleaved pixel. */
+template <std::size_t kSamples>
+using SamplePositions = std::array<uint8_t, kSamples>;
+
+template <std::size_t kSamples>
+SamplePositions<kSamples> GetSamplePositions(
+    std::span<const uint8_t> order) {
+  SamplePositions<kSamples> positions{};
+  for (std::size_t i = 0; i < kSamples; ++i)
+    positions[order[i]] = static_cast<uint8_t>(i);
+
+  return positions;
+}
+
+template <std::size_t kSamples>
+bool IsCanonicalOrder(const SamplePositions<kSamples>& positions) {
+  for (std::size_t c = 0; c < kSamples; ++c)
+    if (positions[c] != c) return false;
+
+  return true;
+}
+
+/** positions is taken by value: stores of char-sized samples could
+    otherwise alias it and force a reload per sample. */
+template <typename T, typename TPixel>
+void GatherPixels(const T* samples,
+                  SamplePositions<kSamplesPerPixel<T, TPixel>> positions,
+                  TPixel* pixels, std::size_t count) {
+  constexpr std::size_t kSamples = kSamplesPerPixel<T, TPixel>;
+  if (IsCanonicalOrder(positions)) {
+    CopyBytes<TPixel>(pixels, samples, count);
+    return;
+  }
+
+  for (std::size_t i = 0; i < count; ++i, samples += kSamples) {
+    std::array<T, kSamples> components;
+    [&]<std::size_t... kC>(std::index_sequence<kC...>) {
+      ((components[kC] = samples[positions[kC]]), ...);
+    }(std::make_index_sequence<kSamples>());
+    pixels[i] = std::bit_cast<TPixel>(components);
+  }
+}
+
+template <typename T, typename TPixel>
+void ScatterPixels(const TPixel* pixels,
+                   SamplePositions<kSamplesPerPixel<T, TPixel>> positions,
+                   T* samples, std::size_t count) {
+  constexpr std::size_t kSamples = kSamplesPerPixel<T, TPixel>;
+  if (IsCanonicalOrder(positions)) {
+    CopyBytes<TPixel>(samples, pixels, count);
+    return;
+  }
+
+  for (std::size_t i = 0; i < count; ++i, samples += kSamples) {
+    const auto components =
+        std::bit_cast<std::array<T, kSamples>>(pixels[i]);
+    [&]<std::size_t... kC>(std::index_sequence<kC...>) {
+      ((samples[positions[kC]] = components[kC]), ...);
+    }(std::make_index_sequence<kSamples>());
+  }
+}
+
+template <typename T, typename TSrc, typename TDst>
+Status ConvertPixels(const BufferConversion<T>& conversion) {
+  constexpr std::size_t kSrcSamples = kSamplesPerPixel<T, TSrc>;
+  constexpr std::size_t kDstSamples = kSamplesPerPixel<T, TDst>;
+  PixelRowKernel<TSrc, TDst> kernel = nullptr;
+  if constexpr (!std::is_same_v<TSrc, TDst>) {
+    kernel = SelectPixelRowKernel<TSrc, TDst>(conversion.bit_depth,
+                                              conversion.rec);
+    if (!kernel)
+      return Status(StatusCode::kBadRequest,
+                    "No pixel kernel for this bit depth and format pair");
+  }
+
+  const std::size_t num_tasks =
+      (conversion.num_pixels + conversion.pixels_per_task - 1) /
+      conversion.pixels_per_task;
+  const SamplePositions<kSrcSamples> source_positions =
+      GetSamplePositions<kSrcSamples>(conversion.source_order);
+  const SamplePositions<kDstSamples> destination_positions =
+      GetSamplePositions<kDstSamples>(conversion.destination_order);
+  ws::concurrency::ThreadPool::Default().ParallelFor<std::size_t>(
+      0, num_tasks, 1, [&](std::size_t task) {
+        const std::size_t begin = task * conversion.pixels_per_task;
+        const std::size_t end = std::min(
+            begin + conversion.pixels_per_task, conversion.num_pixels);
+        std::array<TSrc, kChunkPixels> in;
+        std::array<TDst, kChunkPixels> out;
+        for (std::size_t chunk = begin; chunk < end; chunk += kChunkPixels) {
+          const std::size_t count = std::min(kChunkPixels, end - chunk);
+          const T* src = conversion.source + chunk * kSrcSamples;
+          T* dst = conversion.destination + chunk * kDstSamples;
+          GatherPixels<T>(src, source_positions, in.data(), count);
+          if constexpr (std::is_same_v<TSrc, TDst>) {
+            ScatterPixels<T>(in.data(), destination_positions, dst, count);
+          } else {
+            kernel(std::span<const TSrc>(in.data(), count),
+                   std::span<TDst>(out.data(), count));
+            ScatterPixels<T>(out.data(), destination_positions, dst, count);
+          }
+        }
+      });
+
+  return Status();
+}
+
+template <typename T, typename TSrc>
+Status DispatchDestination(const BufferConversion<T>& conversion,
+                           PixelKind destination) {
+  switch (destination) {
+    case PixelKind::kGray:
+      return ConvertPixels<T, TSrc, Gray<T>>(conversion);
+    case PixelKind::kYa:
+      return ConvertPixels<T, TSrc, Ya<T>>(conversion);
+    case PixelKind::kRgb:
+      return ConvertPixels<T, TSrc, Rgb<T>>(conversion);
+    case PixelKind::kRgba:
+      return ConvertPixels<T, TSrc, Rgba<T>>(conversion);
+    case PixelKind::kYcc:
+      return ConvertPixels<T, TSrc, Ycc<T>>(conversion);
+    case PixelKind::kCmyk:
+      return ConvertPixels<T, TSrc, Cmyk<T>>(conversion);
+    case PixelKind::kCmyka:
+      return ConvertPixels<T, TSrc, Cmyka<T>>(conversion);
+    default:
+      return Status(StatusCode::kBadRequest,
+                    "Unsupported destination pixel format");
+  }
+}
+
+template <typename T>
+Status DispatchSource(const BufferConversion<T>& conversion,
+                      PixelKind source, PixelKind destination) {
+  switch (source) {
+    case PixelKind::kGray:
+      return DispatchDestination<T, Gray<T>>(conversion, destination);
+    case PixelKind::kYa:
+      return DispatchDestination<T, Ya<T>>(conversion, destination);
+    case PixelKind::kRgb:
+      return DispatchDestination<T, Rgb<T>>(conversion, destination);
+    case PixelKind::kRgba:
+      return DispatchDestination<T, Rgba<T>>(conversion, destination);
+    case PixelKind::kYcc:
+      return DispatchDestination<T, Ycc<T>>(conversion, destination);
+    case PixelKind::kCmyk:
+      return DispatchDestination<T, Cmyk<T>>(conversion, destination);
+    case PixelKind::kCmyka:
+      return DispatchDestination<T, Cmyka<T>>(conversion, destination);
+    default:
+      return Status(StatusCode::kBadRequest,
+                    "Unsupported source pixel format");
+  }
+}
+}  // namespace
+
+template <ws::imaging::IsAllowedPixelNumericType T>
+Status ImageBufferConverter<T>::ConvertInterleavedBuffer(
+    std::span<const T> source, PixelFormat source_format,
+    std::span<T> destination, PixelFormat destination_format,
+    uint32_t width, uint32_t height, uint8_t bit_depth,
+    DigitalTvStudioEncodingRec rec) {
+  if (width == 0)
+    return Status(StatusCode::kBadRequest, "Width must be greater than 0");
+  if (height == 0)
+    return Status(StatusCode::kBadRequest, "Height must be greater than 0");
+  if (DetermineImageBufferType(bit_depth) != ImageBufferTypeOf<T>::value)
+    return Status(StatusCode::kBadRequest,
+                  "Bit depth does not match buffer type");
+
+  const PixelFormatDetails* source_details =
+      PixelFormatConstraints::GetFormat(source_format);
+  const PixelFormatDetails* destination_details =
+      PixelFormatConstraints::GetFormat(destination_format);
+  if (!source_details)
+    return Status(
+        StatusCode::kBadRequest,
+        "Unsupported pixel format " + PixelFormatToString(source_format));
+  if (!destination_details)
+    return Status(StatusCode::kBadRequest,
+                  "Unsupported pixel format " +
+                      PixelFormatToString(destination_format));
+
+  if ((source_details->layout & PixelLayoutFlag::kInterleaved) ==
+          static_cast<PixelLayoutFlag>(0) ||
+      (destination_details->layout & PixelLayoutFlag::kInterleaved) ==
+          static_cast<PixelLayoutFlag>(0))
+    return Status(StatusCode::kBadRequest,
+                  "Pixel format details must indicate interleaved layout");
+
+  const PixelKind source_kind = GetPixelKind(*source_details);
+  const PixelKind destination_kind = GetPixelKind(*destination_details);
+  if (source_kind == PixelKind::kUnsupported ||
+      destination_kind == PixelKind::kUnsupported)
+    return Status(StatusCode::kBadRequest,
+                  "Only unsubsampled pixel formats can be converted");
+
+  const std::size_t num_pixels = std::size_t{width} * height;
+  if (source.size() < num_pixels * source_details->components_order.size())
+    return Status(StatusCode::kBadRequest,
+                  "Source buffer is smaller than the image");
+  if (destination.size() <
+      num_pixels * destination_details->components_order.size())
+    return Status(StatusCode::kBadRequest,
+                  "Destination buffer is smaller than the image");
+
+  const BufferConversion<T> conversion = {
+      source.data(),
+      source_details->components_order,
+      destination.data(),
+      destination_details->components_order,
+      num_pixels,
+      kPixelsPerTask,
+      bit_depth,
+      rec};
+  return DispatchSource(conversion, source_kind, destination_kind);
+}
+
+template class ImageBufferConverter<uint8_t>;
+template class ImageBufferConverter<int8_t>;
+template class ImageBufferConverter<uint16_t>;
+template class ImageBufferConverter<int16_t>;
+template class ImageBufferConverter<uint32_t>;
+template class ImageBufferConverter<int32_t>;
+}  // namespace imaging
+}  // namespace ws
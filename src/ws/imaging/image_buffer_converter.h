@@ -0,0 +1,40 @@
+#pragma once
+
+#include <span>
+
+#include "ws/imaging/image_buffer_type.h"
+#include "ws/imaging/image_traits.h"
+#include "ws/imaging/pixel/pixel_color_converter.h"
+#include "ws/imaging/pixel/pixel_format.h"
+#include "ws/imaging/pixel/pixel_format_constraints.h"
+#include "ws/status/status.h"
+
+namespace ws {
+namespace imaging {
+/** Converts an interleaved buffer from one PixelFormat to another in a
+    single pass, without the intermediate Image that ImageBufferLoader,
+    an ImageConverter and ImageBufferExporter would build. Blocks of rows
+    are gathered into pixels, converted by the row kernel selected once
+    for the bit depth and rec, and scattered straight into the caller's
+    buffer, so each sample is read and written once.
+
+    Both formats must be interleaved and unsubsampled (4:4:4 or 4:0:0):
+    chroma resampling is not done here. The pair must have a PixelKernel,
+    or share a color model (e.g. RGB to BGRA is not supported, but RGBA
+    to BGRA is a reorder). */
+template <ws::imaging::IsAllowedPixelNumericType T>
+class ImageBufferConverter {
+ public:
+  /** destination must hold at least width * height pixels of
+      destination_format. */
+  static Status ConvertInterleavedBuffer(
+      std::span<const T> source, PixelFormat source_format,
+      std::span<T> destination, PixelFormat destination_format,
+      uint32_t width, uint32_t height, uint8_t bit_depth,
+      DigitalTvStudioEncodingRec rec = DigitalTvStudioEncodingRec::kBT2020);
+
+ private:
+  static constexpr std::size_t kPixelsPerTask = 1 << 16;
+};
+}  // namespace imaging
+}  // namespace ws
@@ -0,0 +1,80 @@
+#include "ws/imaging/image_buffer_converter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ws/imaging/pixel/color_formats/srgb/srgb_to_sycc_converter.h"
+
+namespace ws {
+namespace imaging {
+namespace {
+constexpr uint32_t kWidth = 37;
+constexpr uint32_t kHeight = 29;
+constexpr std::size_t kPixels = std::size_t{kWidth} * kHeight;
+
+template <typename T>
+std::vector<T> Ramp(std::size_t size) {
+  std::vector<T> samples(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    samples[i] = static_cast<T>(i * 7 + 3);
+  }
+  return samples;
+}
+
+TEST(ImageBufferConverterTest, CopiesSameFormatWithAlpha) {
+  const std::vector<uint16_t> rgba = Ramp<uint16_t>(kPixels * 4);
+  std::vector<uint16_t> out(rgba.size());
+  ASSERT_TRUE(ImageBufferConverter<uint16_t>::ConvertInterleavedBuffer(
+                  rgba, PixelFormat::kRgba, out, PixelFormat::kRgba, kWidth,
+                  kHeight, 16)
+                  .Ok());
+  EXPECT_EQ(out, rgba);
+}
+
+TEST(ImageBufferConverterTest, ReordersRgbaToBgra) {
+  const std::vector<uint8_t> rgba = Ramp<uint8_t>(kPixels * 4);
+  std::vector<uint8_t> bgra(rgba.size());
+  ASSERT_TRUE(ImageBufferConverter<uint8_t>::ConvertInterleavedBuffer(
+                  rgba, PixelFormat::kRgba, bgra, PixelFormat::kBgra, kWidth,
+                  kHeight, 8)
+                  .Ok());
+  for (std::size_t i = 0; i < kPixels; ++i) {
+    ASSERT_EQ(bgra[i * 4 + 0], rgba[i * 4 + 2]) << i;
+    ASSERT_EQ(bgra[i * 4 + 1], rgba[i * 4 + 1]) << i;
+    ASSERT_EQ(bgra[i * 4 + 2], rgba[i * 4 + 0]) << i;
+    ASSERT_EQ(bgra[i * 4 + 3], rgba[i * 4 + 3]) << i;
+  }
+}
+
+TEST(ImageBufferConverterTest, ConvertsRgbToI444LikeTheConverter) {
+  const std::vector<uint8_t> rgb = Ramp<uint8_t>(kPixels * 3);
+  std::vector<uint8_t> ycc(rgb.size());
+  ASSERT_TRUE(ImageBufferConverter<uint8_t>::ConvertInterleavedBuffer(
+                  rgb, PixelFormat::kRgb, ycc, PixelFormat::kI444, kWidth,
+                  kHeight, 8, DigitalTvStudioEncodingRec::kBT709)
+                  .Ok());
+  const SRgbToSYccConverter<uint8_t> converter(
+      8, DigitalTvStudioEncodingRec::kBT709);
+  for (std::size_t i = 0; i < kPixels; ++i) {
+    Ycc<uint8_t> expected;
+    converter.Convert({rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]}, expected);
+    ASSERT_EQ(ycc[i * 3 + 0], expected.y) << i;
+    ASSERT_EQ(ycc[i * 3 + 1], expected.cb) << i;
+    ASSERT_EQ(ycc[i * 3 + 2], expected.cr) << i;
+  }
+}
+
+TEST(ImageBufferConverterTest, RejectsShortDestination) {
+  const std::vector<uint8_t> rgb(kPixels * 3);
+  std::vector<uint8_t> out(kPixels * 3 - 1);
+  EXPECT_FALSE(ImageBufferConverter<uint8_t>::ConvertInterleavedBuffer(
+                   rgb, PixelFormat::kRgb, out, PixelFormat::kRgb, kWidth,
+                   kHeight, 8)
+                   .Ok());
+}
+}  // namespace
+}  // namespace imaging
+}  // namespace ws
@@ -1,6 +1,67 @@
 #include "ws/imaging/image_buffer_exporter.h"
+
+#include <vector>
+
+#include "ws/concurrency/thread_pool.h"
 namespace ws {
 namespace imaging {
+namespace {
+/** Reads the samples of a component in row order, following its stride;
+    views need not be contiguous. */
+template <typename T>
+class SampleReader {
+ public:
+  explicit SampleReader(const ImageComponent& component)
+      : buffer_(component.Buffer<T>()),
+        stride_(component.Stride()),
+        row_offset_(0),
+        x_(0),
+        width_(component.Width()),
+        sample_stride_(component.SampleStride()) {}
+
+  T Next() {
+    const T sample = buffer_[row_offset_ + x_ * sample_stride_];
+    if (++x_ == width_) {
+      x_ = 0;
+      row_offset_ += stride_;
+    }
+
+    return sample;
+  }
+
+ private:
+  const T* buffer_;
+  size_t stride_;
+  size_t row_offset_;
+  size_t x_;
+  size_t width_;
+  size_t sample_stride_;
+};
+
+/** Copies the samples of a component, row by row, to dst. */
+template <typename T>
+T* CopySamples(const ImageComponent& component, T* dst) {
+  if (component.IsContiguous()) {
+    std::memcpy(dst, component.Buffer<T>(), component.Length() * sizeof(T));
+    return dst + component.Length();
+  }
+
+  const size_t width = component.Width();
+  const size_t sample_stride = component.SampleStride();
+  for (size_t y = 0; y < component.Height(); ++y) {
+    const T* row = component.Row<T>(y);
+    if (sample_stride == 1) {
+      std::memcpy(dst, row, width * sizeof(T));
+    } else {
+      for (size_t x = 0; x < width; ++x) dst[x] = row[x * sample_stride];
+    }
+
+    dst += width;
+  }
+
+  return dst;
+}
+}  // namespace
 
 template <ws::imaging::IsAllowedPixelNumericType T>
 StatusOr<typename ImageBufferExporter<T>::container_type>
@@ -58,30 +119,39 @@ ImageBufferExporter<T>::ExportToInterleavedBuffer(const Image& image,
 
   auto components_order = pixel_format_details->components_order;
   const size_t num_components_order = components_order.size();
-  size_t comps_index[num_components] = {0};
-  T* comps_buffer_in_order[num_components_order];
-  size_t* comps_buffer_index_in_order[num_components_order];
-  for (size_t i = 0; i < num_components_order; ++i) {
-    uint8_t c = components_order[i];
-    comps_buffer_in_order[i] = components[c].Buffer<T>();
-    comps_buffer_index_in_order[i] = &comps_index[c];
-  }
+  bool contiguous = true;
+  for (const auto& comp : components) contiguous &= comp.IsContiguous();
 
   container_type buffer(image_size);
-  if (pixel_format_details->has_common_order) {
-    const size_t num_pixels = image_size / num_components;
-#pragma omp parallel for
-    for (size_t i = 0; i < num_pixels; ++i) {
-      for (size_t c = 0; c < num_components_order; ++c) {
-        buffer[i * num_components_order + c] = comps_buffer_in_order[c][i];
-      }
+  if (pixel_format_details->has_common_order && contiguous) {
+    T* comps_buffer_in_order[num_components_order];
+    for (size_t i = 0; i < num_components_order; ++i) {
+      comps_buffer_in_order[i] = components[components_order[i]].Buffer<T>();
     }
+
+    const size_t num_pixels = image_size / num_components;
+    T* const dst = buffer.data();
+    T* const* const src = comps_buffer_in_order;
+    ws::concurrency::ThreadPool::Default().ParallelFor<size_t>(
+        0, num_pixels, kPixelsPerTask, [&](size_t i) {
+          for (size_t c = 0; c < num_components_order; ++c) {
+            dst[i * num_components_order + c] = src[c][i];
+          }
+        });
   } else {
+    std::vector<SampleReader<T>> readers;
+    readers.reserve(num_components);
+    for (const auto& comp : components) readers.emplace_back(comp);
+
+    SampleReader<T>* readers_in_order[num_components_order];
+    for (size_t i = 0; i < num_components_order; ++i) {
+      readers_in_order[i] = &readers[components_order[i]];
+    }
+
     for (size_t offset = 0; offset < buffer.size();
          offset += num_components_order) {
       for (size_t i = 0; i < num_components_order; ++i) {
-        buffer[offset + i] =
-            comps_buffer_in_order[i][(*comps_buffer_index_in_order[i])++];
+        buffer[offset + i] = readers_in_order[i]->Next();
       }
     }
   }
@@ -148,10 +218,7 @@ ImageBufferExporter<T>::ExportToPlanarBuffer(const Image& image,
   container_type buffer(image_size);
   T* buffer_ptr = buffer.data();
   for (size_t i = 0; i < num_components_order; ++i) {
-    uint8_t c = components_order[i];
-    std::memcpy(buffer_ptr, components[c].Buffer<T>(),
-                components[c].Length() * sizeof(T));
-    buffer_ptr += components[c].Length();
+    buffer_ptr = CopySamples(components[components_order[i]], buffer_ptr);
   }
 
   return buffer;
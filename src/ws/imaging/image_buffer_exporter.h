@@ -20,6 +20,9 @@ class ImageBufferExporter {
       const Image& image, ws::imaging::PixelFormat pixel_format);
   static StatusOr<container_type> ExportToPlanarBuffer(
       const Image& image, ws::imaging::PixelFormat pixel_format);
+
+ private:
+  static constexpr std::size_t kPixelsPerTask = 1 << 16;
 };
 }  // namespace imaging
 }  // namespace ws
@@ -0,0 +1,144 @@
+#include "ws/imaging/image_buffer_exporter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "ws/imaging/image_buffer_loader.h"
+
+namespace ws {
+namespace imaging {
+namespace {
+constexpr uint32_t kWidth = 38;
+constexpr uint32_t kHeight = 30;
+constexpr uint32_t kChromaWidth = kWidth / 2;
+constexpr uint32_t kChromaHeight = kHeight / 2;
+// Both planes are padded past the end of their rows.
+constexpr std::size_t kLumaStride = kWidth + 6;
+constexpr std::size_t kChromaStride = kChromaWidth * 2 + 4;
+
+/** An NV12 frame with padded rows; padding samples are 0xEE so that a
+    reader which ignores the stride shows up in the output. */
+struct Nv12Frame {
+  Nv12Frame()
+      : y(kLumaStride * kHeight, 0xEE),
+        cbcr(kChromaStride * kChromaHeight, 0xEE) {
+    for (std::size_t row = 0; row < kHeight; ++row) {
+      for (std::size_t x = 0; x < kWidth; ++x) {
+        y[row * kLumaStride + x] = static_cast<uint8_t>(row * 5 + x);
+      }
+    }
+    for (std::size_t row = 0; row < kChromaHeight; ++row) {
+      for (std::size_t x = 0; x < kChromaWidth; ++x) {
+        cbcr[row * kChromaStride + x * 2] = static_cast<uint8_t>(row + x);
+        cbcr[row * kChromaStride + x * 2 + 1] =
+            static_cast<uint8_t>(200 - row - x);
+      }
+    }
+  }
+
+  /** The same samples packed as I420: Y, then Cb, then Cr. */
+  std::vector<uint8_t> I420() const {
+    std::vector<uint8_t> packed;
+    for (std::size_t row = 0; row < kHeight; ++row) {
+      for (std::size_t x = 0; x < kWidth; ++x) {
+        packed.push_back(y[row * kLumaStride + x]);
+      }
+    }
+    for (std::size_t c = 0; c < 2; ++c) {
+      for (std::size_t row = 0; row < kChromaHeight; ++row) {
+        for (std::size_t x = 0; x < kChromaWidth; ++x) {
+          packed.push_back(cbcr[row * kChromaStride + x * 2 + c]);
+        }
+      }
+    }
+    return packed;
+  }
+
+  StatusOr<Image> View(ws::Delegate<void()> release = nullptr) {
+    return ImageBufferLoader<uint8_t>::ViewNv12(
+        {y.data(), kLumaStride}, {cbcr.data(), kChromaStride}, kWidth,
+        kHeight, 8, std::move(release));
+  }
+
+  std::vector<uint8_t> y;
+  std::vector<uint8_t> cbcr;
+};
+
+TEST(ImageBufferExporterTest, Nv12ViewRoundTripsThroughI420) {
+  Nv12Frame frame;
+  StatusOr<Image> view = frame.View();
+  ASSERT_TRUE(view.Ok());
+  EXPECT_FALSE(view.Value().GetComponent(0).IsContiguous());
+  EXPECT_FALSE(view.Value().GetComponent(1).IsContiguous());
+  EXPECT_FALSE(view.Value().GetComponent(2).IsContiguous());
+
+  StatusOr<ImageBufferExporter<uint8_t>::container_type> exported =
+      ImageBufferExporter<uint8_t>::ExportToPlanarBuffer(view.Value(),
+                                                         PixelFormat::kI420);
+  ASSERT_TRUE(exported.Ok());
+  const std::vector<uint8_t> expected = frame.I420();
+  ASSERT_EQ(exported.Value().size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(exported.Value()[i], expected[i]) << i;
+  }
+
+  StatusOr<Image> loaded = ImageBufferLoader<uint8_t>::LoadFromPlanarBuffer(
+      std::span<const uint8_t>(exported.Value().data(),
+                               exported.Value().size()),
+      kWidth, kHeight, 8, PixelFormat::kI420);
+  ASSERT_TRUE(loaded.Ok());
+  for (uint8_t c = 0; c < 3; ++c) {
+    const ImageComponent& original = view.Value().GetComponent(c);
+    const ImageComponent& copy = loaded.Value().GetComponent(c);
+    ASSERT_TRUE(copy.IsContiguous());
+    ASSERT_EQ(copy.Width(), original.Width());
+    ASSERT_EQ(copy.Height(), original.Height());
+    for (std::size_t row = 0; row < original.Height(); ++row) {
+      for (std::size_t x = 0; x < original.Width(); ++x) {
+        ASSERT_EQ(copy.Row<uint8_t>(row)[x],
+                  original.Row<uint8_t>(row)[x * original.SampleStride()])
+            << static_cast<int>(c) << " " << row << " " << x;
+      }
+    }
+  }
+}
+
+TEST(ImageBufferExporterTest, ViewReleaseRunsOnceAfterLastComponent) {
+  Nv12Frame frame;
+  int releases = 0;
+  {
+    StatusOr<Image> view = frame.View([&releases] { ++releases; });
+    ASSERT_TRUE(view.Ok());
+    Image moved(std::move(view.Value()));
+    Image assigned;
+    assigned = std::move(moved);
+    EXPECT_EQ(releases, 0);
+
+    StatusOr<ImageBufferExporter<uint8_t>::container_type> exported =
+        ImageBufferExporter<uint8_t>::ExportToPlanarBuffer(
+            assigned, PixelFormat::kI420);
+    ASSERT_TRUE(exported.Ok());
+    EXPECT_EQ(releases, 0);
+  }
+
+  EXPECT_EQ(releases, 1);
+}
+
+TEST(ImageBufferExporterTest, ViewReleaseDoesNotRunOnFailure) {
+  Nv12Frame frame;
+  int releases = 0;
+  const StatusOr<Image> view = ImageBufferLoader<uint8_t>::ViewI420(
+      {frame.y.data(), kLumaStride}, {nullptr, kChromaWidth},
+      {frame.cbcr.data(), kChromaStride}, kWidth, kHeight, 8,
+      [&releases] { ++releases; });
+  EXPECT_FALSE(view.Ok());
+  EXPECT_EQ(releases, 0);
+}
+}  // namespace
+}  // namespace imaging
+}  // namespace ws
@@ -1,6 +1,48 @@
 #include "ws/imaging/image_buffer_loader.h"
+
+#include <memory>
+
+#include "ws/concurrency/thread_pool.h"
+
 namespace ws {
 namespace imaging {
+namespace {
+/** Shares one release among the components of a view: each component
+    holds a handle, and release runs when the last handle goes away,
+    provided Arm was called. Unarmed, as when building the image fails,
+    it never runs and the caller keeps the memory. */
+class SharedRelease {
+ public:
+  explicit SharedRelease(ws::Delegate<void()>&& release)
+      : state_(release ? std::make_shared<State>(std::move(release))
+                       : nullptr) {}
+
+  ws::Delegate<void()> Handle() const {
+    if (!state_) return nullptr;
+    return [state = state_] {};
+  }
+
+  void Arm() {
+    if (state_) state_->armed = true;
+  }
+
+ private:
+  struct State {
+    explicit State(ws::Delegate<void()>&& release)
+        : release(std::move(release)) {}
+
+    ~State() {
+      if (armed) release();
+    }
+
+    ws::Delegate<void()> release;
+    bool armed = false;
+  };
+
+  std::shared_ptr<State> state_;
+};
+}  // namespace
+
 template <ws::imaging::IsAllowedPixelNumericType T>
 StatusOr<Image> ImageBufferLoader<T>::LoadFromInterleavedBuffer(
     std::span<const T> buffer, uint32_t width, uint32_t height,
@@ -59,16 +101,18 @@ StatusOr<Image> ImageBufferLoader<T>::LoadFromInterleavedBuffer(
   }
 
   if (pixel_format_details->has_common_order) {
-#pragma omp parallel for
-    for (size_t c = 0; c < num_components; ++c) {
-      size_t dst_index = comps_index[c];
-      T* dst = comps_buffer_in_order[c];
-      for (size_t i = 0; i < components[c].Length(); ++i) {
-        dst[dst_index + i] = buffer[i * num_components + c];
-      }
+    size_t* const index = comps_index;
+    T* const* const dst_buffers = comps_buffer_in_order;
+    ws::concurrency::ThreadPool::Default().ParallelFor<size_t>(
+        0, num_components, 1, [&](size_t c) {
+          size_t dst_index = index[c];
+          T* dst = dst_buffers[c];
+          for (size_t i = 0; i < components[c].Length(); ++i) {
+            dst[dst_index + i] = buffer[i * num_components + c];
+          }
 
-      comps_index[c] += components[c].Length();
-    }
+          index[c] += components[c].Length();
+        });
   } else {
     for (size_t offset = 0; offset < buffer.size();
          offset += num_components_order) {
@@ -172,6 +216,141 @@ StatusOr<Image> ImageBufferLoader<T>::LoadFromPlanarBuffer(
                               pixel_format_details);
 }
 
+template <ws::imaging::IsAllowedPixelNumericType T>
+StatusOr<Image> ImageBufferLoader<T>::ViewPlanarBuffer(
+    std::span<T> buffer, uint32_t width, uint32_t height, uint8_t bit_depth,
+    PixelFormat pixel_format, ws::Delegate<void()> release) {
+  if (width == 0)
+    return Status(StatusCode::kBadRequest, "Width must be greater than 0");
+  if (height == 0)
+    return Status(StatusCode::kBadRequest, "Height must be greater than 0");
+  if (buffer.empty())
+    return Status(StatusCode::kBadRequest, "Buffer must not be empty");
+
+  const PixelFormatDetails* pixel_format_details =
+      PixelFormatConstraints::GetFormat(pixel_format);
+  if (!pixel_format_details)
+    return Status(
+        StatusCode::kBadRequest,
+        "Unsupported pixel format " + PixelFormatToString(pixel_format));
+
+  if ((pixel_format_details->layout & PixelLayoutFlag::kPlanar) ==
+      static_cast<PixelLayoutFlag>(0))
+    return Status(StatusCode::kBadRequest,
+                  "Pixel format details must indicate planar layout");
+
+  const uint8_t num_components = pixel_format_details->num_components;
+  PixelFormatConstraints::container_type dimensions =
+      PixelFormatConstraints::GetDimensions(
+          width, height, num_components,
+          pixel_format_details->chroma_subsampling,
+          pixel_format_details->HasAlpha());
+  if (dimensions.empty())
+    return Status(StatusCode::kBadRequest,
+                  "Unsupported dimensions for the given pixel format");
+
+  auto components_order = pixel_format_details->components_order;
+  size_t required = 0;
+  for (uint8_t c : components_order)
+    required += dimensions[c].x * dimensions[c].y;
+
+  if (buffer.size() < required)
+    return Status(StatusCode::kBadRequest,
+                  "Buffer is smaller than the image planes");
+
+  SharedRelease shared_release(std::move(release));
+  Image::container_type components(num_components);
+  T* buffer_ptr = buffer.data();
+  for (uint8_t c : components_order) {
+    const uint32_t comp_width = static_cast<uint32_t>(dimensions[c].x);
+    ASSIGN_OR_RETURN(components[c],
+                     ImageComponent::View<T>(
+                         buffer_ptr, comp_width,
+                         static_cast<uint32_t>(dimensions[c].y), comp_width,
+                         bit_depth, c == pixel_format_details->alpha_index, 1,
+                         shared_release.Handle()));
+    buffer_ptr += components[c].Length();
+  }
+
+  StatusOr<Image> image = Image::Create(
+      std::move(components), width, height, pixel_format_details->color_space,
+      pixel_format_details->chroma_subsampling);
+  if (image.Ok()) shared_release.Arm();
+  return image;
+}
+
+template <ws::imaging::IsAllowedPixelNumericType T>
+StatusOr<Image> ImageBufferLoader<T>::ViewI420(Plane y, Plane cb, Plane cr,
+                                               uint32_t width, uint32_t height,
+                                               uint8_t bit_depth,
+                                               ws::Delegate<void()> release) {
+  PixelFormatConstraints::container_type dimensions =
+      PixelFormatConstraints::GetDimensions(
+          width, height, 3, ChromaSubsampling::kSamp420, false);
+  if (dimensions.empty())
+    return Status(StatusCode::kBadRequest,
+                  "Unsupported dimensions for the given pixel format");
+
+  SharedRelease shared_release(std::move(release));
+  const Plane planes[3] = {y, cb, cr};
+  Image::container_type components(3);
+  for (size_t c = 0; c < 3; ++c) {
+    ASSIGN_OR_RETURN(components[c],
+                     ImageComponent::View<T>(
+                         planes[c].data, static_cast<uint32_t>(dimensions[c].x),
+                         static_cast<uint32_t>(dimensions[c].y),
+                         planes[c].stride, bit_depth, false, 1,
+                         shared_release.Handle()));
+  }
+
+  StatusOr<Image> image =
+      Image::Create(std::move(components), width, height, ColorSpace::kSYcc,
+                    ChromaSubsampling::kSamp420);
+  if (image.Ok()) shared_release.Arm();
+  return image;
+}
+
+template <ws::imaging::IsAllowedPixelNumericType T>
+StatusOr<Image> ImageBufferLoader<T>::ViewNv12(Plane y, Plane cbcr,
+                                               uint32_t width, uint32_t height,
+                                               uint8_t bit_depth,
+                                               ws::Delegate<void()> release) {
+  if (!cbcr.data)
+    return Status(StatusCode::kBadRequest, "Buffer must not be null");
+
+  PixelFormatConstraints::container_type dimensions =
+      PixelFormatConstraints::GetDimensions(
+          width, height, 3, ChromaSubsampling::kSamp420, false);
+  if (dimensions.empty())
+    return Status(StatusCode::kBadRequest,
+                  "Unsupported dimensions for the given pixel format");
+
+  SharedRelease shared_release(std::move(release));
+  const uint32_t chroma_width = static_cast<uint32_t>(dimensions[1].x);
+  const uint32_t chroma_height = static_cast<uint32_t>(dimensions[1].y);
+  Image::container_type components(3);
+  ASSIGN_OR_RETURN(components[0],
+                   ImageComponent::View<T>(y.data, width, height, y.stride,
+                                           bit_depth, false, 1,
+                                           shared_release.Handle()));
+  ASSIGN_OR_RETURN(components[1],
+                   ImageComponent::View<T>(cbcr.data, chroma_width,
+                                           chroma_height, cbcr.stride,
+                                           bit_depth, false, 2,
+                                           shared_release.Handle()));
+  ASSIGN_OR_RETURN(components[2],
+                   ImageComponent::View<T>(cbcr.data + 1, chroma_width,
+                                           chroma_height, cbcr.stride,
+                                           bit_depth, false, 2,
+                                           shared_release.Handle()));
+
+  StatusOr<Image> image =
+      Image::Create(std::move(components), width, height, ColorSpace::kSYcc,
+                    ChromaSubsampling::kSamp420);
+  if (image.Ok()) shared_release.Arm();
+  return image;
+}
+
 template class ImageBufferLoader<uint8_t>;
 template class ImageBufferLoader<int8_t>;
 template class ImageBufferLoader<uint16_t>;
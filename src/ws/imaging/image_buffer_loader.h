@@ -2,6 +2,7 @@
 
 #include <span>
 
+#include "ws/delegate.h"
 #include "ws/imaging/image.h"
 #include "ws/imaging/image_traits.h"
 #include "ws/imaging/pixel/pixel_format.h"
@@ -14,6 +15,13 @@ class ImageBufferLoader {
  public:
   using container_type = Array<T>;
 
+  /** A plane of caller-owned samples whose rows are stride samples
+      apart. */
+  struct Plane {
+    T* data;
+    size_t stride;
+  };
+
   static StatusOr<Image> LoadFromInterleavedBuffer(
       std::span<const T> buffer, uint32_t width, uint32_t height,
       uint8_t bit_depth,
@@ -28,6 +36,27 @@ class ImageBufferLoader {
   static StatusOr<Image> LoadFromPlanarBuffer(
       std::span<const T> buffer, uint32_t width, uint32_t height,
       uint8_t bit_depth, ws::imaging::PixelFormat pixel_format);
+
+  /** Borrows a packed planar buffer laid out as LoadFromPlanarBuffer
+      expects, instead of copying it. release, when set, runs once every
+      component of the image has been destroyed; until then the memory
+      must stay alive. On failure release does not run. The other View
+      functions follow the same rules. */
+  static StatusOr<Image> ViewPlanarBuffer(
+      std::span<T> buffer, uint32_t width, uint32_t height,
+      uint8_t bit_depth, ws::imaging::PixelFormat pixel_format,
+      ws::Delegate<void()> release = nullptr);
+  /** Borrows the Y, Cb and Cr planes of an I420 frame; chroma planes are
+      width / 2 by height / 2. */
+  static StatusOr<Image> ViewI420(Plane y, Plane cb, Plane cr,
+                                  uint32_t width, uint32_t height,
+                                  uint8_t bit_depth,
+                                  ws::Delegate<void()> release = nullptr);
+  /** Borrows the Y plane and the interleaved CbCr plane of an NV12
+      frame; the chroma components read every other sample of it. */
+  static StatusOr<Image> ViewNv12(Plane y, Plane cbcr, uint32_t width,
+                                  uint32_t height, uint8_t bit_depth,
+                                  ws::Delegate<void()> release = nullptr);
 };
 }  // namespace imaging
 }  // namespace ws
@@ -1,10 +1,23 @@
 #include "ws/imaging/image_component.h"
 namespace ws {
 namespace imaging {
+template <typename T>
+void ImageComponent::ReturnToPool(void* owner, void* buffer, offset_t length) {
+  static_cast<ws::pooling::ArrayPool<T>*>(owner)->Return(
+      static_cast<T*>(buffer), static_cast<size_t>(length));
+}
+
+void ImageComponent::ReleaseView(void* owner, void*, offset_t) {
+  if (!owner) return;
+  auto* release = static_cast<ws::Delegate<void()>*>(owner);
+  if (*release) (*release)();
+  delete release;
+}
+
 template <ws::imaging::IsAllowedPixelNumericType T>
-StatusOr<ImageComponent> ImageComponent::Create(uint32_t width, offset_t length,
-                                                uint8_t bit_depth,
-                                                bool is_alpha) {
+StatusOr<ImageComponent> ImageComponent::Create(
+    uint32_t width, offset_t length, uint8_t bit_depth, bool is_alpha,
+    ws::pooling::ArrayPool<T>* pool) {
   static_assert(
       std::is_same_v<
           T, typename ImageBufferTypeTraits<ImageBufferTypeOf<T>::value>::type>,
@@ -23,32 +36,93 @@ StatusOr<ImageComponent> ImageComponent::Create(uint32_t width, offset_t length,
     return Status(StatusCode::kBadRequest,
                   "Bit depth does not match buffer type");
 
+  if (pool) {
+    void* buf = static_cast<void*>(pool->Rent(static_cast<size_t>(length)));
+    ImageComponent component(buf, width, length, bit_depth, is_alpha,
+                             ImageBufferTypeOf<T>::value);
+    component.release_ = &ReturnToPool<T>;
+    component.owner_ = pool;
+    return component;
+  }
+
   void* buf = static_cast<void*>(new T[length]);
   return ImageComponent(buf, width, length, bit_depth, is_alpha,
                         ImageBufferTypeOf<T>::value);
 }
 
+template <ws::imaging::IsAllowedPixelNumericType T>
+StatusOr<ImageComponent> ImageComponent::View(T* buffer, uint32_t width,
+                                              uint32_t height, size_t stride,
+                                              uint8_t bit_depth, bool is_alpha,
+                                              uint8_t sample_stride,
+                                              ws::Delegate<void()> release) {
+  static_assert(
+      std::is_same_v<
+          T, typename ImageBufferTypeTraits<ImageBufferTypeOf<T>::value>::type>,
+      "Unsupported buffer type");
+
+  if (!buffer)
+    return Status(StatusCode::kBadRequest, "Buffer must not be null");
+  if (width == 0)
+    return Status(StatusCode::kBadRequest, "Width must be greater than 0");
+  if (height == 0)
+    return Status(StatusCode::kBadRequest, "Height must be greater than 0");
+  if (sample_stride == 0)
+    return Status(StatusCode::kBadRequest,
+                  "Sample stride must be greater than 0");
+  if (stride < (size_t{width} - 1) * sample_stride + 1)
+    return Status(StatusCode::kBadRequest, "Stride is shorter than a row");
+  if (bit_depth <= 0)
+    return Status(StatusCode::kBadRequest, "Bit depth must be greater than 0");
+
+  if (DetermineImageBufferType(bit_depth) != ImageBufferTypeOf<T>::value)
+    return Status(StatusCode::kBadRequest,
+                  "Bit depth does not match buffer type");
+
+  ImageComponent component(static_cast<void*>(buffer), width,
+                           offset_t{width} * height, bit_depth, is_alpha,
+                           ImageBufferTypeOf<T>::value);
+  component.stride_ = stride;
+  component.sample_stride_ = sample_stride;
+  component.release_ = &ReleaseView;
+  if (release) component.owner_ = new ws::Delegate<void()>(std::move(release));
+
+  return component;
+}
+
 ImageComponent::ImageComponent()
     : buffer_(nullptr),
+      release_(nullptr),
+      owner_(nullptr),
       width_(0),
       length_(0),
       height_(0),
+      stride_(0),
+      sample_stride_(1),
       bit_depth_(0),
       is_alpha_(false),
       buffer_type_(ImageBufferType::kUnknown) {}
 
 ImageComponent::ImageComponent(ImageComponent&& other) noexcept
     : buffer_(other.buffer_),
+      release_(other.release_),
+      owner_(other.owner_),
       width_(other.width_),
       length_(other.length_),
       height_(other.height_),
+      stride_(other.stride_),
+      sample_stride_(other.sample_stride_),
       bit_depth_(other.bit_depth_),
       is_alpha_(other.is_alpha_),
       buffer_type_(other.buffer_type_) {
   other.buffer_ = nullptr;
+  other.release_ = nullptr;
+  other.owner_ = nullptr;
   other.width_ = 0;
   other.length_ = 0;
   other.height_ = 0;
+  other.stride_ = 0;
+  other.sample_stride_ = 1;
   other.bit_depth_ = 0;
   other.is_alpha_ = false;
   other.buffer_type_ = ImageBufferType::kUnknown;
@@ -56,18 +130,28 @@ ImageComponent::ImageComponent(ImageComponent&& other) noexcept
 
 ImageComponent& ImageComponent::operator=(ImageComponent&& other) noexcept {
   if (this != &other) {
+    FreeBuffer();
+
     buffer_ = other.buffer_;
+    release_ = other.release_;
+    owner_ = other.owner_;
     width_ = other.width_;
     length_ = other.length_;
     height_ = other.height_;
+    stride_ = other.stride_;
+    sample_stride_ = other.sample_stride_;
     bit_depth_ = other.bit_depth_;
     is_alpha_ = other.is_alpha_;
     buffer_type_ = other.buffer_type_;
 
     other.buffer_ = nullptr;
+    other.release_ = nullptr;
+    other.owner_ = nullptr;
     other.width_ = 0;
     other.length_ = 0;
     other.height_ = 0;
+    other.stride_ = 0;
+    other.sample_stride_ = 1;
     other.bit_depth_ = 0;
     other.is_alpha_ = false;
     other.buffer_type_ = ImageBufferType::kUnknown;
@@ -89,15 +173,27 @@ ImageComponent::ImageComponent(void* buffer, uint32_t width, offset_t length,
                                uint8_t bit_depth, bool is_alpha,
                                ImageBufferType type)
     : buffer_(buffer),
+      release_(nullptr),
+      owner_(nullptr),
       width_(width),
       length_(length),
       height_(length / width),
+      stride_(width),
+      sample_stride_(1),
       bit_depth_(bit_depth),
       is_alpha_(is_alpha),
       buffer_type_(type) {}
 
 void ImageComponent::FreeBuffer() {
   if (!buffer_) return;
+  if (release_) {
+    release_(owner_, buffer_, length_);
+    buffer_ = nullptr;
+    release_ = nullptr;
+    owner_ = nullptr;
+    return;
+  }
+
   switch (buffer_type_) {
     case ImageBufferType::kUInt8:
       delete[] static_cast<uint8_t*>(buffer_);
@@ -126,33 +222,42 @@ void ImageComponent::Dispose() {
   width_ = 0;
   length_ = 0;
   height_ = 0;
+  stride_ = 0;
+  sample_stride_ = 1;
   bit_depth_ = 0;
   is_alpha_ = false;
   buffer_type_ = ImageBufferType::kUnknown;
 }
 
-template StatusOr<ImageComponent> ImageComponent::Create<int8_t>(uint32_t,
-                                                                 offset_t,
-                                                                 uint8_t, bool);
-template StatusOr<ImageComponent> ImageComponent::Create<uint8_t>(uint32_t,
-                                                                  offset_t,
-                                                                  uint8_t,
-                                                                  bool);
-template StatusOr<ImageComponent> ImageComponent::Create<int16_t>(uint32_t,
-                                                                  offset_t,
-                                                                  uint8_t,
-                                                                  bool);
-template StatusOr<ImageComponent> ImageComponent::Create<uint16_t>(uint32_t,
-                                                                   offset_t,
-                                                                   uint8_t,
-                                                                   bool);
-template StatusOr<ImageComponent> ImageComponent::Create<int32_t>(uint32_t,
-                                                                  offset_t,
-                                                                  uint8_t,
-                                                                  bool);
-template StatusOr<ImageComponent> ImageComponent::Create<uint32_t>(uint32_t,
-                                                                   offset_t,
-                                                                   uint8_t,
-                                                                   bool);
+template StatusOr<ImageComponent> ImageComponent::Create<int8_t>(
+    uint32_t, offset_t, uint8_t, bool, ws::pooling::ArrayPool<int8_t>*);
+template StatusOr<ImageComponent> ImageComponent::Create<uint8_t>(
+    uint32_t, offset_t, uint8_t, bool, ws::pooling::ArrayPool<uint8_t>*);
+template StatusOr<ImageComponent> ImageComponent::Create<int16_t>(
+    uint32_t, offset_t, uint8_t, bool, ws::pooling::ArrayPool<int16_t>*);
+template StatusOr<ImageComponent> ImageComponent::Create<uint16_t>(
+    uint32_t, offset_t, uint8_t, bool, ws::pooling::ArrayPool<uint16_t>*);
+template StatusOr<ImageComponent> ImageComponent::Create<int32_t>(
+    uint32_t, offset_t, uint8_t, bool, ws::pooling::ArrayPool<int32_t>*);
+template StatusOr<ImageComponent> ImageComponent::Create<uint32_t>(
+    uint32_t, offset_t, uint8_t, bool, ws::pooling::ArrayPool<uint32_t>*);
+template StatusOr<ImageComponent> ImageComponent::View<int8_t>(
+    int8_t*, uint32_t, uint32_t, size_t, uint8_t, bool, uint8_t,
+    ws::Delegate<void()>);
+template StatusOr<ImageComponent> ImageComponent::View<uint8_t>(
+    uint8_t*, uint32_t, uint32_t, size_t, uint8_t, bool, uint8_t,
+    ws::Delegate<void()>);
+template StatusOr<ImageComponent> ImageComponent::View<int16_t>(
+    int16_t*, uint32_t, uint32_t, size_t, uint8_t, bool, uint8_t,
+    ws::Delegate<void()>);
+template StatusOr<ImageComponent> ImageComponent::View<uint16_t>(
+    uint16_t*, uint32_t, uint32_t, size_t, uint8_t, bool, uint8_t,
+    ws::Delegate<void()>);
+template StatusOr<ImageComponent> ImageComponent::View<int32_t>(
+    int32_t*, uint32_t, uint32_t, size_t, uint8_t, bool, uint8_t,
+    ws::Delegate<void()>);
+template StatusOr<ImageComponent> ImageComponent::View<uint32_t>(
+    uint32_t*, uint32_t, uint32_t, size_t, uint8_t, bool, uint8_t,
+    ws::Delegate<void()>);
 }  // namespace imaging
 }  // namespace ws
@@ -6,8 +6,10 @@
 #include <cstdint>
 
 #include "ws/array.h"
+#include "ws/delegate.h"
 #include "ws/imaging/image_buffer_type.h"
 #include "ws/imaging/pixel/pixel_allowed_types.h"
+#include "ws/pooling/array_pool.h"
 #include "ws/status/status_or.h"
 #include "ws/string/format.h"
 #include "ws/types.h"
@@ -15,10 +17,25 @@ namespace ws {
 namespace imaging {
 class ImageComponent {
  public:
+  /** When pool is set the buffer is rented from it and returned to it when
+      the component is destroyed; the pool must outlive the component. */
   template <ws::imaging::IsAllowedPixelNumericType T>
-  static StatusOr<ImageComponent> Create(uint32_t width, offset_t length,
-                                         uint8_t bit_depth,
-                                         bool is_alpha = false);
+  static StatusOr<ImageComponent> Create(
+      uint32_t width, offset_t length, uint8_t bit_depth,
+      bool is_alpha = false, ws::pooling::ArrayPool<T>* pool = nullptr);
+
+  /** Borrows width x height samples of caller-owned memory without
+      copying. Row y starts stride samples after row y - 1, and the
+      samples of a row are sample_stride apart, which lets a view address
+      one channel of an interleaved plane such as NV12 chroma. release,
+      when set, runs once the component is destroyed; until then the
+      caller must keep the memory alive. */
+  template <ws::imaging::IsAllowedPixelNumericType T>
+  static StatusOr<ImageComponent> View(T* buffer, uint32_t width,
+                                       uint32_t height, size_t stride,
+                                       uint8_t bit_depth, bool is_alpha = false,
+                                       uint8_t sample_stride = 1,
+                                       ws::Delegate<void()> release = nullptr);
 
   ImageComponent();
   ImageComponent(const ImageComponent&) = delete;
@@ -26,34 +43,57 @@ class ImageComponent {
   ImageComponent& operator=(const ImageComponent&) = delete;
   ImageComponent& operator=(ImageComponent&&) noexcept;
 
+  /** The samples as one flat array; only valid when IsContiguous(). */
   template <ws::imaging::IsAllowedPixelNumericType T>
   operator T*() const;
 
   ~ImageComponent();
 
   constexpr uint32_t Width() const;
+  /** Samples in the component, width x height, whatever the stride. They
+      fill Buffer()[0, Length()) only when IsContiguous(). */
   constexpr size_t Length() const;
   constexpr size_t Height() const;
   constexpr uint8_t BitDepth() const;
   constexpr bool IsAlpha() const;
+  /** Distance between the starts of two rows, in samples. */
+  constexpr size_t Stride() const;
+  /** Distance between two samples of a row, in samples. */
+  constexpr uint8_t SampleStride() const;
+  /** Whether the samples are packed row after row, so that sample i is
+      Buffer()[i]. Owned components always are. */
+  constexpr bool IsContiguous() const;
   constexpr bool Empty() const;
   constexpr bool IsValid() const;
   std::string ToString() const;
   constexpr ImageBufferType GetBufferType() const;
+  /** The first sample. A view may be strided, so code that indexes the
+      buffer flat must check IsContiguous() first and otherwise walk Row()
+      in steps of SampleStride(). */
   template <ws::imaging::IsAllowedPixelNumericType T>
   T* Buffer() const;
+  template <ws::imaging::IsAllowedPixelNumericType T>
+  T* Row(size_t y) const;
 
  private:
   ImageComponent(void* buffer, uint32_t width, offset_t length,
                  uint8_t bit_depth, bool is_alpha, ImageBufferType type);
 
+  template <typename T>
+  static void ReturnToPool(void* owner, void* buffer, offset_t length);
+  static void ReleaseView(void* owner, void* buffer, offset_t length);
+
   void FreeBuffer();
   void Dispose();
 
   void* buffer_;
+  void (*release_)(void* owner, void* buffer, offset_t length);
+  void* owner_;
   uint32_t width_;
   uint32_t height_;
   offset_t length_;
+  size_t stride_;
+  uint8_t sample_stride_;
   uint8_t bit_depth_;
   bool is_alpha_;
   ImageBufferType buffer_type_;
@@ -73,6 +113,16 @@ inline constexpr uint8_t ImageComponent::BitDepth() const { return bit_depth_; }
 
 inline constexpr bool ImageComponent::IsAlpha() const { return is_alpha_; }
 
+inline constexpr size_t ImageComponent::Stride() const { return stride_; }
+
+inline constexpr uint8_t ImageComponent::SampleStride() const {
+  return sample_stride_;
+}
+
+inline constexpr bool ImageComponent::IsContiguous() const {
+  return stride_ == width_ && sample_stride_ == 1;
+}
+
 inline constexpr bool ImageComponent::Empty() const {
   return buffer_ == nullptr;
 }
@@ -94,8 +144,15 @@ inline T* ImageComponent::Buffer() const {
   return static_cast<T*>(buffer_);
 }
 
+template <ws::imaging::IsAllowedPixelNumericType T>
+inline T* ImageComponent::Row(size_t y) const {
+  assert(y < height_ && "Row out of range");
+  return Buffer<T>() + y * stride_;
+}
+
 template <ws::imaging::IsAllowedPixelNumericType T>
 inline ImageComponent::operator T*() const {
+  assert(IsContiguous() && "Component is not contiguous");
   return Buffer<T>();
 }
 
@@ -5,7 +5,7 @@
 #include <string>
 #include <string_view>
 
-#include "ws/concurrency/concurrent_unordered_map.h"
+#include "ws/concurrency/concurrent_flat_map.h"
 #include "ws/string/format.h"
 #include "ws/string/string_hash.h"
 
@@ -18,7 +18,7 @@ class ImageContext {
   using key_view_type = std::string_view;
   using mapped_type = std::int32_t;
   using map_type =
-      concurrent_unordered_map<key_type, mapped_type, StringHash, StringEqual>;
+      concurrent_flat_map<key_type, mapped_type, StringHash, StringEqual>;
 
   ImageContext();
   ImageContext(const map_type& tags);
@@ -1,9 +1,12 @@
 #pragma once
+#include <span>
 #include <string>
+#include <vector>
 
 #include "ws/imaging/image.h"
 #include "ws/imaging/image_context.h"
 #include "ws/imaging/image_traits.h"
+#include "ws/imaging/pixel/pixel_converter.h"
 #include "ws/logging/ilogger.h"
 
 namespace ws {
@@ -37,6 +40,27 @@ class ImageConverter {
   uint8_t alignment_;
 };
 
+/** Hands out the rows of a component as packed spans of Width() samples,
+    whatever its Stride() and SampleStride(). A row whose samples are
+    adjacent is returned in place; any other is gathered into scratch
+    first, so a span is only valid until the next call to Row. */
+template <ws::imaging::IsAllowedPixelNumericType T>
+class ComponentRows {
+ public:
+  explicit ComponentRows(const ImageComponent& component);
+
+  constexpr size_t Height() const;
+  std::span<const T> Row(size_t y);
+
+ private:
+  const ImageComponent* component_;
+  std::vector<T> scratch_;
+};
+
+/** Derived implements InnerConvert<T>(source, alignment). Source
+    components may be strided views, such as the chroma of an NV12 frame,
+    so InnerConvert reads them row by row through ComponentRows rather
+    than indexing Buffer<T>() flat. */
 template <typename Derived>
 class TypedImageConverter : public ImageConverter {
  public:
@@ -45,6 +69,15 @@ class TypedImageConverter : public ImageConverter {
 
   StatusOr<Image> Convert(const Image& source) const final;
 
+ protected:
+  /** Picks the monomorphized row kernel for the source's bit depth and
+      rec. Meant to be called once per image from InnerConvert, so that
+      no per-pixel dispatch remains in the component loops. */
+  template <IsAllowedColorFormat TSrc, IsAllowedColorFormat TDst>
+  static StatusOr<PixelRowKernel<TSrc, TDst>> SelectRowKernel(
+      uint8_t bit_depth,
+      DigitalTvStudioEncodingRec rec = DigitalTvStudioEncodingRec::kBT2020);
+
  private:
   template <typename T>
   StatusOr<Image> DispatchType(const Image& source) const;
@@ -67,6 +100,32 @@ inline constexpr ChromaSubsampling ImageConverter::GetChromaSubsampling()
   return chroma_subsampling_;
 }
 
+// ============================================================================
+// Implementation details for ComponentRows<T>
+// ============================================================================
+
+template <ws::imaging::IsAllowedPixelNumericType T>
+inline ComponentRows<T>::ComponentRows(const ImageComponent& component)
+    : component_(&component) {
+  if (component.SampleStride() != 1) scratch_.resize(component.Width());
+}
+
+template <ws::imaging::IsAllowedPixelNumericType T>
+inline constexpr size_t ComponentRows<T>::Height() const {
+  return component_->Height();
+}
+
+template <ws::imaging::IsAllowedPixelNumericType T>
+inline std::span<const T> ComponentRows<T>::Row(size_t y) {
+  const T* row = component_->Row<T>(y);
+  const size_t width = component_->Width();
+  if (scratch_.empty()) return {row, width};
+
+  const size_t sample_stride = component_->SampleStride();
+  for (size_t x = 0; x < width; ++x) scratch_[x] = row[x * sample_stride];
+  return scratch_;
+}
+
 // ============================================================================
 // Implementation details for TypedImageConverter<T>
 // ============================================================================
@@ -90,6 +149,20 @@ inline StatusOr<Image> TypedImageConverter<Derived>::DispatchType(
       source, this->alignment_);
 }
 
+template <typename Derived>
+template <IsAllowedColorFormat TSrc, IsAllowedColorFormat TDst>
+inline StatusOr<PixelRowKernel<TSrc, TDst>>
+TypedImageConverter<Derived>::SelectRowKernel(
+    uint8_t bit_depth, DigitalTvStudioEncodingRec rec) {
+  const PixelRowKernel<TSrc, TDst> kernel =
+      SelectPixelRowKernel<TSrc, TDst>(bit_depth, rec);
+  if (!kernel)
+    return Status(StatusCode::kBadRequest,
+                  "No pixel kernel for this bit depth and format pair");
+
+  return kernel;
+}
+
 template <typename Derived>
 inline StatusOr<Image> TypedImageConverter<Derived>::DispatchConvert(
     const Image& source) const {
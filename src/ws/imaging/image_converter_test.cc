@@ -0,0 +1,121 @@
+#include "ws/imaging/image_converter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "ws/imaging/image_buffer_loader.h"
+
+namespace ws {
+namespace imaging {
+namespace {
+constexpr uint32_t kWidth = 38;
+constexpr uint32_t kHeight = 30;
+constexpr uint32_t kChromaWidth = kWidth / 2;
+constexpr uint32_t kChromaHeight = kHeight / 2;
+constexpr std::size_t kLumaStride = kWidth + 6;
+constexpr std::size_t kChromaStride = kChromaWidth * 2 + 4;
+
+/** Copies every source component into an owned, packed one, reading the
+    source only through ComponentRows. */
+class PackingConverter : public TypedImageConverter<PackingConverter> {
+ public:
+  PackingConverter()
+      : TypedImageConverter(ColorSpace::kSYcc, ChromaSubsampling::kSamp420,
+                            3) {}
+
+  template <typename T>
+  StatusOr<Image> InnerConvert(const Image& source, uint8_t) const {
+    Image::container_type components(source.NumComponents());
+    for (uint8_t c = 0; c < source.NumComponents(); ++c) {
+      const ImageComponent& src = source.GetComponent(c);
+      ASSIGN_OR_RETURN(components[c],
+                       ImageComponent::Create<T>(src.Width(), src.Length(),
+                                                 src.BitDepth()));
+      ComponentRows<T> rows(src);
+      for (size_t y = 0; y < rows.Height(); ++y) {
+        const std::span<const T> row = rows.Row(y);
+        std::copy(row.begin(), row.end(), components[c].Row<T>(y));
+      }
+    }
+
+    return Image::Create(std::move(components), source.Width(),
+                         source.Height(), color_space_, chroma_subsampling_);
+  }
+};
+
+/** Planes with padded rows whose padding samples are 0xEE, so a converter
+    that ignores the stride shows up in its output. The chroma plane is
+    interleaved CbCr for NV12 and holds Cb then Cr rows for I420. */
+struct PaddedFrame {
+  PaddedFrame()
+      : y(kLumaStride * kHeight, 0xEE),
+        chroma(kChromaStride * kChromaHeight * 2, 0xEE) {
+    for (std::size_t row = 0; row < kHeight; ++row) {
+      for (std::size_t x = 0; x < kWidth; ++x) {
+        y[row * kLumaStride + x] = static_cast<uint8_t>(row * 5 + x);
+      }
+    }
+    for (std::size_t row = 0; row < chroma.size() / kChromaStride; ++row) {
+      for (std::size_t x = 0; x < kChromaWidth * 2; ++x) {
+        chroma[row * kChromaStride + x] = static_cast<uint8_t>(row * 3 + x);
+      }
+    }
+  }
+
+  std::vector<uint8_t> y;
+  std::vector<uint8_t> chroma;
+};
+
+void ExpectPackedCopy(const Image& view, const Image& converted) {
+  ASSERT_EQ(converted.NumComponents(), view.NumComponents());
+  for (uint8_t c = 0; c < view.NumComponents(); ++c) {
+    const ImageComponent& original = view.GetComponent(c);
+    const ImageComponent& copy = converted.GetComponent(c);
+    ASSERT_TRUE(copy.IsContiguous());
+    ASSERT_EQ(copy.Width(), original.Width());
+    ASSERT_EQ(copy.Height(), original.Height());
+    for (std::size_t row = 0; row < original.Height(); ++row) {
+      for (std::size_t x = 0; x < original.Width(); ++x) {
+        ASSERT_EQ(copy.Row<uint8_t>(row)[x],
+                  original.Row<uint8_t>(row)[x * original.SampleStride()])
+            << static_cast<int>(c) << " " << row << " " << x;
+      }
+    }
+  }
+}
+
+TEST(ImageConverterTest, ConvertsNv12View) {
+  PaddedFrame frame;
+  const StatusOr<Image> view = ImageBufferLoader<uint8_t>::ViewNv12(
+      {frame.y.data(), kLumaStride}, {frame.chroma.data(), kChromaStride},
+      kWidth, kHeight, 8);
+  ASSERT_TRUE(view.Ok());
+  EXPECT_EQ(view.Value().GetComponent(1).SampleStride(), 2);
+
+  const StatusOr<Image> converted = PackingConverter().Convert(view.Value());
+  ASSERT_TRUE(converted.Ok());
+  ExpectPackedCopy(view.Value(), converted.Value());
+}
+
+TEST(ImageConverterTest, ConvertsPaddedI420View) {
+  PaddedFrame frame;
+  uint8_t* const cr = frame.chroma.data() + kChromaStride * kChromaHeight;
+  const StatusOr<Image> view = ImageBufferLoader<uint8_t>::ViewI420(
+      {frame.y.data(), kLumaStride}, {frame.chroma.data(), kChromaStride},
+      {cr, kChromaStride}, kWidth, kHeight, 8);
+  ASSERT_TRUE(view.Ok());
+  EXPECT_FALSE(view.Value().GetComponent(1).IsContiguous());
+
+  const StatusOr<Image> converted = PackingConverter().Convert(view.Value());
+  ASSERT_TRUE(converted.Ok());
+  ExpectPackedCopy(view.Value(), converted.Value());
+}
+}  // namespace
+}  // namespace imaging
+}  // namespace ws
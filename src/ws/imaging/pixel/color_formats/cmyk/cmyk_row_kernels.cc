@@ -0,0 +1,453 @@
+#include "ws/imaging/pixel/color_formats/cmyk/cmyk_row_kernels.h"
+
+#include <bit>
+#include <cassert>
+#include <type_traits>
+
+#include "ws/machine.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#include <immintrin.h>
+#define WSCOMMON_CMYK_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+// The RGB to CMYK kernel needs vdivq_f32, which 32-bit NEON lacks.
+#include <arm_neon.h>
+#define WSCOMMON_CMYK_NEON 1
+#endif
+
+namespace ws {
+namespace imaging {
+namespace internal {
+namespace {
+template <typename T>
+void CmykToRgbScalar(const T* c, const T* m, const T* y, const T* k, T* r,
+                     T* g, T* b, std::size_t begin, std::size_t count,
+                     uint32_t max_value, int bits) {
+  for (std::size_t i = begin; i < count; ++i) {
+    r[i] = static_cast<T>(CmykToRgbSample(c[i], k[i], max_value, bits));
+    g[i] = static_cast<T>(CmykToRgbSample(m[i], k[i], max_value, bits));
+    b[i] = static_cast<T>(CmykToRgbSample(y[i], k[i], max_value, bits));
+  }
+}
+
+template <typename T>
+void RgbToCmykScalar(const T* r, const T* g, const T* b, T* c, T* m, T* y,
+                     T* k, std::size_t begin, std::size_t count,
+                     uint32_t max_value) {
+  const float max = static_cast<float>(max_value);
+  for (std::size_t i = begin; i < count; ++i) {
+    const uint32_t sr = ClampSample(r[i], max_value);
+    const uint32_t sg = ClampSample(g[i], max_value);
+    const uint32_t sb = ClampSample(b[i], max_value);
+    const uint32_t top = std::max({sr, sg, sb});
+    c[i] = static_cast<T>(ScaleQuotient(top - sr, top, max));
+    m[i] = static_cast<T>(ScaleQuotient(top - sg, top, max));
+    y[i] = static_cast<T>(ScaleQuotient(top - sb, top, max));
+    k[i] = static_cast<T>(max_value - top);
+  }
+}
+
+#if defined(WSCOMMON_CMYK_X86)
+// Both element types are widened to 16-bit lanes. Products and quotients
+// are formed in 32-bit lanes and narrowed back through a -32768 bias,
+// since SSE2 only has a signed 32-to-16 pack.
+WSCOMMON_TARGET_SSE2 inline __m128i Sse2Load(const uint8_t* p) {
+  return _mm_unpacklo_epi8(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)),
+      _mm_setzero_si128());
+}
+
+WSCOMMON_TARGET_SSE2 inline __m128i Sse2Load(const uint16_t* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+WSCOMMON_TARGET_SSE2 inline void Sse2Store(uint8_t* p, __m128i v) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(v, v));
+}
+
+WSCOMMON_TARGET_SSE2 inline void Sse2Store(uint16_t* p, __m128i v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+WSCOMMON_TARGET_SSE2 inline __m128i Sse2Narrow(__m128i lo, __m128i hi) {
+  const __m128i bias32 = _mm_set1_epi32(32768);
+  const __m128i bias16 = _mm_set1_epi16(-32768);
+  return _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(lo, bias32),
+                                       _mm_sub_epi32(hi, bias32)),
+                       bias16);
+}
+
+WSCOMMON_TARGET_SSE2 inline __m128i Sse2Min(__m128i v, __m128i max) {
+  return _mm_sub_epi16(v, _mm_subs_epu16(v, max));
+}
+
+WSCOMMON_TARGET_SSE2 inline __m128i Sse2ScaleProduct(__m128i a, __m128i b,
+                                                     __m128i half,
+                                                     __m128i bits) {
+  const __m128i low = _mm_mullo_epi16(a, b);
+  const __m128i high = _mm_mulhi_epu16(a, b);
+  __m128i lo = _mm_add_epi32(_mm_unpacklo_epi16(low, high), half);
+  __m128i hi = _mm_add_epi32(_mm_unpackhi_epi16(low, high), half);
+  lo = _mm_srl_epi32(_mm_add_epi32(lo, _mm_srl_epi32(lo, bits)), bits);
+  hi = _mm_srl_epi32(_mm_add_epi32(hi, _mm_srl_epi32(hi, bits)), bits);
+  return Sse2Narrow(lo, hi);
+}
+
+WSCOMMON_TARGET_SSE2 inline __m128 Sse2Quotient(__m128i a, __m128 top,
+                                                __m128 max) {
+  return _mm_add_ps(_mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(a), max), top),
+                    _mm_set1_ps(0.5f));
+}
+
+WSCOMMON_TARGET_SSE2 inline __m128i Sse2ScaleQuotient(__m128i a,
+                                                      __m128 top_lo,
+                                                      __m128 top_hi,
+                                                      __m128 max) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i lo = _mm_cvttps_epi32(
+      Sse2Quotient(_mm_unpacklo_epi16(a, zero), top_lo, max));
+  const __m128i hi = _mm_cvttps_epi32(
+      Sse2Quotient(_mm_unpackhi_epi16(a, zero), top_hi, max));
+  return Sse2Narrow(lo, hi);
+}
+
+template <typename T>
+WSCOMMON_TARGET_SSE2 std::size_t CmykToRgbSse2(
+    const T* c, const T* m, const T* y, const T* k, T* r, T* g, T* b,
+    std::size_t count, uint32_t max_value, int bits) {
+  const __m128i max = _mm_set1_epi16(static_cast<int16_t>(max_value));
+  const __m128i half = _mm_set1_epi32(1 << (bits - 1));
+  const __m128i shift = _mm_cvtsi32_si128(bits);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i white = _mm_subs_epu16(max, Sse2Load(k + i));
+    const __m128i cr = _mm_subs_epu16(max, Sse2Load(c + i));
+    const __m128i cg = _mm_subs_epu16(max, Sse2Load(m + i));
+    const __m128i cb = _mm_subs_epu16(max, Sse2Load(y + i));
+    Sse2Store(r + i, Sse2ScaleProduct(cr, white, half, shift));
+    Sse2Store(g + i, Sse2ScaleProduct(cg, white, half, shift));
+    Sse2Store(b + i, Sse2ScaleProduct(cb, white, half, shift));
+  }
+  return i;
+}
+
+template <typename T>
+WSCOMMON_TARGET_SSE2 std::size_t RgbToCmykSse2(const T* r, const T* g,
+                                               const T* b, T* c, T* m, T* y,
+                                               T* k, std::size_t count,
+                                               uint32_t max_value) {
+  const __m128i max = _mm_set1_epi16(static_cast<int16_t>(max_value));
+  const __m128i bias = _mm_set1_epi16(-32768);
+  const __m128 max_f = _mm_set1_ps(static_cast<float>(max_value));
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128i zero = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i sr = Sse2Min(Sse2Load(r + i), max);
+    const __m128i sg = Sse2Min(Sse2Load(g + i), max);
+    const __m128i sb = Sse2Min(Sse2Load(b + i), max);
+    // pmaxsw is signed; the bias makes it order unsigned samples.
+    const __m128i top = _mm_xor_si128(
+        _mm_max_epi16(_mm_max_epi16(_mm_xor_si128(sr, bias),
+                                    _mm_xor_si128(sg, bias)),
+                      _mm_xor_si128(sb, bias)),
+        bias);
+    const __m128 top_lo =
+        _mm_max_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(top, zero)), one);
+    const __m128 top_hi =
+        _mm_max_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(top, zero)), one);
+    Sse2Store(c + i, Sse2ScaleQuotient(_mm_sub_epi16(top, sr), top_lo,
+                                       top_hi, max_f));
+    Sse2Store(m + i, Sse2ScaleQuotient(_mm_sub_epi16(top, sg), top_lo,
+                                       top_hi, max_f));
+    Sse2Store(y + i, Sse2ScaleQuotient(_mm_sub_epi16(top, sb), top_lo,
+                                       top_hi, max_f));
+    Sse2Store(k + i, _mm_sub_epi16(max, top));
+  }
+  return i;
+}
+
+// The AVX2 kernels mirror the SSE2 ones on 16 lanes. Unpacks and packs
+// stay within 128-bit lanes and cancel out; only the 8-bit store needs a
+// cross-lane permute.
+WSCOMMON_TARGET_AVX2 inline __m256i Avx2Load(const uint8_t* p) {
+  return _mm256_cvtepu8_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+WSCOMMON_TARGET_AVX2 inline __m256i Avx2Load(const uint16_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+WSCOMMON_TARGET_AVX2 inline void Avx2Store(uint8_t* p, __m256i v) {
+  const __m256i packed =
+      _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                   _mm256_castsi256_si128(packed));
+}
+
+WSCOMMON_TARGET_AVX2 inline void Avx2Store(uint16_t* p, __m256i v) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+WSCOMMON_TARGET_AVX2 inline __m256i Avx2Narrow(__m256i lo, __m256i hi) {
+  return _mm256_packus_epi32(lo, hi);
+}
+
+WSCOMMON_TARGET_AVX2 inline __m256i Avx2ScaleProduct(__m256i a, __m256i b,
+                                                     __m256i half,
+                                                     __m128i bits) {
+  const __m256i low = _mm256_mullo_epi16(a, b);
+  const __m256i high = _mm256_mulhi_epu16(a, b);
+  __m256i lo = _mm256_add_epi32(_mm256_unpacklo_epi16(low, high), half);
+  __m256i hi = _mm256_add_epi32(_mm256_unpackhi_epi16(low, high), half);
+  lo = _mm256_srl_epi32(_mm256_add_epi32(lo, _mm256_srl_epi32(lo, bits)),
+                        bits);
+  hi = _mm256_srl_epi32(_mm256_add_epi32(hi, _mm256_srl_epi32(hi, bits)),
+                        bits);
+  return Avx2Narrow(lo, hi);
+}
+
+WSCOMMON_TARGET_AVX2 inline __m256 Avx2Quotient(__m256i a, __m256 top,
+                                                __m256 max) {
+  return _mm256_add_ps(
+      _mm256_div_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(a), max), top),
+      _mm256_set1_ps(0.5f));
+}
+
+WSCOMMON_TARGET_AVX2 inline __m256i Avx2ScaleQuotient(__m256i a,
+                                                      __m256 top_lo,
+                                                      __m256 top_hi,
+                                                      __m256 max) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i lo = _mm256_cvttps_epi32(
+      Avx2Quotient(_mm256_unpacklo_epi16(a, zero), top_lo, max));
+  const __m256i hi = _mm256_cvttps_epi32(
+      Avx2Quotient(_mm256_unpackhi_epi16(a, zero), top_hi, max));
+  return Avx2Narrow(lo, hi);
+}
+
+template <typename T>
+WSCOMMON_TARGET_AVX2 std::size_t CmykToRgbAvx2(
+    const T* c, const T* m, const T* y, const T* k, T* r, T* g, T* b,
+    std::size_t count, uint32_t max_value, int bits) {
+  const __m256i max = _mm256_set1_epi16(static_cast<int16_t>(max_value));
+  const __m256i half = _mm256_set1_epi32(1 << (bits - 1));
+  const __m128i shift = _mm_cvtsi32_si128(bits);
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i white = _mm256_subs_epu16(max, Avx2Load(k + i));
+    const __m256i cr = _mm256_subs_epu16(max, Avx2Load(c + i));
+    const __m256i cg = _mm256_subs_epu16(max, Avx2Load(m + i));
+    const __m256i cb = _mm256_subs_epu16(max, Avx2Load(y + i));
+    Avx2Store(r + i, Avx2ScaleProduct(cr, white, half, shift));
+    Avx2Store(g + i, Avx2ScaleProduct(cg, white, half, shift));
+    Avx2Store(b + i, Avx2ScaleProduct(cb, white, half, shift));
+  }
+  return i;
+}
+
+template <typename T>
+WSCOMMON_TARGET_AVX2 std::size_t RgbToCmykAvx2(const T* r, const T* g,
+                                               const T* b, T* c, T* m, T* y,
+                                               T* k, std::size_t count,
+                                               uint32_t max_value) {
+  const __m256i max = _mm256_set1_epi16(static_cast<int16_t>(max_value));
+  const __m256 max_f = _mm256_set1_ps(static_cast<float>(max_value));
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256i zero = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i sr = _mm256_min_epu16(Avx2Load(r + i), max);
+    const __m256i sg = _mm256_min_epu16(Avx2Load(g + i), max);
+    const __m256i sb = _mm256_min_epu16(Avx2Load(b + i), max);
+    const __m256i top = _mm256_max_epu16(_mm256_max_epu16(sr, sg), sb);
+    const __m256 top_lo = _mm256_max_ps(
+        _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(top, zero)), one);
+    const __m256 top_hi = _mm256_max_ps(
+        _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(top, zero)), one);
+    Avx2Store(c + i, Avx2ScaleQuotient(_mm256_sub_epi16(top, sr), top_lo,
+                                       top_hi, max_f));
+    Avx2Store(m + i, Avx2ScaleQuotient(_mm256_sub_epi16(top, sg), top_lo,
+                                       top_hi, max_f));
+    Avx2Store(y + i, Avx2ScaleQuotient(_mm256_sub_epi16(top, sb), top_lo,
+                                       top_hi, max_f));
+    Avx2Store(k + i, _mm256_sub_epi16(max, top));
+  }
+  return i;
+}
+#elif defined(WSCOMMON_CMYK_NEON)
+inline uint16x8_t NeonLoad(const uint8_t* p) { return vmovl_u8(vld1_u8(p)); }
+
+inline uint16x8_t NeonLoad(const uint16_t* p) { return vld1q_u16(p); }
+
+inline void NeonStore(uint8_t* p, uint16x8_t v) { vst1_u8(p, vmovn_u16(v)); }
+
+inline void NeonStore(uint16_t* p, uint16x8_t v) { vst1q_u16(p, v); }
+
+inline uint32x4_t NeonScaleProduct(uint16x4_t a, uint16x4_t b,
+                                   uint32x4_t half, int32x4_t shift) {
+  const uint32x4_t t = vaddq_u32(vmull_u16(a, b), half);
+  return vshlq_u32(vaddq_u32(t, vshlq_u32(t, shift)), shift);
+}
+
+inline uint16x8_t NeonScaleProduct(uint16x8_t a, uint16x8_t b,
+                                   uint32x4_t half, int32x4_t shift) {
+  return vcombine_u16(
+      vmovn_u32(NeonScaleProduct(vget_low_u16(a), vget_low_u16(b), half,
+                                 shift)),
+      vmovn_u32(NeonScaleProduct(vget_high_u16(a), vget_high_u16(b), half,
+                                 shift)));
+}
+
+inline uint32x4_t NeonScaleQuotient(uint16x4_t a, float32x4_t top,
+                                    float32x4_t max) {
+  const float32x4_t a_f = vcvtq_f32_u32(vmovl_u16(a));
+  return vcvtq_u32_f32(
+      vaddq_f32(vdivq_f32(vmulq_f32(a_f, max), top), vdupq_n_f32(0.5f)));
+}
+
+inline uint16x8_t NeonScaleQuotient(uint16x8_t a, float32x4_t top_lo,
+                                    float32x4_t top_hi, float32x4_t max) {
+  return vcombine_u16(
+      vmovn_u32(NeonScaleQuotient(vget_low_u16(a), top_lo, max)),
+      vmovn_u32(NeonScaleQuotient(vget_high_u16(a), top_hi, max)));
+}
+
+template <typename T>
+std::size_t CmykToRgbNeon(const T* c, const T* m, const T* y, const T* k,
+                          T* r, T* g, T* b, std::size_t count,
+                          uint32_t max_value, int bits) {
+  const uint16x8_t max = vdupq_n_u16(static_cast<uint16_t>(max_value));
+  const uint32x4_t half = vdupq_n_u32(1u << (bits - 1));
+  const int32x4_t shift = vdupq_n_s32(-bits);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const uint16x8_t white = vqsubq_u16(max, NeonLoad(k + i));
+    NeonStore(r + i, NeonScaleProduct(vqsubq_u16(max, NeonLoad(c + i)),
+                                      white, half, shift));
+    NeonStore(g + i, NeonScaleProduct(vqsubq_u16(max, NeonLoad(m + i)),
+                                      white, half, shift));
+    NeonStore(b + i, NeonScaleProduct(vqsubq_u16(max, NeonLoad(y + i)),
+                                      white, half, shift));
+  }
+  return i;
+}
+
+template <typename T>
+std::size_t RgbToCmykNeon(const T* r, const T* g, const T* b, T* c, T* m,
+                          T* y, T* k, std::size_t count,
+                          uint32_t max_value) {
+  const uint16x8_t max = vdupq_n_u16(static_cast<uint16_t>(max_value));
+  const float32x4_t max_f = vdupq_n_f32(static_cast<float>(max_value));
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const uint16x8_t sr = vminq_u16(NeonLoad(r + i), max);
+    const uint16x8_t sg = vminq_u16(NeonLoad(g + i), max);
+    const uint16x8_t sb = vminq_u16(NeonLoad(b + i), max);
+    const uint16x8_t top = vmaxq_u16(vmaxq_u16(sr, sg), sb);
+    const float32x4_t top_lo =
+        vmaxq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(top))), one);
+    const float32x4_t top_hi =
+        vmaxq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(top))), one);
+    NeonStore(c + i,
+              NeonScaleQuotient(vsubq_u16(top, sr), top_lo, top_hi, max_f));
+    NeonStore(m + i,
+              NeonScaleQuotient(vsubq_u16(top, sg), top_lo, top_hi, max_f));
+    NeonStore(y + i,
+              NeonScaleQuotient(vsubq_u16(top, sb), top_lo, top_hi, max_f));
+    NeonStore(k + i, vsubq_u16(max, top));
+  }
+  return i;
+}
+#endif
+}  // namespace
+
+template <typename T>
+void CmykToRgbRow(const T* c, const T* m, const T* y, const T* k, T* r,
+                  T* g, T* b, std::size_t count, uint32_t max_value) {
+  CmykToRgbRow(ws::internal::CurrentSimdLevel(), c, m, y, k, r, g, b, count,
+               max_value);
+}
+
+template <typename T>
+void RgbToCmykRow(const T* r, const T* g, const T* b, T* c, T* m, T* y, T* k,
+                  std::size_t count, uint32_t max_value) {
+  RgbToCmykRow(ws::internal::CurrentSimdLevel(), r, g, b, c, m, y, k, count,
+               max_value);
+}
+
+template <typename T>
+void CmykToRgbRow(ws::internal::SimdLevel level, const T* c, const T* m,
+                  const T* y, const T* k, T* r, T* g, T* b, std::size_t count,
+                  uint32_t max_value) {
+  assert(max_value != 0 && max_value <= 0xFFFF &&
+         std::has_single_bit(max_value + 1) &&
+         "Maximum must be 2^bits - 1 for up to 16 bits");
+  const int bits = std::bit_width(max_value);
+  std::size_t done = 0;
+  if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>) {
+#if defined(WSCOMMON_CMYK_X86)
+    if (level == ws::internal::SimdLevel::kAvx2) {
+      done = CmykToRgbAvx2(c, m, y, k, r, g, b, count, max_value, bits);
+    } else if (level == ws::internal::SimdLevel::kSse2) {
+      done = CmykToRgbSse2(c, m, y, k, r, g, b, count, max_value, bits);
+    }
+#elif defined(WSCOMMON_CMYK_NEON)
+    if (level == ws::internal::SimdLevel::kNeon) {
+      done = CmykToRgbNeon(c, m, y, k, r, g, b, count, max_value, bits);
+    }
+#endif
+  }
+
+  CmykToRgbScalar(c, m, y, k, r, g, b, done, count, max_value, bits);
+}
+
+template <typename T>
+void RgbToCmykRow(ws::internal::SimdLevel level, const T* r, const T* g,
+                  const T* b, T* c, T* m, T* y, T* k, std::size_t count,
+                  uint32_t max_value) {
+  assert(max_value != 0 && max_value <= 0xFFFF &&
+         std::has_single_bit(max_value + 1) &&
+         "Maximum must be 2^bits - 1 for up to 16 bits");
+  std::size_t done = 0;
+  if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>) {
+#if defined(WSCOMMON_CMYK_X86)
+    if (level == ws::internal::SimdLevel::kAvx2) {
+      done = RgbToCmykAvx2(r, g, b, c, m, y, k, count, max_value);
+    } else if (level == ws::internal::SimdLevel::kSse2) {
+      done = RgbToCmykSse2(r, g, b, c, m, y, k, count, max_value);
+    }
+#elif defined(WSCOMMON_CMYK_NEON)
+    if (level == ws::internal::SimdLevel::kNeon) {
+      done = RgbToCmykNeon(r, g, b, c, m, y, k, count, max_value);
+    }
+#endif
+  }
+
+  RgbToCmykScalar(r, g, b, c, m, y, k, done, count, max_value);
+}
+
+#define WSCOMMON_INSTANTIATE_CMYK_ROWS(T)                                   \
+  template void CmykToRgbRow<T>(const T*, const T*, const T*, const T*, T*, \
+                                T*, T*, std::size_t, uint32_t);             \
+  template void RgbToCmykRow<T>(const T*, const T*, const T*, T*, T*, T*,   \
+                                T*, std::size_t, uint32_t);                 \
+  template void CmykToRgbRow<T>(ws::internal::SimdLevel, const T*,          \
+                                const T*, const T*, const T*, T*, T*, T*,   \
+                                std::size_t, uint32_t);                     \
+  template void RgbToCmykRow<T>(ws::internal::SimdLevel, const T*,          \
+                                const T*, const T*, T*, T*, T*, T*,         \
+                                std::size_t, uint32_t);
+
+WSCOMMON_INSTANTIATE_CMYK_ROWS(uint8_t)
+WSCOMMON_INSTANTIATE_CMYK_ROWS(int8_t)
+WSCOMMON_INSTANTIATE_CMYK_ROWS(uint16_t)
+WSCOMMON_INSTANTIATE_CMYK_ROWS(int16_t)
+
+#undef WSCOMMON_INSTANTIATE_CMYK_ROWS
+}  // namespace internal
+}  // namespace imaging
+}  // namespace ws
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "ws/machine.h"
+
+namespace ws {
+namespace imaging {
+namespace internal {
+/** round(a * b / max) for max = 2^bits - 1 and a, b <= max, exactly. */
+constexpr uint32_t ScaleProduct(uint32_t a, uint32_t b, int bits) {
+  const uint32_t t = a * b + (1u << (bits - 1));
+  return (t + (t >> bits)) >> bits;
+}
+
+/** a * max / m in single precision, rounded half up; m == 0 implies
+    a == 0. */
+constexpr uint32_t ScaleQuotient(uint32_t a, uint32_t m, float max) {
+  const float divisor = std::max(static_cast<float>(m), 1.0f);
+  return static_cast<uint32_t>(static_cast<float>(a) * max / divisor + 0.5f);
+}
+
+/** A sample as the CMYK kernels read it: anything above max is max. */
+template <typename T>
+constexpr uint32_t ClampSample(T value, uint32_t max_value) {
+  return std::min<uint32_t>(static_cast<std::make_unsigned_t<T>>(value),
+                            max_value);
+}
+
+/** One channel of one pixel as CmykToRgbRow computes it, so that single
+    pixel conversions match the row kernels; bits is bit_width(max_value). */
+template <typename T>
+constexpr uint32_t CmykToRgbSample(T ink, T k, uint32_t max_value, int bits) {
+  return ScaleProduct(max_value - ClampSample(ink, max_value),
+                      max_value - ClampSample(k, max_value), bits);
+}
+
+/** Converts count planar CMYK samples to RGB:
+    r = round((max - c) * (max - k) / max), exactly, with halves rounded
+    up. The scalar loop is the reference: the SSE2, AVX2 and NEON
+    kernels, picked at run time for uint8_t and uint16_t, produce
+    bit-identical results. max_value must be 2^bits - 1, at most 65535;
+    samples above it read as max_value. */
+template <typename T>
+void CmykToRgbRow(const T* c, const T* m, const T* y, const T* k, T* r,
+                  T* g, T* b, std::size_t count, uint32_t max_value);
+
+/** Converts count planar RGB samples to CMYK: k = max - max(r, g, b) and
+    c = round((max(r, g, b) - r) * max / max(r, g, b)), computed in single
+    precision so that the vector kernels can share the division; for 16-bit
+    samples it can be one code value off the exact quotient. Same
+    dispatch and limits as CmykToRgbRow. */
+template <typename T>
+void RgbToCmykRow(const T* r, const T* g, const T* b, T* c, T* m, T* y, T* k,
+                  std::size_t count, uint32_t max_value);
+
+/** Like the above, with the kernels for level instead of the best ones the
+    CPU supports, so each kernel can be checked against the scalar loop.
+    level must be kScalar or supported by the CPU. */
+template <typename T>
+void CmykToRgbRow(ws::internal::SimdLevel level, const T* c, const T* m,
+                  const T* y, const T* k, T* r, T* g, T* b, std::size_t count,
+                  uint32_t max_value);
+template <typename T>
+void RgbToCmykRow(ws::internal::SimdLevel level, const T* r, const T* g,
+                  const T* b, T* c, T* m, T* y, T* k, std::size_t count,
+                  uint32_t max_value);
+}  // namespace internal
+}  // namespace imaging
+}  // namespace ws
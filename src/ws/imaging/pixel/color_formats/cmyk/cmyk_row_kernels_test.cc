@@ -0,0 +1,156 @@
+#include "ws/imaging/pixel/color_formats/cmyk/cmyk_row_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "ws/imaging/pixel/simd_test_util.h"
+
+namespace ws {
+namespace imaging {
+namespace internal {
+namespace {
+using ws::internal::SimdLevel;
+
+/** round(a * b / max), halves up, in exact integer arithmetic. */
+uint32_t ExactProduct(uint32_t a, uint32_t b, uint32_t max_value) {
+  return static_cast<uint32_t>(
+      (uint64_t{a} * b * 2 + max_value) / (uint64_t{max_value} * 2));
+}
+
+/** round(a * max / m), halves up, in exact integer arithmetic. */
+uint32_t ExactQuotient(uint32_t a, uint32_t m, uint32_t max_value) {
+  if (m == 0) return 0;
+  return static_cast<uint32_t>((uint64_t{a} * max_value * 2 + m) /
+                               (uint64_t{m} * 2));
+}
+
+template <typename T>
+std::vector<T> RandomPlane(std::mt19937& random, uint32_t max_value) {
+  std::vector<T> plane(1021);
+  std::uniform_int_distribution<uint32_t> sample(0, max_value);
+  for (T& value : plane) value = static_cast<T>(sample(random));
+  plane[0] = 0;
+  plane[1] = static_cast<T>(max_value);
+  return plane;
+}
+
+template <typename T>
+void ExpectCmykToRgbIsExact(uint32_t max_value) {
+  std::mt19937 random(max_value);
+  const std::vector<T> c = RandomPlane<T>(random, max_value);
+  const std::vector<T> m = RandomPlane<T>(random, max_value);
+  const std::vector<T> y = RandomPlane<T>(random, max_value);
+  const std::vector<T> k = RandomPlane<T>(random, max_value);
+  const std::size_t count = c.size();
+  for (SimdLevel level : SupportedSimdLevels()) {
+    SCOPED_TRACE(static_cast<int>(level));
+    std::vector<T> r(count), g(count), b(count);
+    CmykToRgbRow(level, c.data(), m.data(), y.data(), k.data(), r.data(),
+                 g.data(), b.data(), count, max_value);
+    for (std::size_t i = 0; i < count; ++i) {
+      const uint32_t white = max_value - k[i];
+      ASSERT_EQ(r[i], ExactProduct(max_value - c[i], white, max_value)) << i;
+      ASSERT_EQ(g[i], ExactProduct(max_value - m[i], white, max_value)) << i;
+      ASSERT_EQ(b[i], ExactProduct(max_value - y[i], white, max_value)) << i;
+    }
+  }
+}
+
+/** Checks every kernel against the scalar loop, and the scalar loop
+    against the exact quotient to within max_error code values. */
+template <typename T>
+void ExpectRgbToCmykWithin(uint32_t max_value, uint32_t max_error) {
+  std::mt19937 random(max_value);
+  const std::vector<T> r = RandomPlane<T>(random, max_value);
+  const std::vector<T> g = RandomPlane<T>(random, max_value);
+  const std::vector<T> b = RandomPlane<T>(random, max_value);
+  const std::size_t count = r.size();
+  std::vector<T> c(count), m(count), y(count), k(count);
+  RgbToCmykRow(SimdLevel::kScalar, r.data(), g.data(), b.data(), c.data(),
+               m.data(), y.data(), k.data(), count, max_value);
+  for (std::size_t i = 0; i < count; ++i) {
+    const uint32_t high = std::max({r[i], g[i], b[i]});
+    ASSERT_EQ(k[i], max_value - high) << i;
+    ASSERT_LE(std::abs(static_cast<int32_t>(c[i]) - static_cast<int32_t>(
+                  ExactQuotient(high - r[i], high, max_value))),
+              static_cast<int32_t>(max_error))
+        << i;
+    ASSERT_LE(std::abs(static_cast<int32_t>(m[i]) - static_cast<int32_t>(
+                  ExactQuotient(high - g[i], high, max_value))),
+              static_cast<int32_t>(max_error))
+        << i;
+    ASSERT_LE(std::abs(static_cast<int32_t>(y[i]) - static_cast<int32_t>(
+                  ExactQuotient(high - b[i], high, max_value))),
+              static_cast<int32_t>(max_error))
+        << i;
+  }
+
+  for (SimdLevel level : SupportedSimdLevels()) {
+    SCOPED_TRACE(static_cast<int>(level));
+    std::vector<T> c2(count), m2(count), y2(count), k2(count);
+    RgbToCmykRow(level, r.data(), g.data(), b.data(), c2.data(), m2.data(),
+                 y2.data(), k2.data(), count, max_value);
+    EXPECT_EQ(c2, c);
+    EXPECT_EQ(m2, m);
+    EXPECT_EQ(y2, y);
+    EXPECT_EQ(k2, k);
+  }
+}
+
+TEST(CmykToRgbRowTest, EightBitKernelsAreExact) {
+  ExpectCmykToRgbIsExact<uint8_t>(255);
+}
+
+TEST(CmykToRgbRowTest, SixteenBitKernelsAreExact) {
+  for (uint32_t max_value : {1023u, 4095u, 65535u}) {
+    SCOPED_TRACE(max_value);
+    ExpectCmykToRgbIsExact<uint16_t>(max_value);
+  }
+}
+
+TEST(RgbToCmykRowTest, EightBitQuotientIsExactForEveryPair) {
+  // c depends only on the channel and max(r, g, b), so pairing every
+  // channel value with every larger maximum covers all 8-bit inputs.
+  std::vector<uint8_t> r, g, b;
+  for (uint32_t high = 0; high <= 255; ++high) {
+    for (uint32_t channel = 0; channel <= high; ++channel) {
+      r.push_back(static_cast<uint8_t>(channel));
+      g.push_back(static_cast<uint8_t>(high));
+      b.push_back(0);
+    }
+  }
+
+  const std::size_t count = r.size();
+  for (SimdLevel level : SupportedSimdLevels()) {
+    SCOPED_TRACE(static_cast<int>(level));
+    std::vector<uint8_t> c(count), m(count), y(count), k(count);
+    RgbToCmykRow(level, r.data(), g.data(), b.data(), c.data(), m.data(),
+                 y.data(), k.data(), count, 255);
+    for (std::size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(c[i], ExactQuotient(g[i] - r[i], g[i], 255)) << i;
+      ASSERT_EQ(k[i], 255 - g[i]) << i;
+    }
+  }
+}
+
+TEST(RgbToCmykRowTest, EightBitKernelsMatchScalar) {
+  ExpectRgbToCmykWithin<uint8_t>(255, 0);
+}
+
+TEST(RgbToCmykRowTest, SixteenBitIsWithinOneCodeValue) {
+  // The single-precision quotient is exact up to 12 bits and may be one
+  // code value off beyond that, as documented on RgbToCmykRow.
+  ExpectRgbToCmykWithin<uint16_t>(1023, 0);
+  ExpectRgbToCmykWithin<uint16_t>(4095, 0);
+  ExpectRgbToCmykWithin<uint16_t>(65535, 1);
+}
+}  // namespace
+}  // namespace internal
+}  // namespace imaging
+}  // namespace ws
@@ -1,12 +1,33 @@
 #include "ws/imaging/pixel/color_formats/cmyk/cmyk_to_srgb_converter.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
 namespace ws {
 namespace imaging {
+namespace {
+/** Pixels staged into planes per call of the planar kernels. */
+constexpr std::size_t kRowChunk = 256;
+}  // namespace
+
 template <IsAllowedPixelNumericType T>
 CmykToSRgbConverter<T>::CmykToSRgbConverter(uint8_t bit_depth)
     : PixelColorConverter<T>(bit_depth) {}
 
 template <IsAllowedPixelNumericType T>
 void CmykToSRgbConverter<T>::Convert(const Cmyk<T>& cmyk, Rgb<T>& rgb) const {
+  if constexpr (sizeof(T) <= 2) {
+    const uint32_t max_value = this->RowMaxValue();
+    const int bits = std::bit_width(max_value);
+    rgb.r = static_cast<T>(
+        internal::CmykToRgbSample(cmyk.c, cmyk.k, max_value, bits));
+    rgb.g = static_cast<T>(
+        internal::CmykToRgbSample(cmyk.m, cmyk.k, max_value, bits));
+    rgb.b = static_cast<T>(
+        internal::CmykToRgbSample(cmyk.y, cmyk.k, max_value, bits));
+    return;
+  }
+
   double c = static_cast<double>(cmyk.c) / this->max_value_;
   double m = static_cast<double>(cmyk.m) / this->max_value_;
   double y = static_cast<double>(cmyk.y) / this->max_value_;
@@ -20,17 +41,91 @@ void CmykToSRgbConverter<T>::Convert(const Cmyk<T>& cmyk, Rgb<T>& rgb) const {
 template <IsAllowedPixelNumericType T>
 void CmykToSRgbConverter<T>::ConvertWithAlpha(const Cmyka<T>& cmyka,
                                               Rgba<T>& rgba) const {
-  double c = static_cast<double>(cmyka.c) / this->max_value_;
-  double m = static_cast<double>(cmyka.m) / this->max_value_;
-  double y = static_cast<double>(cmyka.y) / this->max_value_;
-  double k = static_cast<double>(cmyka.k) / this->max_value_;
-
-  rgba.r = this->max_value_ * (1.0 - c) * (1.0 - k);
-  rgba.g = this->max_value_ * (1.0 - m) * (1.0 - k);
-  rgba.b = this->max_value_ * (1.0 - y) * (1.0 - k);
+  Rgb<T> rgb;
+  Convert({cmyka.c, cmyka.m, cmyka.y, cmyka.k}, rgb);
+  rgba.r = rgb.r;
+  rgba.g = rgb.g;
+  rgba.b = rgb.b;
   rgba.alpha = cmyka.alpha;
 }
 
+template <IsAllowedPixelNumericType T>
+void CmykToSRgbConverter<T>::ConvertRow(std::span<const T> c,
+                                        std::span<const T> m,
+                                        std::span<const T> y,
+                                        std::span<const T> k, std::span<T> r,
+                                        std::span<T> g,
+                                        std::span<T> b) const {
+  assert(m.size() == c.size() && y.size() == c.size() &&
+         k.size() == c.size() && r.size() == c.size() &&
+         g.size() == c.size() && b.size() == c.size() &&
+         "Row planes differ in size");
+  if constexpr (sizeof(T) <= 2) {
+    internal::CmykToRgbRow(c.data(), m.data(), y.data(), k.data(), r.data(),
+                           g.data(), b.data(), c.size(),
+                           this->RowMaxValue());
+  } else {
+    Rgb<T> rgb;
+    for (std::size_t i = 0; i < c.size(); ++i) {
+      Convert({c[i], m[i], y[i], k[i]}, rgb);
+      r[i] = rgb.r;
+      g[i] = rgb.g;
+      b[i] = rgb.b;
+    }
+  }
+}
+
+template <IsAllowedPixelNumericType T>
+void CmykToSRgbConverter<T>::ConvertRow(std::span<const Cmyk<T>> cmyk,
+                                        std::span<Rgb<T>> rgb) const {
+  ConvertInterleaved(cmyk, rgb);
+}
+
+template <IsAllowedPixelNumericType T>
+void CmykToSRgbConverter<T>::ConvertRowWithAlpha(
+    std::span<const Cmyka<T>> cmyka, std::span<Rgba<T>> rgba) const {
+  ConvertInterleaved(cmyka, rgba);
+}
+
+template <IsAllowedPixelNumericType T>
+template <typename TIn, typename TOut>
+void CmykToSRgbConverter<T>::ConvertInterleaved(std::span<const TIn> in,
+                                                std::span<TOut> out) const {
+  assert(out.size() == in.size() && "Rows differ in size");
+  constexpr bool kHasAlpha = IsCmykaType<TIn>::value;
+  if constexpr (sizeof(T) > 2) {
+    for (std::size_t i = 0; i < in.size(); ++i) {
+      if constexpr (kHasAlpha) {
+        ConvertWithAlpha(in[i], out[i]);
+      } else {
+        Convert(in[i], out[i]);
+      }
+    }
+  } else {
+    T c[kRowChunk], m[kRowChunk], y[kRowChunk], k[kRowChunk];
+    T r[kRowChunk], g[kRowChunk], b[kRowChunk];
+    for (std::size_t begin = 0; begin < in.size(); begin += kRowChunk) {
+      const std::size_t count = std::min(kRowChunk, in.size() - begin);
+      for (std::size_t i = 0; i < count; ++i) {
+        c[i] = in[begin + i].c;
+        m[i] = in[begin + i].m;
+        y[i] = in[begin + i].y;
+        k[i] = in[begin + i].k;
+      }
+
+      internal::CmykToRgbRow(c, m, y, k, r, g, b, count,
+                             this->RowMaxValue());
+      for (std::size_t i = 0; i < count; ++i) {
+        TOut& pixel = out[begin + i];
+        pixel.r = r[i];
+        pixel.g = g[i];
+        pixel.b = b[i];
+        if constexpr (kHasAlpha) pixel.alpha = in[begin + i].alpha;
+      }
+    }
+  }
+}
+
 template class CmykToSRgbConverter<uint8_t>;
 template class CmykToSRgbConverter<int8_t>;
 template class CmykToSRgbConverter<uint16_t>;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <span>
+
 #include "ws/imaging/pixel/color_formats/cmyk/cmyk.h"
+#include "ws/imaging/pixel/color_formats/cmyk/cmyk_row_kernels.h"
 #include "ws/imaging/pixel/color_formats/cmyk/cmyka.h"
 #include "ws/imaging/pixel/color_formats/srgb/rgb.h"
 #include "ws/imaging/pixel/pixel_color_converter.h"
@@ -11,8 +14,28 @@ class CmykToSRgbConverter : public PixelColorConverter<T> {
  public:
   explicit CmykToSRgbConverter(uint8_t bit_depth);
 
+  /** Samples of up to 16 bits are rounded to nearest in integer
+      arithmetic, exactly as the row kernels do; wider samples are
+      computed in double precision. */
   void Convert(const Cmyk<T>& cmyk, Rgb<T>& rgb) const;
   void ConvertWithAlpha(const Cmyka<T>& cmyka, Rgba<T>& rgba) const;
+
+  /** Batch forms of Convert, planar and interleaved; the spans must be the
+      same size. Samples of up to 16 bits go through the row kernels, SIMD
+      where the CPU allows, whose results match Convert bit for bit. Wider
+      samples use Convert. */
+  void ConvertRow(std::span<const T> c, std::span<const T> m,
+                  std::span<const T> y, std::span<const T> k, std::span<T> r,
+                  std::span<T> g, std::span<T> b) const;
+  void ConvertRow(std::span<const Cmyk<T>> cmyk, std::span<Rgb<T>> rgb) const;
+
+  /** Batch form of ConvertWithAlpha; alpha is copied through. */
+  void ConvertRowWithAlpha(std::span<const Cmyka<T>> cmyka,
+                           std::span<Rgba<T>> rgba) const;
+
+ private:
+  template <typename TIn, typename TOut>
+  void ConvertInterleaved(std::span<const TIn> in, std::span<TOut> out) const;
 };
 }  // namespace imaging
 }  // namespace ws
@@ -0,0 +1,125 @@
+#include "ws/imaging/pixel/color_formats/cmyk/cmyk_to_srgb_converter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace ws {
+namespace imaging {
+namespace {
+template <typename T>
+void ExpectAlphaPassesThrough(uint8_t bit_depth) {
+  const uint32_t max_value = (uint32_t{1} << bit_depth) - 1;
+  std::mt19937 random(bit_depth);
+  std::uniform_int_distribution<uint32_t> sample(0, max_value);
+  // More pixels than one staging chunk, and not a multiple of it.
+  std::vector<Cmyka<T>> cmyka(1000);
+  for (Cmyka<T>& pixel : cmyka) {
+    pixel = {static_cast<T>(sample(random)), static_cast<T>(sample(random)),
+             static_cast<T>(sample(random)), static_cast<T>(sample(random)),
+             static_cast<T>(sample(random))};
+  }
+
+  const CmykToSRgbConverter<T> converter(bit_depth);
+  std::vector<Rgba<T>> rgba(cmyka.size());
+  converter.ConvertRowWithAlpha(std::span<const Cmyka<T>>(cmyka),
+                                std::span<Rgba<T>>(rgba));
+
+  std::vector<T> c, m, y, k;
+  for (const Cmyka<T>& pixel : cmyka) {
+    c.push_back(pixel.c);
+    m.push_back(pixel.m);
+    y.push_back(pixel.y);
+    k.push_back(pixel.k);
+  }
+  std::vector<T> r(c.size()), g(c.size()), b(c.size());
+  converter.ConvertRow(std::span<const T>(c), std::span<const T>(m),
+                       std::span<const T>(y), std::span<const T>(k),
+                       std::span<T>(r), std::span<T>(g), std::span<T>(b));
+
+  for (std::size_t i = 0; i < cmyka.size(); ++i) {
+    ASSERT_EQ(rgba[i].alpha, cmyka[i].alpha) << i;
+    ASSERT_EQ(rgba[i].r, r[i]) << i;
+    ASSERT_EQ(rgba[i].g, g[i]) << i;
+    ASSERT_EQ(rgba[i].b, b[i]) << i;
+  }
+}
+
+template <typename T>
+void ExpectConvertMatchesConvertRow(uint8_t bit_depth) {
+  const uint32_t max_value = (uint32_t{1} << bit_depth) - 1;
+  std::mt19937 random(bit_depth);
+  std::uniform_int_distribution<uint32_t> sample(0, max_value);
+  std::vector<Cmyka<T>> cmyka(1000);
+  for (Cmyka<T>& pixel : cmyka) {
+    pixel = {static_cast<T>(sample(random)), static_cast<T>(sample(random)),
+             static_cast<T>(sample(random)), static_cast<T>(sample(random)),
+             static_cast<T>(sample(random))};
+  }
+
+  const CmykToSRgbConverter<T> converter(bit_depth);
+  std::vector<Rgba<T>> rgba(cmyka.size());
+  converter.ConvertRowWithAlpha(std::span<const Cmyka<T>>(cmyka),
+                                std::span<Rgba<T>>(rgba));
+
+  for (std::size_t i = 0; i < cmyka.size(); ++i) {
+    Rgb<T> rgb;
+    converter.Convert({cmyka[i].c, cmyka[i].m, cmyka[i].y, cmyka[i].k}, rgb);
+    ASSERT_EQ(rgb.r, rgba[i].r) << i;
+    ASSERT_EQ(rgb.g, rgba[i].g) << i;
+    ASSERT_EQ(rgb.b, rgba[i].b) << i;
+
+    Rgba<T> single;
+    converter.ConvertWithAlpha(cmyka[i], single);
+    ASSERT_EQ(single.r, rgba[i].r) << i;
+    ASSERT_EQ(single.g, rgba[i].g) << i;
+    ASSERT_EQ(single.b, rgba[i].b) << i;
+    ASSERT_EQ(single.alpha, rgba[i].alpha) << i;
+  }
+}
+
+TEST(CmykToSRgbConverterTest, ConvertMatchesConvertRowEightBit) {
+  ExpectConvertMatchesConvertRow<uint8_t>(8);
+}
+
+TEST(CmykToSRgbConverterTest, ConvertMatchesConvertRowSixteenBit) {
+  ExpectConvertMatchesConvertRow<uint16_t>(10);
+  ExpectConvertMatchesConvertRow<uint16_t>(16);
+}
+
+TEST(CmykToSRgbConverterTest, ConvertRowWithAlphaCopiesAlphaEightBit) {
+  ExpectAlphaPassesThrough<uint8_t>(8);
+}
+
+TEST(CmykToSRgbConverterTest, ConvertRowWithAlphaCopiesAlphaSixteenBit) {
+  ExpectAlphaPassesThrough<uint16_t>(10);
+  ExpectAlphaPassesThrough<uint16_t>(16);
+}
+
+TEST(CmykToSRgbConverterTest, ConvertRowMapsInkCoverage) {
+  const CmykToSRgbConverter<uint8_t> converter(8);
+  const std::vector<Cmyk<uint8_t>> cmyk = {
+      {0, 0, 0, 0}, {0, 0, 0, 255}, {255, 0, 0, 0}, {0, 255, 255, 0}};
+  std::vector<Rgb<uint8_t>> rgb(cmyk.size());
+  converter.ConvertRow(std::span<const Cmyk<uint8_t>>(cmyk),
+                       std::span<Rgb<uint8_t>>(rgb));
+  EXPECT_EQ(rgb[0].r, 255);
+  EXPECT_EQ(rgb[0].g, 255);
+  EXPECT_EQ(rgb[0].b, 255);
+  EXPECT_EQ(rgb[1].r, 0);
+  EXPECT_EQ(rgb[1].g, 0);
+  EXPECT_EQ(rgb[1].b, 0);
+  EXPECT_EQ(rgb[2].r, 0);
+  EXPECT_EQ(rgb[2].g, 255);
+  EXPECT_EQ(rgb[2].b, 255);
+  EXPECT_EQ(rgb[3].r, 255);
+  EXPECT_EQ(rgb[3].g, 0);
+  EXPECT_EQ(rgb[3].b, 0);
+}
+}  // namespace
+}  // namespace imaging
+}  // namespace ws
@@ -1,7 +1,14 @@
 #include "ws/imaging/pixel/color_formats/srgb/srgb_to_cmyk_converter.h"
 
+#include <cassert>
+
 namespace ws {
 namespace imaging {
+namespace {
+/** Pixels staged into planes per call of the planar kernels. */
+constexpr std::size_t kRowChunk = 256;
+}  // namespace
+
 template <IsAllowedPixelNumericType T>
 SRgbToCmykConverter<T>::SRgbToCmykConverter(uint8_t bit_depth)
     : PixelColorConverter<T>(bit_depth){};
@@ -37,6 +44,83 @@ void SRgbToCmykConverter<T>::ConvertWithAlpha(const Rgba<T>& rgba,
   cmyka.alpha = rgba.alpha;
 }
 
+template <IsAllowedPixelNumericType T>
+void SRgbToCmykConverter<T>::ConvertRow(std::span<const T> r,
+                                        std::span<const T> g,
+                                        std::span<const T> b, std::span<T> c,
+                                        std::span<T> m, std::span<T> y,
+                                        std::span<T> k) const {
+  assert(g.size() == r.size() && b.size() == r.size() &&
+         c.size() == r.size() && m.size() == r.size() &&
+         y.size() == r.size() && k.size() == r.size() &&
+         "Row planes differ in size");
+  if constexpr (sizeof(T) <= 2) {
+    internal::RgbToCmykRow(r.data(), g.data(), b.data(), c.data(), m.data(),
+                           y.data(), k.data(), r.size(),
+                           this->RowMaxValue());
+  } else {
+    Cmyk<T> cmyk;
+    for (std::size_t i = 0; i < r.size(); ++i) {
+      Convert({r[i], g[i], b[i]}, cmyk);
+      c[i] = cmyk.c;
+      m[i] = cmyk.m;
+      y[i] = cmyk.y;
+      k[i] = cmyk.k;
+    }
+  }
+}
+
+template <IsAllowedPixelNumericType T>
+void SRgbToCmykConverter<T>::ConvertRow(std::span<const Rgb<T>> rgb,
+                                        std::span<Cmyk<T>> cmyk) const {
+  ConvertInterleaved(rgb, cmyk);
+}
+
+template <IsAllowedPixelNumericType T>
+void SRgbToCmykConverter<T>::ConvertRowWithAlpha(
+    std::span<const Rgba<T>> rgba, std::span<Cmyka<T>> cmyka) const {
+  ConvertInterleaved(rgba, cmyka);
+}
+
+template <IsAllowedPixelNumericType T>
+template <typename TIn, typename TOut>
+void SRgbToCmykConverter<T>::ConvertInterleaved(std::span<const TIn> in,
+                                                std::span<TOut> out) const {
+  assert(out.size() == in.size() && "Rows differ in size");
+  constexpr bool kHasAlpha = IsRgbaType<TIn>::value;
+  if constexpr (sizeof(T) > 2) {
+    for (std::size_t i = 0; i < in.size(); ++i) {
+      if constexpr (kHasAlpha) {
+        ConvertWithAlpha(in[i], out[i]);
+      } else {
+        Convert(in[i], out[i]);
+      }
+    }
+  } else {
+    T r[kRowChunk], g[kRowChunk], b[kRowChunk];
+    T c[kRowChunk], m[kRowChunk], y[kRowChunk], k[kRowChunk];
+    for (std::size_t begin = 0; begin < in.size(); begin += kRowChunk) {
+      const std::size_t count = std::min(kRowChunk, in.size() - begin);
+      for (std::size_t i = 0; i < count; ++i) {
+        r[i] = in[begin + i].r;
+        g[i] = in[begin + i].g;
+        b[i] = in[begin + i].b;
+      }
+
+      internal::RgbToCmykRow(r, g, b, c, m, y, k, count,
+                             this->RowMaxValue());
+      for (std::size_t i = 0; i < count; ++i) {
+        TOut& pixel = out[begin + i];
+        pixel.c = c[i];
+        pixel.m = m[i];
+        pixel.y = y[i];
+        pixel.k = k[i];
+        if constexpr (kHasAlpha) pixel.alpha = in[begin + i].alpha;
+      }
+    }
+  }
+}
+
 template class SRgbToCmykConverter<uint8_t>;
 template class SRgbToCmykConverter<int8_t>;
 template class SRgbToCmykConverter<uint16_t>;
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <span>
 
 #include "ws/imaging/pixel/color_formats/cmyk/cmyk.h"
+#include "ws/imaging/pixel/color_formats/cmyk/cmyk_row_kernels.h"
 #include "ws/imaging/pixel/color_formats/srgb/rgb.h"
 #include "ws/imaging/pixel/pixel_color_converter.h"
 namespace ws {
@@ -14,6 +16,24 @@ class SRgbToCmykConverter : public PixelColorConverter<T> {
 
   void Convert(const Rgb<T>& rgb, Cmyk<T>& cmyk) const;
   void ConvertWithAlpha(const Rgba<T>& rgba, Cmyka<T>& cmyka) const;
+
+  /** Batch forms of Convert, planar and interleaved; the spans must be the
+      same size. Samples of up to 16 bits go through the row kernels, SIMD
+      where the CPU allows, which divide in single precision and round to
+      nearest, so they can differ from Convert by one code value. Wider
+      samples use Convert. */
+  void ConvertRow(std::span<const T> r, std::span<const T> g,
+                  std::span<const T> b, std::span<T> c, std::span<T> m,
+                  std::span<T> y, std::span<T> k) const;
+  void ConvertRow(std::span<const Rgb<T>> rgb, std::span<Cmyk<T>> cmyk) const;
+
+  /** Batch form of ConvertWithAlpha; alpha is copied through. */
+  void ConvertRowWithAlpha(std::span<const Rgba<T>> rgba,
+                           std::span<Cmyka<T>> cmyka) const;
+
+ private:
+  template <typename TIn, typename TOut>
+  void ConvertInterleaved(std::span<const TIn> in, std::span<TOut> out) const;
 };
 }  // namespace imaging
 }  // namespace ws
@@ -1,15 +1,29 @@
 #include "ws/imaging/pixel/color_formats/srgb/srgb_to_sycc_converter.h"
 
+#include <cassert>
+
 namespace ws {
 namespace imaging {
 template <IsAllowedPixelNumericType T>
 SRgbToSYccConverter<T>::SRgbToSYccConverter(
     uint8_t bit_depth, PixelColorConverter<T>::DigitalTvStudioEncodingRec rec)
     : PixelColorConverter<T>(bit_depth),
-      coeffs_(PixelColorConverter<T>::GetEncodingCoefficients(rec)) {}
+      coeffs_(PixelColorConverter<T>::GetEncodingCoefficients(rec)),
+      row_matrix_{} {
+  if constexpr (sizeof(T) <= 2) {
+    row_matrix_ = internal::RgbToYccMatrix(coeffs_, this->RowMaxValue());
+  }
+}
 
 template <IsAllowedPixelNumericType T>
 void SRgbToSYccConverter<T>::Convert(const Rgb<T>& rgb, Ycc<T>& ycc) const {
+  if constexpr (sizeof(T) <= 2) {
+    ycc.y = static_cast<T>(row_matrix_.Apply(0, rgb.r, rgb.g, rgb.b));
+    ycc.cb = static_cast<T>(row_matrix_.Apply(1, rgb.r, rgb.g, rgb.b));
+    ycc.cr = static_cast<T>(row_matrix_.Apply(2, rgb.r, rgb.g, rgb.b));
+    return;
+  }
+
   double r = static_cast<double>(rgb.r) / this->max_value_;
   double g = static_cast<double>(rgb.g) / this->max_value_;
   double b = static_cast<double>(rgb.b) / this->max_value_;
@@ -23,6 +37,29 @@ void SRgbToSYccConverter<T>::Convert(const Rgb<T>& rgb, Ycc<T>& ycc) const {
   ycc.cr = this->max_value_ * cr;
 }
 
+template <IsAllowedPixelNumericType T>
+void SRgbToSYccConverter<T>::ConvertRow(std::span<const T> r,
+                                        std::span<const T> g,
+                                        std::span<const T> b, std::span<T> y,
+                                        std::span<T> cb,
+                                        std::span<T> cr) const {
+  assert(g.size() == r.size() && b.size() == r.size() &&
+         y.size() == r.size() && cb.size() == r.size() &&
+         cr.size() == r.size() && "Row planes differ in size");
+  if constexpr (sizeof(T) <= 2) {
+    internal::TransformYccRow(row_matrix_, r.data(), g.data(), b.data(),
+                              y.data(), cb.data(), cr.data(), r.size());
+  } else {
+    Ycc<T> ycc;
+    for (std::size_t i = 0; i < r.size(); ++i) {
+      Convert({r[i], g[i], b[i]}, ycc);
+      y[i] = ycc.y;
+      cb[i] = ycc.cb;
+      cr[i] = ycc.cr;
+    }
+  }
+}
+
 template class SRgbToSYccConverter<uint8_t>;
 template class SRgbToSYccConverter<int8_t>;
 template class SRgbToSYccConverter<uint16_t>;
@@ -0,0 +1,84 @@
+#include "ws/imaging/pixel/color_formats/srgb/srgb_to_sycc_converter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace ws {
+namespace imaging {
+namespace {
+constexpr DigitalTvStudioEncodingRec kRecs[] = {
+    DigitalTvStudioEncodingRec::kBT601, DigitalTvStudioEncodingRec::kBT709,
+    DigitalTvStudioEncodingRec::kBT2020};
+
+template <typename T>
+void ExpectRowMatchesConvert(const SRgbToSYccConverter<T>& converter,
+                             const std::vector<T>& r, const std::vector<T>& g,
+                             const std::vector<T>& b) {
+  const std::size_t count = r.size();
+  std::vector<T> y(count), cb(count), cr(count);
+  converter.ConvertRow(std::span<const T>(r), std::span<const T>(g),
+                       std::span<const T>(b), std::span<T>(y),
+                       std::span<T>(cb), std::span<T>(cr));
+  for (std::size_t i = 0; i < count; ++i) {
+    Ycc<T> ycc;
+    converter.Convert({r[i], g[i], b[i]}, ycc);
+    ASSERT_EQ(y[i], ycc.y) << i;
+    ASSERT_EQ(cb[i], ycc.cb) << i;
+    ASSERT_EQ(cr[i], ycc.cr) << i;
+  }
+}
+
+TEST(SRgbToSYccConverterTest, ConvertRowMatchesConvertForEightBitRgb) {
+  for (DigitalTvStudioEncodingRec rec : kRecs) {
+    const SRgbToSYccConverter<uint8_t> converter(8, rec);
+    std::vector<uint8_t> r(256), g(256), b(256);
+    for (int i = 0; i < 256; ++i) b[i] = static_cast<uint8_t>(i);
+    for (int red = 0; red < 256; red += 5) {
+      for (int green = 0; green < 256; ++green) {
+        std::fill(r.begin(), r.end(), static_cast<uint8_t>(red));
+        std::fill(g.begin(), g.end(), static_cast<uint8_t>(green));
+        ExpectRowMatchesConvert(converter, r, g, b);
+      }
+    }
+  }
+}
+
+TEST(SRgbToSYccConverterTest, ConvertRowMatchesConvertForWideSamples) {
+  std::mt19937 random(7);
+  for (uint8_t bit_depth : {10, 12, 16}) {
+    SCOPED_TRACE(static_cast<int>(bit_depth));
+    const uint32_t max_value = (uint32_t{1} << bit_depth) - 1;
+    std::uniform_int_distribution<uint32_t> sample(0, max_value);
+    std::vector<uint16_t> r(4099), g(4099), b(4099);
+    for (std::size_t i = 0; i < r.size(); ++i) {
+      r[i] = static_cast<uint16_t>(sample(random));
+      g[i] = static_cast<uint16_t>(sample(random));
+      b[i] = static_cast<uint16_t>(sample(random));
+    }
+    for (DigitalTvStudioEncodingRec rec : kRecs) {
+      ExpectRowMatchesConvert(SRgbToSYccConverter<uint16_t>(bit_depth, rec),
+                              r, g, b);
+    }
+  }
+}
+
+TEST(SRgbToSYccConverterTest, MapsGraysOntoCenteredChroma) {
+  const SRgbToSYccConverter<uint8_t> converter(8);
+  for (int v : {0, 1, 127, 128, 254, 255}) {
+    const uint8_t sample = static_cast<uint8_t>(v);
+    Ycc<uint8_t> ycc;
+    converter.Convert({sample, sample, sample}, ycc);
+    EXPECT_EQ(ycc.y, sample);
+    EXPECT_EQ(ycc.cb, 128);
+    EXPECT_EQ(ycc.cr, 128);
+  }
+}
+}  // namespace
+}  // namespace imaging
+}  // namespace ws
@@ -1,4 +1,7 @@
 #include "ws/imaging/pixel/color_formats/sycc/sycc_to_srgb_converter.h"
+
+#include <cassert>
+
 namespace ws {
 namespace imaging {
 
@@ -6,16 +9,30 @@ template <IsAllowedPixelNumericType T>
 SYccToRgbConverter<T>::SYccToRgbConverter(
     uint8_t bit_depth, PixelColorConverter<T>::DigitalTvStudioEncodingRec rec)
     : PixelColorConverter<T>(bit_depth),
-      coeffs_(PixelColorConverter<T>::GetEncodingCoefficients(rec)) {}
+      coeffs_(PixelColorConverter<T>::GetEncodingCoefficients(rec)),
+      row_matrix_{} {
+  if constexpr (sizeof(T) <= 2) {
+    row_matrix_ = internal::YccToRgbMatrix(coeffs_, this->RowMaxValue());
+  }
+}
 
 template <IsAllowedPixelNumericType T>
 void SYccToRgbConverter<T>::Convert(const Ycc<T>& ycc, Rgb<T>& rgb) const {
+  if constexpr (sizeof(T) <= 2) {
+    rgb.r = static_cast<T>(row_matrix_.Apply(0, ycc.y, ycc.cb, ycc.cr));
+    rgb.g = static_cast<T>(row_matrix_.Apply(1, ycc.y, ycc.cb, ycc.cr));
+    rgb.b = static_cast<T>(row_matrix_.Apply(2, ycc.y, ycc.cb, ycc.cr));
+    return;
+  }
+
   double y = static_cast<double>(ycc.y) / this->max_value_;
   double cb = static_cast<double>(ycc.cb) / this->max_value_ - 0.5;
   double cr = static_cast<double>(ycc.cr) / this->max_value_ - 0.5;
 
   double r = y + (2.0 * (1.0 - coeffs_.r)) * cr;
-  double g = y - (2.0 * coeffs_.b * cb + 2.0 * coeffs_.r * cr) / coeffs_.g;
+  double g = y - (2.0 * coeffs_.b * (1.0 - coeffs_.b) * cb +
+                  2.0 * coeffs_.r * (1.0 - coeffs_.r) * cr) /
+                     coeffs_.g;
   double b = y + (2.0 * (1.0 - coeffs_.b)) * cb;
 
   rgb.r = static_cast<T>(r * this->max_value_);
@@ -23,6 +40,28 @@ void SYccToRgbConverter<T>::Convert(const Ycc<T>& ycc, Rgb<T>& rgb) const {
   rgb.b = static_cast<T>(b * this->max_value_);
 }
 
+template <IsAllowedPixelNumericType T>
+void SYccToRgbConverter<T>::ConvertRow(std::span<const T> y,
+                                       std::span<const T> cb,
+                                       std::span<const T> cr, std::span<T> r,
+                                       std::span<T> g, std::span<T> b) const {
+  assert(cb.size() == y.size() && cr.size() == y.size() &&
+         r.size() == y.size() && g.size() == y.size() &&
+         b.size() == y.size() && "Row planes differ in size");
+  if constexpr (sizeof(T) <= 2) {
+    internal::TransformYccRow(row_matrix_, y.data(), cb.data(), cr.data(),
+                              r.data(), g.data(), b.data(), y.size());
+  } else {
+    Rgb<T> rgb;
+    for (std::size_t i = 0; i < y.size(); ++i) {
+      Convert({y[i], cb[i], cr[i]}, rgb);
+      r[i] = rgb.r;
+      g[i] = rgb.g;
+      b[i] = rgb.b;
+    }
+  }
+}
+
 template class SYccToRgbConverter<uint8_t>;
 template class SYccToRgbConverter<int8_t>;
 template class SYccToRgbConverter<uint16_t>;
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <span>
+
 #include "ws/imaging/pixel/color_formats/srgb/rgb.h"
 #include "ws/imaging/pixel/color_formats/sycc/ycc.h"
+#include "ws/imaging/pixel/color_formats/sycc/ycc_row_kernels.h"
 #include "ws/imaging/pixel/pixel_color_converter.h"
 namespace ws {
 namespace imaging {
@@ -14,10 +17,21 @@ class SYccToRgbConverter : public PixelColorConverter<T> {
       PixelColorConverter<T>::DigitalTvStudioEncodingRec rec =
           PixelColorConverter<T>::DigitalTvStudioEncodingRec::kBT2020);
 
+  /** Samples of up to 16 bits go through a Q14 fixed-point transform
+      that rounds to nearest, clamps to the sample range and centers
+      chroma at 2^(bits - 1). Wider samples are converted in double. */
   void Convert(const Ycc<T>& ycc, Rgb<T>& rgb) const;
 
+  /** Converts a row of planar samples; all spans must be the same size.
+      Samples of up to 16 bits go through the transform Convert uses, with
+      SIMD where the CPU allows, so the results are identical. */
+  void ConvertRow(std::span<const T> y, std::span<const T> cb,
+                  std::span<const T> cr, std::span<T> r, std::span<T> g,
+                  std::span<T> b) const;
+
  private:
   Rgb<double> coeffs_;
+  internal::YccRowMatrix row_matrix_;
 };
 
 }  // namespace imaging
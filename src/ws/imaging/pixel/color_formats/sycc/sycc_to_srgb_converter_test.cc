@@ -0,0 +1,98 @@
+#include "ws/imaging/pixel/color_formats/sycc/sycc_to_srgb_converter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "ws/imaging/pixel/color_formats/srgb/srgb_to_sycc_converter.h"
+
+namespace ws {
+namespace imaging {
+namespace {
+constexpr DigitalTvStudioEncodingRec kRecs[] = {
+    DigitalTvStudioEncodingRec::kBT601, DigitalTvStudioEncodingRec::kBT709,
+    DigitalTvStudioEncodingRec::kBT2020};
+
+template <typename T>
+void ExpectRowMatchesConvert(const SYccToRgbConverter<T>& converter,
+                             const std::vector<T>& y, const std::vector<T>& cb,
+                             const std::vector<T>& cr) {
+  const std::size_t count = y.size();
+  std::vector<T> r(count), g(count), b(count);
+  converter.ConvertRow(std::span<const T>(y), std::span<const T>(cb),
+                       std::span<const T>(cr), std::span<T>(r),
+                       std::span<T>(g), std::span<T>(b));
+  for (std::size_t i = 0; i < count; ++i) {
+    Rgb<T> rgb;
+    converter.Convert({y[i], cb[i], cr[i]}, rgb);
+    ASSERT_EQ(r[i], rgb.r) << i;
+    ASSERT_EQ(g[i], rgb.g) << i;
+    ASSERT_EQ(b[i], rgb.b) << i;
+  }
+}
+
+TEST(SYccToRgbConverterTest, ConvertRowMatchesConvertForEightBitYcc) {
+  for (DigitalTvStudioEncodingRec rec : kRecs) {
+    const SYccToRgbConverter<uint8_t> converter(8, rec);
+    std::vector<uint8_t> y(256), cb(256), cr(256);
+    for (int i = 0; i < 256; ++i) cr[i] = static_cast<uint8_t>(i);
+    for (int luma = 0; luma < 256; luma += 5) {
+      for (int blue = 0; blue < 256; ++blue) {
+        std::fill(y.begin(), y.end(), static_cast<uint8_t>(luma));
+        std::fill(cb.begin(), cb.end(), static_cast<uint8_t>(blue));
+        ExpectRowMatchesConvert(converter, y, cb, cr);
+      }
+    }
+  }
+}
+
+TEST(SYccToRgbConverterTest, ConvertRowMatchesConvertForWideSamples) {
+  std::mt19937 random(11);
+  for (uint8_t bit_depth : {10, 12, 16}) {
+    SCOPED_TRACE(static_cast<int>(bit_depth));
+    const uint32_t max_value = (uint32_t{1} << bit_depth) - 1;
+    std::uniform_int_distribution<uint32_t> sample(0, max_value);
+    std::vector<uint16_t> y(4099), cb(4099), cr(4099);
+    for (std::size_t i = 0; i < y.size(); ++i) {
+      y[i] = static_cast<uint16_t>(sample(random));
+      cb[i] = static_cast<uint16_t>(sample(random));
+      cr[i] = static_cast<uint16_t>(sample(random));
+    }
+    for (DigitalTvStudioEncodingRec rec : kRecs) {
+      ExpectRowMatchesConvert(SYccToRgbConverter<uint16_t>(bit_depth, rec),
+                              y, cb, cr);
+    }
+  }
+}
+
+TEST(SYccToRgbConverterTest, RoundTripsEightBitRgbWithinOneCodeValue) {
+  for (DigitalTvStudioEncodingRec rec : kRecs) {
+    const SRgbToSYccConverter<uint8_t> forward(8, rec);
+    const SYccToRgbConverter<uint8_t> backward(8, rec);
+    for (int red = 0; red < 256; red += 5) {
+      for (int green = 0; green < 256; green += 3) {
+        for (int blue = 0; blue < 256; blue += 7) {
+          const Rgb<uint8_t> rgb = {static_cast<uint8_t>(red),
+                                    static_cast<uint8_t>(green),
+                                    static_cast<uint8_t>(blue)};
+          Ycc<uint8_t> ycc;
+          Rgb<uint8_t> back;
+          forward.Convert(rgb, ycc);
+          backward.Convert(ycc, back);
+          ASSERT_LE(std::abs(back.r - rgb.r), 1);
+          ASSERT_LE(std::abs(back.g - rgb.g), 1);
+          ASSERT_LE(std::abs(back.b - rgb.b), 1);
+        }
+      }
+    }
+  }
+}
+}  // namespace
+}  // namespace imaging
+}  // namespace ws
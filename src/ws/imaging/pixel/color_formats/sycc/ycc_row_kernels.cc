@@ -0,0 +1,298 @@
+#include "ws/imaging/pixel/color_formats/sycc/ycc_row_kernels.h"
+
+#include <limits>
+#include <type_traits>
+
+#include "ws/machine.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#include <immintrin.h>
+#define WSCOMMON_YCC_X86 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define WSCOMMON_YCC_NEON 1
+#endif
+
+namespace ws {
+namespace imaging {
+namespace internal {
+namespace {
+constexpr int kShift = YccRowMatrix::kShift;
+constexpr int32_t kBias = YccRowMatrix::kBias;
+
+template <typename T>
+void TransformScalar(const YccRowMatrix& matrix, const T* in0, const T* in1,
+                     const T* in2, T* out0, T* out1, T* out2,
+                     std::size_t begin, std::size_t count) {
+  for (std::size_t i = begin; i < count; ++i) {
+    const int32_t x0 = static_cast<int32_t>(in0[i]);
+    const int32_t x1 = static_cast<int32_t>(in1[i]);
+    const int32_t x2 = static_cast<int32_t>(in2[i]);
+    out0[i] = static_cast<T>(matrix.Apply(0, x0, x1, x2));
+    out1[i] = static_cast<T>(matrix.Apply(1, x0, x1, x2));
+    out2[i] = static_cast<T>(matrix.Apply(2, x0, x1, x2));
+  }
+}
+
+/** Two Q14 coefficients packed for a pmaddwd against interleaved lanes. */
+int32_t PackPair(int16_t first, int16_t second) {
+  return static_cast<int32_t>(static_cast<uint16_t>(first) |
+                              static_cast<uint32_t>(
+                                  static_cast<uint16_t>(second))
+                                  << 16);
+}
+
+#if defined(WSCOMMON_YCC_X86)
+// The x86 kernels interleave (in0, in1) and (in2, 0) so that two
+// pmaddwd per row give the three products already summed in 32 bits. The
+// signed saturating pack clamps below at the biased zero, pminsw clamps
+// above at the biased maximum, and flipping the sign bit removes the bias.
+struct Sse2Row {
+  __m128i c01;
+  __m128i c2;
+  __m128i offset;
+};
+
+WSCOMMON_TARGET_SSE2 inline __m128i Sse2Load(const uint8_t* p) {
+  return _mm_unpacklo_epi8(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)),
+      _mm_setzero_si128());
+}
+
+WSCOMMON_TARGET_SSE2 inline __m128i Sse2Load(const uint16_t* p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+WSCOMMON_TARGET_SSE2 inline void Sse2Store(uint8_t* p, __m128i v) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(v, v));
+}
+
+WSCOMMON_TARGET_SSE2 inline void Sse2Store(uint16_t* p, __m128i v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+WSCOMMON_TARGET_SSE2 inline __m128i Sse2Apply(const Sse2Row& row,
+                                              __m128i x01_lo, __m128i x01_hi,
+                                              __m128i x2_lo, __m128i x2_hi,
+                                              __m128i high, __m128i bias) {
+  __m128i lo = _mm_add_epi32(_mm_madd_epi16(x01_lo, row.c01),
+                             _mm_madd_epi16(x2_lo, row.c2));
+  __m128i hi = _mm_add_epi32(_mm_madd_epi16(x01_hi, row.c01),
+                             _mm_madd_epi16(x2_hi, row.c2));
+  lo = _mm_srai_epi32(_mm_add_epi32(lo, row.offset), kShift);
+  hi = _mm_srai_epi32(_mm_add_epi32(hi, row.offset), kShift);
+  return _mm_xor_si128(_mm_min_epi16(_mm_packs_epi32(lo, hi), high), bias);
+}
+
+template <typename T>
+WSCOMMON_TARGET_SSE2 std::size_t TransformSse2(
+    const YccRowMatrix& matrix, const T* in0, const T* in1, const T* in2,
+    T* out0, T* out1, T* out2, std::size_t count) {
+  const __m128i bias = _mm_set1_epi16(std::numeric_limits<int16_t>::min());
+  const __m128i high =
+      _mm_set1_epi16(static_cast<int16_t>(matrix.max_value - kBias));
+  const __m128i zero = _mm_setzero_si128();
+  Sse2Row rows[3];
+  for (int r = 0; r < 3; ++r) {
+    rows[r].c01 = _mm_set1_epi32(
+        PackPair(matrix.coeffs[r][0], matrix.coeffs[r][1]));
+    rows[r].c2 = _mm_set1_epi32(PackPair(matrix.coeffs[r][2], 0));
+    rows[r].offset = _mm_set1_epi32(matrix.offsets[r]);
+  }
+
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m128i x0 = _mm_xor_si128(Sse2Load(in0 + i), bias);
+    const __m128i x1 = _mm_xor_si128(Sse2Load(in1 + i), bias);
+    const __m128i x2 = _mm_xor_si128(Sse2Load(in2 + i), bias);
+    const __m128i x01_lo = _mm_unpacklo_epi16(x0, x1);
+    const __m128i x01_hi = _mm_unpackhi_epi16(x0, x1);
+    const __m128i x2_lo = _mm_unpacklo_epi16(x2, zero);
+    const __m128i x2_hi = _mm_unpackhi_epi16(x2, zero);
+    Sse2Store(out0 + i,
+              Sse2Apply(rows[0], x01_lo, x01_hi, x2_lo, x2_hi, high, bias));
+    Sse2Store(out1 + i,
+              Sse2Apply(rows[1], x01_lo, x01_hi, x2_lo, x2_hi, high, bias));
+    Sse2Store(out2 + i,
+              Sse2Apply(rows[2], x01_lo, x01_hi, x2_lo, x2_hi, high, bias));
+  }
+  return i;
+}
+
+// AVX2 unpacks and packs work within 128-bit lanes; the two cancel out,
+// so only the 8-bit store needs a cross-lane permute.
+struct Avx2Row {
+  __m256i c01;
+  __m256i c2;
+  __m256i offset;
+};
+
+WSCOMMON_TARGET_AVX2 inline __m256i Avx2Load(const uint8_t* p) {
+  return _mm256_cvtepu8_epi16(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+WSCOMMON_TARGET_AVX2 inline __m256i Avx2Load(const uint16_t* p) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+WSCOMMON_TARGET_AVX2 inline void Avx2Store(uint8_t* p, __m256i v) {
+  const __m256i packed =
+      _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p),
+                   _mm256_castsi256_si128(packed));
+}
+
+WSCOMMON_TARGET_AVX2 inline void Avx2Store(uint16_t* p, __m256i v) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+WSCOMMON_TARGET_AVX2 inline __m256i Avx2Apply(const Avx2Row& row,
+                                              __m256i x01_lo, __m256i x01_hi,
+                                              __m256i x2_lo, __m256i x2_hi,
+                                              __m256i high, __m256i bias) {
+  __m256i lo = _mm256_add_epi32(_mm256_madd_epi16(x01_lo, row.c01),
+                                _mm256_madd_epi16(x2_lo, row.c2));
+  __m256i hi = _mm256_add_epi32(_mm256_madd_epi16(x01_hi, row.c01),
+                                _mm256_madd_epi16(x2_hi, row.c2));
+  lo = _mm256_srai_epi32(_mm256_add_epi32(lo, row.offset), kShift);
+  hi = _mm256_srai_epi32(_mm256_add_epi32(hi, row.offset), kShift);
+  return _mm256_xor_si256(
+      _mm256_min_epi16(_mm256_packs_epi32(lo, hi), high), bias);
+}
+
+template <typename T>
+WSCOMMON_TARGET_AVX2 std::size_t TransformAvx2(
+    const YccRowMatrix& matrix, const T* in0, const T* in1, const T* in2,
+    T* out0, T* out1, T* out2, std::size_t count) {
+  const __m256i bias =
+      _mm256_set1_epi16(std::numeric_limits<int16_t>::min());
+  const __m256i high =
+      _mm256_set1_epi16(static_cast<int16_t>(matrix.max_value - kBias));
+  const __m256i zero = _mm256_setzero_si256();
+  Avx2Row rows[3];
+  for (int r = 0; r < 3; ++r) {
+    rows[r].c01 = _mm256_set1_epi32(
+        PackPair(matrix.coeffs[r][0], matrix.coeffs[r][1]));
+    rows[r].c2 = _mm256_set1_epi32(PackPair(matrix.coeffs[r][2], 0));
+    rows[r].offset = _mm256_set1_epi32(matrix.offsets[r]);
+  }
+
+  std::size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const __m256i x0 = _mm256_xor_si256(Avx2Load(in0 + i), bias);
+    const __m256i x1 = _mm256_xor_si256(Avx2Load(in1 + i), bias);
+    const __m256i x2 = _mm256_xor_si256(Avx2Load(in2 + i), bias);
+    const __m256i x01_lo = _mm256_unpacklo_epi16(x0, x1);
+    const __m256i x01_hi = _mm256_unpackhi_epi16(x0, x1);
+    const __m256i x2_lo = _mm256_unpacklo_epi16(x2, zero);
+    const __m256i x2_hi = _mm256_unpackhi_epi16(x2, zero);
+    Avx2Store(out0 + i,
+              Avx2Apply(rows[0], x01_lo, x01_hi, x2_lo, x2_hi, high, bias));
+    Avx2Store(out1 + i,
+              Avx2Apply(rows[1], x01_lo, x01_hi, x2_lo, x2_hi, high, bias));
+    Avx2Store(out2 + i,
+              Avx2Apply(rows[2], x01_lo, x01_hi, x2_lo, x2_hi, high, bias));
+  }
+  return i;
+}
+#elif defined(WSCOMMON_YCC_NEON)
+inline int16x8_t NeonLoad(const uint8_t* p) {
+  return vreinterpretq_s16_u16(
+      veorq_u16(vmovl_u8(vld1_u8(p)), vdupq_n_u16(0x8000)));
+}
+
+inline int16x8_t NeonLoad(const uint16_t* p) {
+  return vreinterpretq_s16_u16(veorq_u16(vld1q_u16(p), vdupq_n_u16(0x8000)));
+}
+
+inline void NeonStore(uint8_t* p, uint16x8_t v) { vst1_u8(p, vmovn_u16(v)); }
+
+inline void NeonStore(uint16_t* p, uint16x8_t v) { vst1q_u16(p, v); }
+
+inline uint16x8_t NeonApply(const int16_t (&coeffs)[3], int32_t offset,
+                            int16x8_t x0, int16x8_t x1, int16x8_t x2,
+                            int16x8_t high) {
+  int32x4_t lo = vmull_n_s16(vget_low_s16(x0), coeffs[0]);
+  lo = vmlal_n_s16(lo, vget_low_s16(x1), coeffs[1]);
+  lo = vmlal_n_s16(lo, vget_low_s16(x2), coeffs[2]);
+  int32x4_t hi = vmull_n_s16(vget_high_s16(x0), coeffs[0]);
+  hi = vmlal_n_s16(hi, vget_high_s16(x1), coeffs[1]);
+  hi = vmlal_n_s16(hi, vget_high_s16(x2), coeffs[2]);
+  lo = vshrq_n_s32(vaddq_s32(lo, vdupq_n_s32(offset)), kShift);
+  hi = vshrq_n_s32(vaddq_s32(hi, vdupq_n_s32(offset)), kShift);
+  const int16x8_t v =
+      vminq_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)), high);
+  return veorq_u16(vreinterpretq_u16_s16(v), vdupq_n_u16(0x8000));
+}
+
+template <typename T>
+std::size_t TransformNeon(const YccRowMatrix& matrix, const T* in0,
+                          const T* in1, const T* in2, T* out0, T* out1,
+                          T* out2, std::size_t count) {
+  const int16x8_t high =
+      vdupq_n_s16(static_cast<int16_t>(matrix.max_value - kBias));
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const int16x8_t x0 = NeonLoad(in0 + i);
+    const int16x8_t x1 = NeonLoad(in1 + i);
+    const int16x8_t x2 = NeonLoad(in2 + i);
+    NeonStore(out0 + i, NeonApply(matrix.coeffs[0], matrix.offsets[0], x0,
+                                  x1, x2, high));
+    NeonStore(out1 + i, NeonApply(matrix.coeffs[1], matrix.offsets[1], x0,
+                                  x1, x2, high));
+    NeonStore(out2 + i, NeonApply(matrix.coeffs[2], matrix.offsets[2], x0,
+                                  x1, x2, high));
+  }
+  return i;
+}
+#endif
+}  // namespace
+
+template <typename T>
+void TransformYccRow(const YccRowMatrix& matrix, const T* in0, const T* in1,
+                     const T* in2, T* out0, T* out1, T* out2,
+                     std::size_t count) {
+  TransformYccRow(ws::internal::CurrentSimdLevel(), matrix, in0, in1, in2,
+                  out0, out1, out2, count);
+}
+
+template <typename T>
+void TransformYccRow(ws::internal::SimdLevel level, const YccRowMatrix& matrix,
+                     const T* in0, const T* in1, const T* in2, T* out0,
+                     T* out1, T* out2, std::size_t count) {
+  std::size_t done = 0;
+  if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>) {
+#if defined(WSCOMMON_YCC_X86)
+    if (level == ws::internal::SimdLevel::kAvx2) {
+      done = TransformAvx2(matrix, in0, in1, in2, out0, out1, out2, count);
+    } else if (level == ws::internal::SimdLevel::kSse2) {
+      done = TransformSse2(matrix, in0, in1, in2, out0, out1, out2, count);
+    }
+#elif defined(WSCOMMON_YCC_NEON)
+    if (level == ws::internal::SimdLevel::kNeon) {
+      done = TransformNeon(matrix, in0, in1, in2, out0, out1, out2, count);
+    }
+#endif
+  }
+
+  TransformScalar(matrix, in0, in1, in2, out0, out1, out2, done, count);
+}
+
+#define WSCOMMON_INSTANTIATE_YCC_ROWS(T)                                     \
+  template void TransformYccRow<T>(const YccRowMatrix&, const T*, const T*, \
+                                   const T*, T*, T*, T*, std::size_t);      \
+  template void TransformYccRow<T>(ws::internal::SimdLevel,                 \
+                                   const YccRowMatrix&, const T*, const T*, \
+                                   const T*, T*, T*, T*, std::size_t);
+
+WSCOMMON_INSTANTIATE_YCC_ROWS(uint8_t)
+WSCOMMON_INSTANTIATE_YCC_ROWS(int8_t)
+WSCOMMON_INSTANTIATE_YCC_ROWS(uint16_t)
+WSCOMMON_INSTANTIATE_YCC_ROWS(int16_t)
+
+#undef WSCOMMON_INSTANTIATE_YCC_ROWS
+}  // namespace internal
+}  // namespace imaging
+}  // namespace ws
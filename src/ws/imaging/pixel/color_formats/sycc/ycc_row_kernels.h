@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "ws/imaging/pixel/color_formats/srgb/rgb.h"
+#include "ws/machine.h"
+
+namespace ws {
+namespace imaging {
+namespace internal {
+/** Affine 3x3 transform between RGB and YCbCr in Q14 fixed point:
+    out[i] = clamp(round(sum_j coeffs[i][j] * (in[j] - in_center[j])) +
+                   out_center[i], 0, max).
+    Inputs and outputs are handled as x - 32768 so that samples of up to
+    16 bits fit signed 16-bit lanes; the offsets fold that bias, the
+    centers and the rounding constant together. */
+struct YccRowMatrix {
+  static constexpr int kShift = 14;
+  static constexpr int32_t kBias = 32768;
+
+  /** Output row of one pixel; the scalar reference for every kernel. */
+  constexpr int32_t Apply(int row, int32_t in0, int32_t in1,
+                          int32_t in2) const {
+    const int32_t acc = coeffs[row][0] * (in0 - kBias) +
+                        coeffs[row][1] * (in1 - kBias) +
+                        coeffs[row][2] * (in2 - kBias);
+    return std::clamp((acc + offsets[row]) >> kShift, -kBias,
+                      max_value - kBias) +
+           kBias;
+  }
+
+  int16_t coeffs[3][3];
+  int32_t offsets[3];
+  int32_t max_value;
+};
+
+/** Builds the fixed-point form of a transform given in sample units. A
+    row's coefficients are rounded so that they keep their exact sum,
+    which keeps grays gray, and the centers are applied with the rounded
+    coefficients, so a centered input maps exactly onto its output center.
+    max_value must not exceed 65535. */
+constexpr YccRowMatrix MakeYccRowMatrix(const double (&coeffs)[3][3],
+                                        const int32_t (&in_centers)[3],
+                                        const int32_t (&out_centers)[3],
+                                        uint32_t max_value);
+
+/** The transforms SRgbToSYccConverter and SYccToRgbConverter apply, for
+    luma coefficients k and chroma centered at 2^(bits - 1). */
+constexpr YccRowMatrix RgbToYccMatrix(const Rgb<double>& k,
+                                      uint32_t max_value);
+constexpr YccRowMatrix YccToRgbMatrix(const Rgb<double>& k,
+                                      uint32_t max_value);
+
+/** Applies the transform to count samples of three planes. The scalar
+    loop is the reference: the SSE2, AVX2 and NEON kernels, picked at run
+    time for uint8_t and uint16_t, produce bit-identical results. */
+template <typename T>
+void TransformYccRow(const YccRowMatrix& matrix, const T* in0, const T* in1,
+                     const T* in2, T* out0, T* out1, T* out2,
+                     std::size_t count);
+
+/** Like TransformYccRow, with the kernel for level instead of the best one
+    the CPU supports, so each kernel can be checked against the scalar
+    loop. level must be kScalar or supported by the CPU. */
+template <typename T>
+void TransformYccRow(ws::internal::SimdLevel level, const YccRowMatrix& matrix,
+                     const T* in0, const T* in1, const T* in2, T* out0,
+                     T* out1, T* out2, std::size_t count);
+
+// ============================================================================
+// Implementation details for YccRowMatrix
+// ============================================================================
+
+constexpr int64_t RoundToInt64(double value) {
+  return static_cast<int64_t>(value < 0.0 ? value - 0.5 : value + 0.5);
+}
+
+constexpr YccRowMatrix MakeYccRowMatrix(const double (&coeffs)[3][3],
+                                        const int32_t (&in_centers)[3],
+                                        const int32_t (&out_centers)[3],
+                                        uint32_t max_value) {
+  assert(max_value <= 0xFFFF && "Samples are wider than 16 bits");
+  constexpr int kShift = YccRowMatrix::kShift;
+  constexpr int32_t kBias = YccRowMatrix::kBias;
+  constexpr double kOne = 1 << kShift;
+  YccRowMatrix matrix{};
+  matrix.max_value = static_cast<int32_t>(max_value);
+  for (int i = 0; i < 3; ++i) {
+    double exact_sum = 0.0;
+    int64_t sum = 0;
+    int64_t rounded[3] = {};
+    int worst = 0;
+    double worst_error = -1.0;
+    for (int j = 0; j < 3; ++j) {
+      const double scaled = coeffs[i][j] * kOne;
+      rounded[j] = RoundToInt64(scaled);
+      exact_sum += coeffs[i][j];
+      sum += rounded[j];
+      const double error = scaled - static_cast<double>(rounded[j]);
+      if ((error < 0.0 ? -error : error) > worst_error) {
+        worst = j;
+        worst_error = error < 0.0 ? -error : error;
+      }
+    }
+
+    // Nudge the coefficient that rounding moved the most.
+    const int64_t target = RoundToInt64(exact_sum * kOne);
+    rounded[worst] += target - sum;
+    int64_t offset = int64_t{out_centers[i]} << kShift;
+    for (int j = 0; j < 3; ++j) {
+      assert(rounded[j] >= std::numeric_limits<int16_t>::min() &&
+             rounded[j] <= std::numeric_limits<int16_t>::max() &&
+             "Coefficient does not fit Q14");
+      matrix.coeffs[i][j] = static_cast<int16_t>(rounded[j]);
+      offset += rounded[j] * (kBias - in_centers[j]);
+    }
+
+    offset += (1 << (kShift - 1)) - (int64_t{kBias} << kShift);
+    assert(offset >= std::numeric_limits<int32_t>::min() &&
+           offset <= std::numeric_limits<int32_t>::max() &&
+           "Offset does not fit 32 bits");
+    matrix.offsets[i] = static_cast<int32_t>(offset);
+  }
+
+  return matrix;
+}
+
+constexpr YccRowMatrix RgbToYccMatrix(const Rgb<double>& k,
+                                      uint32_t max_value) {
+  const double cb_scale = 0.5 / (1.0 - k.b);
+  const double cr_scale = 0.5 / (1.0 - k.r);
+  const double coeffs[3][3] = {{k.r, k.g, k.b},
+                               {-k.r * cb_scale, -k.g * cb_scale, 0.5},
+                               {0.5, -k.g * cr_scale, -k.b * cr_scale}};
+  const int32_t half = static_cast<int32_t>((max_value + 1) / 2);
+  const int32_t in_centers[3] = {0, 0, 0};
+  const int32_t out_centers[3] = {0, half, half};
+  return MakeYccRowMatrix(coeffs, in_centers, out_centers, max_value);
+}
+
+constexpr YccRowMatrix YccToRgbMatrix(const Rgb<double>& k,
+                                      uint32_t max_value) {
+  const double coeffs[3][3] = {
+      {1.0, 0.0, 2.0 * (1.0 - k.r)},
+      {1.0, -2.0 * k.b * (1.0 - k.b) / k.g, -2.0 * k.r * (1.0 - k.r) / k.g},
+      {1.0, 2.0 * (1.0 - k.b), 0.0}};
+  const int32_t half = static_cast<int32_t>((max_value + 1) / 2);
+  const int32_t in_centers[3] = {0, half, half};
+  const int32_t out_centers[3] = {0, 0, 0};
+  return MakeYccRowMatrix(coeffs, in_centers, out_centers, max_value);
+}
+}  // namespace internal
+}  // namespace imaging
+}  // namespace ws
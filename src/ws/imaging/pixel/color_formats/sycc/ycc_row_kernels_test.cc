@@ -0,0 +1,87 @@
+#include "ws/imaging/pixel/color_formats/sycc/ycc_row_kernels.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "ws/imaging/pixel/pixel_color_converter.h"
+#include "ws/imaging/pixel/simd_test_util.h"
+
+namespace ws {
+namespace imaging {
+namespace internal {
+namespace {
+using ws::internal::SimdLevel;
+
+/** Random samples up to max_value, with both ends of the range and an odd
+    length so every kernel runs its vector loop and its scalar tail. */
+template <typename T>
+std::vector<T> RandomPlane(std::mt19937& random, uint32_t max_value) {
+  std::vector<T> plane(1021);
+  std::uniform_int_distribution<uint32_t> sample(0, max_value);
+  for (T& value : plane) value = static_cast<T>(sample(random));
+  plane[0] = 0;
+  plane[1] = static_cast<T>(max_value);
+  return plane;
+}
+
+template <typename T>
+void ExpectMatchesApply(const YccRowMatrix& matrix, uint32_t max_value) {
+  std::mt19937 random(max_value);
+  const std::vector<T> in0 = RandomPlane<T>(random, max_value);
+  const std::vector<T> in1 = RandomPlane<T>(random, max_value);
+  const std::vector<T> in2 = RandomPlane<T>(random, max_value);
+  const std::size_t count = in0.size();
+  for (SimdLevel level : SupportedSimdLevels()) {
+    SCOPED_TRACE(static_cast<int>(level));
+    std::vector<T> out0(count), out1(count), out2(count);
+    TransformYccRow(level, matrix, in0.data(), in1.data(), in2.data(),
+                    out0.data(), out1.data(), out2.data(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(out0[i], matrix.Apply(0, in0[i], in1[i], in2[i])) << i;
+      ASSERT_EQ(out1[i], matrix.Apply(1, in0[i], in1[i], in2[i])) << i;
+      ASSERT_EQ(out2[i], matrix.Apply(2, in0[i], in1[i], in2[i])) << i;
+    }
+  }
+}
+
+constexpr DigitalTvStudioEncodingRec kRecs[] = {
+    DigitalTvStudioEncodingRec::kBT601, DigitalTvStudioEncodingRec::kBT709,
+    DigitalTvStudioEncodingRec::kBT2020};
+
+TEST(TransformYccRowTest, EightBitKernelsMatchApply) {
+  for (DigitalTvStudioEncodingRec rec : kRecs) {
+    const Rgb<double> k = EncodingCoefficients(rec);
+    ExpectMatchesApply<uint8_t>(RgbToYccMatrix(k, 255), 255);
+    ExpectMatchesApply<uint8_t>(YccToRgbMatrix(k, 255), 255);
+  }
+}
+
+TEST(TransformYccRowTest, SixteenBitKernelsMatchApply) {
+  for (DigitalTvStudioEncodingRec rec : kRecs) {
+    const Rgb<double> k = EncodingCoefficients(rec);
+    for (uint32_t max_value : {1023u, 4095u, 65535u}) {
+      SCOPED_TRACE(max_value);
+      ExpectMatchesApply<uint16_t>(RgbToYccMatrix(k, max_value), max_value);
+      ExpectMatchesApply<uint16_t>(YccToRgbMatrix(k, max_value), max_value);
+    }
+  }
+}
+
+TEST(TransformYccRowTest, KeepsGraysGray) {
+  for (DigitalTvStudioEncodingRec rec : kRecs) {
+    const YccRowMatrix matrix = RgbToYccMatrix(EncodingCoefficients(rec), 255);
+    for (int32_t v = 0; v <= 255; ++v) {
+      EXPECT_EQ(matrix.Apply(0, v, v, v), v);
+      EXPECT_EQ(matrix.Apply(1, v, v, v), 128);
+      EXPECT_EQ(matrix.Apply(2, v, v, v), 128);
+    }
+  }
+}
+}  // namespace
+}  // namespace internal
+}  // namespace imaging
+}  // namespace ws
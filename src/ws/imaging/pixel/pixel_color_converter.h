@@ -1,5 +1,8 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <type_traits>
 
 #include "ws/imaging/pixel/color_formats/cmyk/cmyk.h"
 #include "ws/imaging/pixel/color_formats/cmyk/cmyka.h"
@@ -14,47 +17,63 @@
 namespace ws {
 namespace imaging {
 
+enum class DigitalTvStudioEncodingRec { kBT601, kBT709, kBT2020, kBT2100 };
+
+/** Luma coefficients (Kr, Kg, Kb) of an encoding recommendation. */
+constexpr Rgb<double> EncodingCoefficients(DigitalTvStudioEncodingRec rec);
+
 template <IsAllowedPixelNumericType T>
 class PixelColorConverter {
  public:
   virtual ~PixelColorConverter() = default;
 
-  enum class DigitalTvStudioEncodingRec { kBT601, kBT709, kBT2020, kBT2100 };
+  using DigitalTvStudioEncodingRec = ws::imaging::DigitalTvStudioEncodingRec;
 
  protected:
   static constexpr Rgb<double> GetEncodingCoefficients(
       DigitalTvStudioEncodingRec rec);
 
-  // BT.601 (SD)
-  static constexpr Rgb<double> BT601Coefficients = {0.299, 0.587, 0.114};
-  // BT.709 (HD)
-  static constexpr Rgb<double> BT709Coefficients = {0.2126, 0.7152, 0.0722};
-  // BT.2020 (UHD)
-  static constexpr Rgb<double> BT2020Coefficients = {0.2627, 0.6780, 0.0593};
-  // BT.2100 (HDR)
-  static constexpr Rgb<double> BT2100Coefficients = {0.2627, 0.6780, 0.0593};
-
   explicit PixelColorConverter(uint8_t bit_depth);
 
+  /** max_value_ capped to what T holds, as the fixed-point row kernels
+      take it. */
+  uint32_t RowMaxValue() const;
+
   T min_value_;
   T max_value_;
 };
 
-template <IsAllowedPixelNumericType T>
-inline constexpr Rgb<double> PixelColorConverter<T>::GetEncodingCoefficients(
+inline constexpr Rgb<double> EncodingCoefficients(
     DigitalTvStudioEncodingRec rec) {
   switch (rec) {
     case DigitalTvStudioEncodingRec::kBT601:
-      return BT601Coefficients;
+      // BT.601 (SD)
+      return {0.299, 0.587, 0.114};
     case DigitalTvStudioEncodingRec::kBT709:
-      return BT709Coefficients;
+      // BT.709 (HD)
+      return {0.2126, 0.7152, 0.0722};
     case DigitalTvStudioEncodingRec::kBT2100:
-      return BT2100Coefficients;
+      // BT.2100 (HDR)
+      return {0.2627, 0.6780, 0.0593};
     case DigitalTvStudioEncodingRec::kBT2020:
     default:
-      return BT2020Coefficients;
+      // BT.2020 (UHD)
+      return {0.2627, 0.6780, 0.0593};
   }
 }
 
+template <IsAllowedPixelNumericType T>
+inline constexpr Rgb<double> PixelColorConverter<T>::GetEncodingCoefficients(
+    DigitalTvStudioEncodingRec rec) {
+  return EncodingCoefficients(rec);
+}
+
+template <IsAllowedPixelNumericType T>
+inline uint32_t PixelColorConverter<T>::RowMaxValue() const {
+  return std::min<uint32_t>(
+      static_cast<std::make_unsigned_t<T>>(max_value_),
+      static_cast<uint32_t>(std::numeric_limits<T>::max()));
+}
+
 }  // namespace imaging
 }  // namespace ws
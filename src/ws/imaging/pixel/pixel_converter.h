@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <span>
 
 #include "ws/imaging/pixel/color_formats/cmyk/cmyk.h"
 #include "ws/imaging/pixel/color_formats/cmyk/cmyka.h"
@@ -10,6 +11,7 @@
 #include "ws/imaging/pixel/color_formats/sycc/ycc.h"
 #include "ws/imaging/pixel/color_formats/sycck/ycck.h"
 #include "ws/imaging/pixel/pixel_allowed_types.h"
+#include "ws/imaging/pixel/pixel_kernels.h"
 
 namespace ws {
 namespace imaging {
@@ -25,13 +27,98 @@ concept IsAllowedColorFormat =
     std::bool_constant<IsYccType<T>::value>::value ||
     std::bool_constant<IsYcckType<T>::value>::value;
 
+/** Pixel conversions monomorphized on the bit depth and encoding rec; see
+    PixelKernel for the supported pairs of formats. */
+template <uint8_t kBitDepth,
+          DigitalTvStudioEncodingRec kRec = DigitalTvStudioEncodingRec::kBT2020>
 class PixelConverter {
  public:
-  virtual ~PixelConverter() = default;
+  template <IsAllowedColorFormat T1, IsAllowedColorFormat T2>
+    requires HasPixelKernel<T1, T2, kBitDepth, kRec>
+  static void Convert(const T1& src, T2& dst);
 
   template <IsAllowedColorFormat T1, IsAllowedColorFormat T2>
-  void Convert(const T1& src, T2& dst) const;
+    requires HasPixelKernel<T1, T2, kBitDepth, kRec>
+  static void ConvertRow(std::span<const T1> src, std::span<T2> dst);
 };
 
+template <typename TSrc, typename TDst>
+using PixelRowKernel = void (*)(std::span<const TSrc> src,
+                                std::span<TDst> dst);
+
+/** Bit depths that kernels are instantiated for. */
+inline constexpr uint8_t kPixelKernelBitDepths[] = {8, 10, 12, 16};
+
+/** Looks up the kernel for a bit depth and rec known only at run time, so
+    that an image picks its kernel once instead of per pixel. Returns
+    nullptr when the pair of formats, or the bit depth for the component
+    type, is not supported. */
+template <IsAllowedColorFormat TSrc, IsAllowedColorFormat TDst>
+PixelRowKernel<TSrc, TDst> SelectPixelRowKernel(
+    uint8_t bit_depth, DigitalTvStudioEncodingRec rec);
+
+// ============================================================================
+// Implementation details for PixelConverter
+// ============================================================================
+
+template <uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+template <IsAllowedColorFormat T1, IsAllowedColorFormat T2>
+  requires HasPixelKernel<T1, T2, kBitDepth, kRec>
+inline void PixelConverter<kBitDepth, kRec>::Convert(const T1& src,
+                                                     T2& dst) {
+  PixelKernel<T1, T2, kBitDepth, kRec>::Convert(src, dst);
+}
+
+template <uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+template <IsAllowedColorFormat T1, IsAllowedColorFormat T2>
+  requires HasPixelKernel<T1, T2, kBitDepth, kRec>
+inline void PixelConverter<kBitDepth, kRec>::ConvertRow(
+    std::span<const T1> src, std::span<T2> dst) {
+  PixelKernel<T1, T2, kBitDepth, kRec>::ConvertRow(src, dst);
+}
+
+namespace internal {
+template <typename TSrc, typename TDst, uint8_t kBitDepth>
+constexpr PixelRowKernel<TSrc, TDst> SelectPixelRowKernel(
+    DigitalTvStudioEncodingRec rec) {
+  using Rec = DigitalTvStudioEncodingRec;
+  if constexpr (!HasPixelKernel<TSrc, TDst, kBitDepth, Rec::kBT2020>) {
+    return nullptr;
+  } else if constexpr (!PixelKernel<TSrc, TDst, kBitDepth,
+                                    Rec::kBT2020>::kUsesRec) {
+    return &PixelKernel<TSrc, TDst, kBitDepth, Rec::kBT2020>::ConvertRow;
+  } else {
+    switch (rec) {
+      case Rec::kBT601:
+        return &PixelKernel<TSrc, TDst, kBitDepth, Rec::kBT601>::ConvertRow;
+      case Rec::kBT709:
+        return &PixelKernel<TSrc, TDst, kBitDepth, Rec::kBT709>::ConvertRow;
+      case Rec::kBT2100:
+        return &PixelKernel<TSrc, TDst, kBitDepth, Rec::kBT2100>::ConvertRow;
+      case Rec::kBT2020:
+      default:
+        return &PixelKernel<TSrc, TDst, kBitDepth, Rec::kBT2020>::ConvertRow;
+    }
+  }
+}
+}  // namespace internal
+
+template <IsAllowedColorFormat TSrc, IsAllowedColorFormat TDst>
+inline PixelRowKernel<TSrc, TDst> SelectPixelRowKernel(
+    uint8_t bit_depth, DigitalTvStudioEncodingRec rec) {
+  switch (bit_depth) {
+    case 8:
+      return internal::SelectPixelRowKernel<TSrc, TDst, 8>(rec);
+    case 10:
+      return internal::SelectPixelRowKernel<TSrc, TDst, 10>(rec);
+    case 12:
+      return internal::SelectPixelRowKernel<TSrc, TDst, 12>(rec);
+    case 16:
+      return internal::SelectPixelRowKernel<TSrc, TDst, 16>(rec);
+    default:
+      return nullptr;
+  }
+}
+
 }  // namespace imaging
 }  // namespace ws
@@ -235,14 +235,15 @@ class PixelFormatConstraints {
                                                PixelLayoutFlag::kPlanar,
                                                true};
 
-  static constexpr PixelFormatDetails kI444 = {PixelFormat::kI444,
-                                               ColorSpace::kSYcc,
-                                               ChromaSubsampling::kSamp444,
-                                               3,
-                                               {kI444Order, sizeof(kI444Order)},
-                                               -1,
-                                               PixelLayoutFlag::kPlanar,
-                                               true};
+  static constexpr PixelFormatDetails kI444 = {
+      PixelFormat::kI444,
+      ColorSpace::kSYcc,
+      ChromaSubsampling::kSamp444,
+      3,
+      {kI444Order, sizeof(kI444Order)},
+      -1,
+      PixelLayoutFlag::kPlanar | PixelLayoutFlag::kInterleaved,
+      true};
 };
 }  // namespace imaging
 }  // namespace ws
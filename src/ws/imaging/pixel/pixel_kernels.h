@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "ws/imaging/pixel/color_formats/cmyk/cmyk_row_kernels.h"
+#include "ws/imaging/pixel/color_formats/sycc/ycc_row_kernels.h"
+#include "ws/imaging/pixel/pixel_color_converter.h"
+
+namespace ws {
+namespace imaging {
+/** Whether T can hold samples of kBitDepth bits. */
+template <typename T, uint8_t kBitDepth>
+concept FitsBitDepth =
+    IsAllowedPixelNumericType<T> && kBitDepth >= 1 && kBitDepth <= 16 &&
+    kBitDepth <= std::numeric_limits<T>::digits;
+
+/** Conversion from TSrc to TDst pixels with the bit depth and encoding
+    rec fixed at compile time, so that every constant is constexpr and the
+    row loops can be unrolled and vectorized. The primary template is
+    empty; a pair of formats is supported when a specialization defines
+    Convert and ConvertRow. The results match the converters' ConvertRow
+    bit for bit. kUsesRec is false where the rec does not matter. */
+template <typename TSrc, typename TDst, uint8_t kBitDepth,
+          DigitalTvStudioEncodingRec kRec>
+struct PixelKernel {};
+
+template <typename TSrc, typename TDst, uint8_t kBitDepth,
+          DigitalTvStudioEncodingRec kRec>
+concept HasPixelKernel =
+    requires(const TSrc& src, TDst& dst) {
+      PixelKernel<TSrc, TDst, kBitDepth, kRec>::Convert(src, dst);
+    };
+
+namespace internal {
+/** The row loop shared by the specializations below. */
+template <typename TDerived, typename TSrc, typename TDst>
+struct PixelKernelBase {
+  static void ConvertRow(std::span<const TSrc> src, std::span<TDst> dst) {
+    assert(dst.size() == src.size() && "Rows differ in size");
+    for (std::size_t i = 0; i < src.size(); ++i) {
+      TDerived::Convert(src[i], dst[i]);
+    }
+  }
+};
+}  // namespace internal
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Rgb<T>, Ycc<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Rgb<T>, Ycc<T>, kBitDepth, kRec>,
+                                Rgb<T>, Ycc<T>> {
+  static constexpr bool kUsesRec = true;
+  static constexpr internal::YccRowMatrix kMatrix = internal::RgbToYccMatrix(
+      EncodingCoefficients(kRec), (1u << kBitDepth) - 1);
+
+  static void Convert(const Rgb<T>& src, Ycc<T>& dst) {
+    dst.y = static_cast<T>(kMatrix.Apply(0, src.r, src.g, src.b));
+    dst.cb = static_cast<T>(kMatrix.Apply(1, src.r, src.g, src.b));
+    dst.cr = static_cast<T>(kMatrix.Apply(2, src.r, src.g, src.b));
+  }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Ycc<T>, Rgb<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Ycc<T>, Rgb<T>, kBitDepth, kRec>,
+                                Ycc<T>, Rgb<T>> {
+  static constexpr bool kUsesRec = true;
+  static constexpr internal::YccRowMatrix kMatrix = internal::YccToRgbMatrix(
+      EncodingCoefficients(kRec), (1u << kBitDepth) - 1);
+
+  static void Convert(const Ycc<T>& src, Rgb<T>& dst) {
+    dst.r = static_cast<T>(kMatrix.Apply(0, src.y, src.cb, src.cr));
+    dst.g = static_cast<T>(kMatrix.Apply(1, src.y, src.cb, src.cr));
+    dst.b = static_cast<T>(kMatrix.Apply(2, src.y, src.cb, src.cr));
+  }
+};
+
+/** Luma row of the RGB to YCbCr transform. */
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Rgb<T>, Gray<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Rgb<T>, Gray<T>, kBitDepth, kRec>,
+                                Rgb<T>, Gray<T>> {
+  static constexpr bool kUsesRec = true;
+  static constexpr internal::YccRowMatrix kMatrix = internal::RgbToYccMatrix(
+      EncodingCoefficients(kRec), (1u << kBitDepth) - 1);
+
+  static void Convert(const Rgb<T>& src, Gray<T>& dst) {
+    dst.gray = static_cast<T>(kMatrix.Apply(0, src.r, src.g, src.b));
+  }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Rgba<T>, Ya<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Rgba<T>, Ya<T>, kBitDepth, kRec>,
+                                Rgba<T>, Ya<T>> {
+  static constexpr bool kUsesRec = true;
+  static constexpr internal::YccRowMatrix kMatrix = internal::RgbToYccMatrix(
+      EncodingCoefficients(kRec), (1u << kBitDepth) - 1);
+
+  static void Convert(const Rgba<T>& src, Ya<T>& dst) {
+    dst.gray = static_cast<T>(kMatrix.Apply(0, src.r, src.g, src.b));
+    dst.alpha = src.alpha;
+  }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Gray<T>, Ycc<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Gray<T>, Ycc<T>, kBitDepth, kRec>,
+                                Gray<T>, Ycc<T>> {
+  static constexpr bool kUsesRec = false;
+
+  static void Convert(const Gray<T>& src, Ycc<T>& dst) {
+    constexpr T kHalf = static_cast<T>((1u << kBitDepth) / 2);
+    dst.y = src.gray;
+    dst.cb = kHalf;
+    dst.cr = kHalf;
+  }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Ycc<T>, Gray<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Ycc<T>, Gray<T>, kBitDepth, kRec>,
+                                Ycc<T>, Gray<T>> {
+  static constexpr bool kUsesRec = false;
+
+  static void Convert(const Ycc<T>& src, Gray<T>& dst) { dst.gray = src.y; }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Gray<T>, Rgb<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Gray<T>, Rgb<T>, kBitDepth, kRec>,
+                                Gray<T>, Rgb<T>> {
+  static constexpr bool kUsesRec = false;
+
+  static void Convert(const Gray<T>& src, Rgb<T>& dst) {
+    dst.r = src.gray;
+    dst.g = src.gray;
+    dst.b = src.gray;
+  }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Ya<T>, Rgba<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Ya<T>, Rgba<T>, kBitDepth, kRec>,
+                                Ya<T>, Rgba<T>> {
+  static constexpr bool kUsesRec = false;
+
+  static void Convert(const Ya<T>& src, Rgba<T>& dst) {
+    dst.r = src.gray;
+    dst.g = src.gray;
+    dst.b = src.gray;
+    dst.alpha = src.alpha;
+  }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Cmyk<T>, Rgb<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Cmyk<T>, Rgb<T>, kBitDepth, kRec>,
+                                Cmyk<T>, Rgb<T>> {
+  static constexpr bool kUsesRec = false;
+
+  static void Convert(const Cmyk<T>& src, Rgb<T>& dst) {
+    constexpr uint32_t kMax = (1u << kBitDepth) - 1;
+    const uint32_t white = kMax - internal::ClampSample(src.k, kMax);
+    dst.r = static_cast<T>(internal::ScaleProduct(
+        kMax - internal::ClampSample(src.c, kMax), white, kBitDepth));
+    dst.g = static_cast<T>(internal::ScaleProduct(
+        kMax - internal::ClampSample(src.m, kMax), white, kBitDepth));
+    dst.b = static_cast<T>(internal::ScaleProduct(
+        kMax - internal::ClampSample(src.y, kMax), white, kBitDepth));
+  }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Cmyka<T>, Rgba<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<
+          PixelKernel<Cmyka<T>, Rgba<T>, kBitDepth, kRec>, Cmyka<T>, Rgba<T>> {
+  static constexpr bool kUsesRec = false;
+
+  static void Convert(const Cmyka<T>& src, Rgba<T>& dst) {
+    Rgb<T> rgb;
+    PixelKernel<Cmyk<T>, Rgb<T>, kBitDepth, kRec>::Convert(
+        {src.c, src.m, src.y, src.k}, rgb);
+    dst.r = rgb.r;
+    dst.g = rgb.g;
+    dst.b = rgb.b;
+    dst.alpha = src.alpha;
+  }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Rgb<T>, Cmyk<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<PixelKernel<Rgb<T>, Cmyk<T>, kBitDepth, kRec>,
+                                Rgb<T>, Cmyk<T>> {
+  static constexpr bool kUsesRec = false;
+
+  static void Convert(const Rgb<T>& src, Cmyk<T>& dst) {
+    constexpr uint32_t kMax = (1u << kBitDepth) - 1;
+    constexpr float kMaxF = static_cast<float>(kMax);
+    const uint32_t r = internal::ClampSample(src.r, kMax);
+    const uint32_t g = internal::ClampSample(src.g, kMax);
+    const uint32_t b = internal::ClampSample(src.b, kMax);
+    const uint32_t top = std::max({r, g, b});
+    dst.c = static_cast<T>(internal::ScaleQuotient(top - r, top, kMaxF));
+    dst.m = static_cast<T>(internal::ScaleQuotient(top - g, top, kMaxF));
+    dst.y = static_cast<T>(internal::ScaleQuotient(top - b, top, kMaxF));
+    dst.k = static_cast<T>(kMax - top);
+  }
+};
+
+template <typename T, uint8_t kBitDepth, DigitalTvStudioEncodingRec kRec>
+  requires FitsBitDepth<T, kBitDepth>
+struct PixelKernel<Rgba<T>, Cmyka<T>, kBitDepth, kRec>
+    : internal::PixelKernelBase<
+          PixelKernel<Rgba<T>, Cmyka<T>, kBitDepth, kRec>, Rgba<T>, Cmyka<T>> {
+  static constexpr bool kUsesRec = false;
+
+  static void Convert(const Rgba<T>& src, Cmyka<T>& dst) {
+    Cmyk<T> cmyk;
+    PixelKernel<Rgb<T>, Cmyk<T>, kBitDepth, kRec>::Convert(
+        {src.r, src.g, src.b}, cmyk);
+    dst.c = cmyk.c;
+    dst.m = cmyk.m;
+    dst.y = cmyk.y;
+    dst.k = cmyk.k;
+    dst.alpha = src.alpha;
+  }
+};
+}  // namespace imaging
+}  // namespace ws
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+#include "ws/machine.h"
+
+namespace ws {
+namespace imaging {
+namespace internal {
+/** Kernel levels the running CPU can execute, kScalar first, for tests
+    that compare every SIMD kernel against the scalar loop. */
+inline std::vector<ws::internal::SimdLevel> SupportedSimdLevels() {
+  using ws::internal::SimdLevel;
+  std::vector<SimdLevel> levels = {SimdLevel::kScalar};
+  switch (ws::internal::CurrentSimdLevel()) {
+    case SimdLevel::kAvx2:
+      levels.push_back(SimdLevel::kSse2);
+      levels.push_back(SimdLevel::kAvx2);
+      break;
+    case SimdLevel::kSse2:
+      levels.push_back(SimdLevel::kSse2);
+      break;
+    case SimdLevel::kNeon:
+      levels.push_back(SimdLevel::kNeon);
+      break;
+    default:
+      break;
+  }
+  return levels;
+}
+}  // namespace internal
+}  // namespace imaging
+}  // namespace ws
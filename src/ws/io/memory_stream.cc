@@ -13,7 +13,20 @@ MemoryStream::MemoryStream(size_type capacity)
       expandable_(true),
       writable_(true),
       exposable_(true),
-      is_open_(true) {}
+      is_open_(true),
+      pool_(nullptr) {}
+
+MemoryStream::MemoryStream(size_type capacity,
+                           ws::pooling::ArrayPool<value_type>& pool)
+    : buffer_(pool.RentArray(static_cast<size_t>(capacity))),
+      position_(0),
+      length_(capacity),
+      capacity_(length_),
+      expandable_(true),
+      writable_(true),
+      exposable_(true),
+      is_open_(true),
+      pool_(&pool) {}
 
 MemoryStream::MemoryStream(container_type&& buffer)
     : MemoryStream(std::move(buffer), true) {}
@@ -29,7 +42,8 @@ MemoryStream::MemoryStream(container_type&& buffer, bool writable, bool visible)
       expandable_(false),
       writable_(writable),
       exposable_(visible),
-      is_open_(true) {}
+      is_open_(true),
+      pool_(nullptr) {}
 
 MemoryStream::MemoryStream(MemoryStream&& other) noexcept
     : buffer_(std::move(other.buffer_)),
@@ -39,7 +53,8 @@ MemoryStream::MemoryStream(MemoryStream&& other) noexcept
       expandable_(other.expandable_),
       writable_(other.writable_),
       exposable_(other.exposable_),
-      is_open_(other.is_open_) {
+      is_open_(other.is_open_),
+      pool_(other.pool_) {
   other.writable_ = false;
   other.is_open_ = false;
   other.exposable_ = false;
@@ -122,7 +137,7 @@ Status MemoryStream::SetCapacity(size_type value) {
     STREAM_THROW_NOT_EXPANDABLE();
   else if (expandable_ && value != capacity_) {
     if (value > 0) {
-      container_type new_buffer(value);
+      container_type new_buffer = AllocateBuffer(value);
       if (length_ > 0) std::memcpy(new_buffer.data(), buffer_.data(), length_);
       buffer_ = std::move(new_buffer);
     } else {
@@ -323,6 +338,12 @@ MemoryStream::size_type MemoryStream::Skip(size_type count) {
   return n;
 }
 
+MemoryStream::container_type MemoryStream::AllocateBuffer(
+    size_type capacity) {
+  if (pool_) return pool_->RentArray(static_cast<size_t>(capacity));
+  return container_type(capacity);
+}
+
 MemoryStream& MemoryStream::operator=(MemoryStream&& other) noexcept {
   if (this != &other) {
     buffer_ = std::move(other.buffer_);
@@ -333,6 +354,7 @@ MemoryStream& MemoryStream::operator=(MemoryStream&& other) noexcept {
     writable_ = other.writable_;
     expandable_ = other.expandable_;
     exposable_ = other.exposable_;
+    pool_ = other.pool_;
 
     other.writable_ = false;
     other.is_open_ = false;
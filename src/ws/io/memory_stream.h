@@ -5,6 +5,7 @@
 #include <cstring>
 
 #include "ws/io/stream.h"
+#include "ws/pooling/array_pool.h"
 #include "ws/status/status_or.h"
 
 namespace ws {
@@ -14,6 +15,9 @@ class MemoryStream : public Stream {
   MemoryStream();
   MemoryStream(size_type capacity);
   MemoryStream(size_type capacity, bool visible);
+  /** Expandable stream whose buffers are rented from pool, which must
+      outlive the stream. */
+  MemoryStream(size_type capacity, ws::pooling::ArrayPool<value_type>& pool);
   MemoryStream(container_type&& buffer);
   MemoryStream(container_type&& buffer, bool writable);
   MemoryStream(container_type&& buffer, bool writable, bool visible);
@@ -57,6 +61,7 @@ class MemoryStream : public Stream {
   Status EnsureWriteable() const;
   StatusOr<bool> EnsureCapacity(size_type value);
   size_type Skip(size_type count);
+  container_type AllocateBuffer(size_type capacity);
 
   static constexpr const size_type k256 = 256;
 
@@ -68,6 +73,7 @@ class MemoryStream : public Stream {
   bool writable_;
   bool exposable_;
   bool is_open_;
+  ws::pooling::ArrayPool<value_type>* pool_;
 };
 }  // namespace io
 }  // namespace ws
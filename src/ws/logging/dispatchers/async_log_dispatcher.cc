@@ -19,6 +19,7 @@ AsyncLogDispatcher::~AsyncLogDispatcher() {
 void AsyncLogDispatcher::Dispatch(const ILogSink& sink,
                                   const std::string& message) {
   log_queue_.Push({&sink, message});
+  if (statistics_) statistics_->dispatched.Increment();
   cv_.notify_one();
 }
 
@@ -34,12 +35,23 @@ void AsyncLogDispatcher::ProcessQueue() {
     }
 
     DispatchEvent event;
+    std::uint64_t batch_size = 0;
     while (log_queue_.TryPop(event)) {
       event.sink->Display(event.message);
+      ++batch_size;
+    }
+
+    if (batch_size != 0 && statistics_) {
+      statistics_->written.Add(static_cast<std::int64_t>(batch_size));
+      statistics_->batch_sizes.Record(batch_size);
     }
   }
 }
 
+void AsyncLogDispatcher::EnableStatistics() {
+  if (!statistics_) statistics_ = std::make_unique<Statistics>();
+}
+
 void AsyncLogDispatcher::Await() {
   std::unique_lock<std::mutex> lock(mutex_);
   cv_.wait(lock, [this] { return log_queue_.Empty(); });
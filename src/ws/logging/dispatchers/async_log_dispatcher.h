@@ -4,6 +4,8 @@
 #include <memory>
 
 #include "ws/concurrency/concurrent_queue.h"
+#include "ws/concurrency/sharded_counter.h"
+#include "ws/concurrency/sharded_histogram.h"
 #include "ws/logging/ilog_dispatcher.h"
 #include "ws/logging/ilog_sink.h"
 #include "ws/logging/log_level.h"
@@ -19,6 +21,20 @@ class AsyncLogDispatcher : public ILogDispatcher {
   void Dispatch(const ILogSink& sink, const std::string& message) override;
   void Await() override;
 
+  struct Statistics {
+    ws::concurrency::ShardedCounter dispatched;
+    ws::concurrency::ShardedCounter written;
+    ws::concurrency::ShardedHistogram batch_sizes;
+  };
+
+  /** Starts counting dispatched and written messages and the number of
+      messages drained per wake-up of the logging thread. Must be called
+      before the first Dispatch. */
+  void EnableStatistics();
+
+  /** Returns nullptr unless statistics are enabled. */
+  const Statistics* GetStatistics() const { return statistics_.get(); }
+
  private:
   struct DispatchEvent {
     const ILogSink* sink;
@@ -32,6 +48,7 @@ class AsyncLogDispatcher : public ILogDispatcher {
   std::thread log_thread_;
   std::mutex mutex_;
   std::condition_variable cv_;
+  std::unique_ptr<Statistics> statistics_;
 };
 
 }  // namespace logging
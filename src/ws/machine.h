@@ -14,6 +14,18 @@
 #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
     defined(_M_IX86)
 #include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+// Lets a function use instructions beyond the build's baseline; callers
+// must check CurrentSimdLevel() first.
+#if defined(__GNUC__) || defined(__clang__)
+#define WSCOMMON_TARGET_SSE2 __attribute__((target("sse2")))
+#define WSCOMMON_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define WSCOMMON_TARGET_SSE2
+#define WSCOMMON_TARGET_AVX2
+#endif
 #elif defined(__ARM_ARCH_7A__) || defined(__aarch64__) || defined(_M_ARM) || \
     defined(_M_ARM64)
 #endif
@@ -88,6 +100,46 @@ inline void CpuWait(int32_t delay) {
 #endif
 }
 
+/** Vector instruction sets that kernels are specialized for. */
+enum class SimdLevel { kScalar, kSse2, kAvx2, kNeon };
+
+/** Best instruction set the running CPU and OS support. Kernels compiled
+    for a wider set than the build's baseline must check this first. */
+inline SimdLevel DetectSimdLevel() {
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return SimdLevel::kAvx2;
+  if (__builtin_cpu_supports("sse2")) return SimdLevel::kSse2;
+  return SimdLevel::kScalar;
+#elif defined(_M_X64) || defined(_M_IX86)
+  int info[4];
+  __cpuid(info, 0);
+  const int max_leaf = info[0];
+  __cpuid(info, 1);
+  const bool sse2 = (info[3] & (1 << 26)) != 0;
+  const bool os_avx = (info[2] & (1 << 27)) != 0 &&
+                      (info[2] & (1 << 28)) != 0 &&
+                      (_xgetbv(0) & 0x6) == 0x6;
+  if (os_avx && max_leaf >= 7) {
+    __cpuidex(info, 7, 0);
+    if ((info[1] & (1 << 5)) != 0) return SimdLevel::kAvx2;
+  }
+  return sse2 ? SimdLevel::kSse2 : SimdLevel::kScalar;
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+  return SimdLevel::kNeon;
+#else
+  return SimdLevel::kScalar;
+#endif
+}
+
+/** DetectSimdLevel, run once on first use rather than in the dynamic
+    initializer of every translation unit that includes this header. */
+inline SimdLevel CurrentSimdLevel() {
+  static const SimdLevel level = DetectSimdLevel();
+  return level;
+}
+
 template <typename TIntegerType>
 constexpr bool IsPowerOfTwo(TIntegerType arg) {
   static_assert(std::is_integral<TIntegerType>::value,
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ws/array.h"
+#include "ws/concurrency/internal/helpers.h"
+#include "ws/concurrency/sharded_counter.h"
+#include "ws/concurrency/spin_mutex.h"
+#include "ws/machine.h"
+#include "ws/pooling/memory_pressure.h"
+
+namespace ws {
+namespace pooling {
+/** Pool of T[] buffers in power-of-two size buckets, for large buffers that
+    are allocated and released at a high rate (image planes, stream
+    buffers). Each thread keeps one buffer per bucket in front of the
+    shared buckets, so a thread that rents and returns the same size
+    mostly touches no shared state. Requests above MaxArrayLength() are
+    served with plain new[]/delete[].
+
+    Rented buffers are not cleared; Return can clear them on request.
+    Cached buffers are only given back to the system by Trim, which
+    callers are expected to run periodically. */
+template <typename T>
+class ArrayPool {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using pointer = T*;
+
+  static constexpr size_type kMinArrayLength = 16;
+  static constexpr size_type kDefaultMaxArrayLength = size_type(1) << 24;
+  static constexpr size_type kDefaultMaxArraysPerBucket = 16;
+
+  /** max_array_length is rounded up to a power of two. */
+  explicit ArrayPool(
+      size_type max_array_length = kDefaultMaxArrayLength,
+      size_type max_arrays_per_bucket = kDefaultMaxArraysPerBucket);
+
+  ArrayPool(const ArrayPool&) = delete;
+  ArrayPool& operator=(const ArrayPool&) = delete;
+
+  ~ArrayPool();
+
+  static ArrayPool& Shared();
+
+  /** Returns a buffer of at least minimum_length elements, or nullptr for
+      a length of zero. */
+  pointer Rent(size_type minimum_length);
+
+  /** Gives back a buffer from Rent; minimum_length must be the length it
+      was rented with. */
+  void Return(pointer array, size_type minimum_length, bool clear = false);
+
+  /** Rents a buffer and wraps it in an Array of exactly length elements
+      that returns the buffer to this pool when destroyed. */
+  Array<T> RentArray(size_type length);
+
+  /** Frees cached buffers according to CurrentMemoryPressure(). */
+  void Trim() { Trim(CurrentMemoryPressure()); }
+
+  /** Frees every cached buffer that has been idle since a Trim at least
+      60 s (low pressure) or 10 s (medium pressure) ago. Under high
+      pressure every cached buffer is freed. */
+  void Trim(MemoryPressure pressure);
+
+  size_type MaxArrayLength() const { return BucketLength(num_buckets_ - 1); }
+
+ private:
+  /** A cached buffer. stamp is zero until a Trim first sees the buffer
+      idle and records the time, which keeps clocks off the hot path. */
+  struct Entry {
+    pointer array = nullptr;
+    std::int64_t stamp = 0;
+  };
+
+  struct alignas(ws::internal::CacheLineSize()) ThreadSlot {
+    ws::concurrency::SpinMutex mutex;
+    std::unique_ptr<Entry[]> entries;
+  };
+
+  struct alignas(ws::internal::CacheLineSize()) Bucket {
+    ws::concurrency::SpinMutex mutex;
+    std::vector<Entry> entries;
+  };
+
+  static constexpr int kMinArrayLengthLog2 = std::countr_zero(kMinArrayLength);
+
+  static size_type BucketIndex(size_type length) {
+    return length <= kMinArrayLength
+               ? 0
+               : std::bit_width(length - 1) - kMinArrayLengthLog2;
+  }
+
+  static constexpr size_type BucketLength(size_type index) {
+    return kMinArrayLength << index;
+  }
+
+  /** Threads map to slots by ordinal, like ShardedCounter, so a slot's
+      lock is only contended when two threads share it. */
+  ThreadSlot& LocalSlot() {
+    return slots_[ws::concurrency::internal::ThisThreadOrdinal() &
+                  (num_slots_ - 1)];
+  }
+
+  static void ReleaseArray(void* owner, pointer array, size_type length) {
+    static_cast<ArrayPool*>(owner)->Return(array, length);
+  }
+
+  const size_type num_buckets_;
+  const size_type max_arrays_per_bucket_;
+  const size_type num_slots_;
+  std::unique_ptr<ThreadSlot[]> slots_;
+  std::unique_ptr<Bucket[]> buckets_;
+};
+
+// ============================================================================
+// Implementation details for ArrayPool<T>
+// ============================================================================
+
+template <typename T>
+inline ArrayPool<T>::ArrayPool(size_type max_array_length,
+                               size_type max_arrays_per_bucket)
+    : num_buckets_(BucketIndex(max_array_length) + 1),
+      max_arrays_per_bucket_(max_arrays_per_bucket),
+      num_slots_(
+          std::bit_ceil(ws::concurrency::ShardedCounter::DefaultShards())),
+      slots_(std::make_unique<ThreadSlot[]>(num_slots_)),
+      buckets_(std::make_unique<Bucket[]>(num_buckets_)) {
+  for (size_type i = 0; i < num_slots_; ++i) {
+    slots_[i].entries = std::make_unique<Entry[]>(num_buckets_);
+  }
+}
+
+template <typename T>
+inline ArrayPool<T>::~ArrayPool() {
+  Trim(MemoryPressure::kHigh);
+}
+
+template <typename T>
+inline ArrayPool<T>& ArrayPool<T>::Shared() {
+  static ArrayPool pool;
+  return pool;
+}
+
+template <typename T>
+inline typename ArrayPool<T>::pointer ArrayPool<T>::Rent(
+    size_type minimum_length) {
+  if (minimum_length == 0) return nullptr;
+  const size_type index = BucketIndex(minimum_length);
+  if (index >= num_buckets_) return new T[minimum_length];
+
+  {
+    ThreadSlot& slot = LocalSlot();
+    ws::concurrency::SpinMutex::ScopedLock lock(slot.mutex);
+    Entry& entry = slot.entries[index];
+    if (entry.array) {
+      pointer array = entry.array;
+      entry = Entry();
+      return array;
+    }
+  }
+
+  {
+    Bucket& bucket = buckets_[index];
+    ws::concurrency::SpinMutex::ScopedLock lock(bucket.mutex);
+    if (!bucket.entries.empty()) {
+      pointer array = bucket.entries.back().array;
+      bucket.entries.pop_back();
+      return array;
+    }
+  }
+
+  return new T[BucketLength(index)];
+}
+
+template <typename T>
+inline void ArrayPool<T>::Return(pointer array, size_type minimum_length,
+                                 bool clear) {
+  if (!array) return;
+  const size_type index = BucketIndex(minimum_length);
+  if (index >= num_buckets_) {
+    delete[] array;
+    return;
+  }
+
+  if (clear) std::fill_n(array, BucketLength(index), T());
+
+  // The returned buffer is the most likely to be warm in cache, so it takes
+  // the thread's slot and the previous occupant moves to the shared bucket.
+  pointer evicted = nullptr;
+  {
+    ThreadSlot& slot = LocalSlot();
+    ws::concurrency::SpinMutex::ScopedLock lock(slot.mutex);
+    Entry& entry = slot.entries[index];
+    evicted = entry.array;
+    entry = Entry{array, 0};
+  }
+  if (!evicted) return;
+
+  {
+    Bucket& bucket = buckets_[index];
+    ws::concurrency::SpinMutex::ScopedLock lock(bucket.mutex);
+    if (bucket.entries.size() < max_arrays_per_bucket_) {
+      bucket.entries.push_back(Entry{evicted, 0});
+      return;
+    }
+  }
+
+  delete[] evicted;
+}
+
+template <typename T>
+inline Array<T> ArrayPool<T>::RentArray(size_type length) {
+  if (length == 0) return Array<T>();
+  return Array<T>(Rent(length), length, &ArrayPool::ReleaseArray, this);
+}
+
+template <typename T>
+inline void ArrayPool<T>::Trim(MemoryPressure pressure) {
+  using namespace std::chrono;
+  const std::int64_t now =
+      duration_cast<milliseconds>(steady_clock::now().time_since_epoch())
+          .count();
+  const std::int64_t max_idle = pressure == MemoryPressure::kLow ? 60000
+                                : pressure == MemoryPressure::kMedium
+                                    ? 10000
+                                    : 0;
+  auto expired = [&](Entry& entry) {
+    if (pressure == MemoryPressure::kHigh) return true;
+    if (entry.stamp == 0) {
+      entry.stamp = now;
+      return false;
+    }
+    return now - entry.stamp >= max_idle;
+  };
+
+  std::vector<pointer> released;
+  for (size_type i = 0; i < num_slots_; ++i) {
+    ThreadSlot& slot = slots_[i];
+    ws::concurrency::SpinMutex::ScopedLock lock(slot.mutex);
+    for (size_type index = 0; index < num_buckets_; ++index) {
+      Entry& entry = slot.entries[index];
+      if (entry.array && expired(entry)) {
+        released.push_back(entry.array);
+        entry = Entry();
+      }
+    }
+  }
+
+  for (size_type index = 0; index < num_buckets_; ++index) {
+    Bucket& bucket = buckets_[index];
+    ws::concurrency::SpinMutex::ScopedLock lock(bucket.mutex);
+    auto kept = std::remove_if(
+        bucket.entries.begin(), bucket.entries.end(), [&](Entry& entry) {
+          if (!expired(entry)) return false;
+          released.push_back(entry.array);
+          return true;
+        });
+    bucket.entries.erase(kept, bucket.entries.end());
+  }
+
+  for (pointer array : released) {
+    delete[] array;
+  }
+}
+}  // namespace pooling
+}  // namespace ws
@@ -1,14 +1,84 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
 
 #include "ws/concurrency/blocking_queue.h"
+#include "ws/concurrency/internal/concurrent_monitor.h"
+#include "ws/concurrency/spin_mutex.h"
 #include "ws/delegate.h"
+#include "ws/pooling/idle_window.h"
 #include "ws/pooling/iobject_pool.h"
+#include "ws/pooling/pool_statistics.h"
+#include "ws/pooling/pooled_lease.h"
 #include "ws/status/status_or.h"
 
 namespace ws {
 namespace pooling {
+namespace internal {
+/** Token for acquisitions that cannot be cancelled. */
+struct NoCancellation {
+  bool IsCancellationRequested() const { return false; }
+};
+
+/** Holds the cancellation callback of a pending acquisition until it
+    completes. TCancellationToken is ws::threading::CancellationToken; it is
+    a template parameter so this module does not depend on the threading
+    module. */
+template <typename TCancellationToken>
+class CancellationHook {
+ public:
+  template <typename TCallback>
+  void Register(TCancellationToken& token, TCallback&& callback) {
+    registration_.emplace(
+        token.RegisterCallback(std::forward<TCallback>(callback)));
+  }
+
+  /** Waits for a callback that is already running on another thread. */
+  void Unregister() {
+    if (registration_ && registration_->Ok()) {
+      registration_->Value().Unregister();
+    }
+    registration_.reset();
+  }
+
+ private:
+  using registration_type = decltype(std::declval<TCancellationToken&>()
+                                         .RegisterCallback(
+                                             ws::Delegate<void()>()));
+
+  std::optional<registration_type> registration_;
+};
+
+template <>
+class CancellationHook<NoCancellation> {
+ public:
+  template <typename TCallback>
+  void Register(NoCancellation&, TCallback&&) {}
+
+  void Unregister() {}
+};
+}  // namespace internal
+
+/** Pool of at most capacity objects. Get creates objects until the capacity
+    is reached and then blocks until another thread returns one.
+
+    Lease hands out objects kept in heap slots, which circulate through
+    their own queue and count against the same capacity. When a pool is
+    exhausted, Get and Lease take an idle object of the other kind before
+    blocking, and a blocked Get or Lease is queued with the waiters below.
+
+    GetAsync and GetOrEnqueue wait without blocking a thread: the caller is
+    queued and the next object returned to the pool is handed to it
+    directly, in FIFO order, on the returning thread. */
 template <typename T>
 class BlockingObjectPool : public IObjectPool<T> {
  public:
@@ -18,18 +88,247 @@ class BlockingObjectPool : public IObjectPool<T> {
   explicit BlockingObjectPool(ws::Delegate<T()> object_generator,
                               std::size_t capacity);
 
+  BlockingObjectPool(BlockingObjectPool&& other);
+
+  ~BlockingObjectPool();
+
   T Get() override;
+  PooledLease<T> Lease() override;
   bool TryGet(T& item);
+
+  template <typename TCancellationToken>
+  class GetAwaiter;
+
+  /** Returns an awaitable that completes with an object, suspending the
+      coroutine while the pool is exhausted. The coroutine resumes on the
+      thread that returns the object. */
+  GetAwaiter<internal::NoCancellation> GetAsync();
+
+  /** Like GetAsync, but completes with kRequestAborted if token is
+      cancelled first. The coroutine then resumes on the cancelling
+      thread. */
+  template <typename TCancellationToken>
+  GetAwaiter<TCancellationToken> GetAsync(TCancellationToken token);
+
+  /** Calls on_acquired with an object: right away if one is available,
+      otherwise from the thread that returns the next one. */
+  void GetOrEnqueue(ws::Delegate<void(T)> on_acquired);
+
+  /** Like GetOrEnqueue, but on_acquired is dropped without being called if
+      token is cancelled before an object is available. */
+  template <typename TCancellationToken>
+  void GetOrEnqueue(ws::Delegate<void(T)> on_acquired,
+                    TCancellationToken token);
   void Return(const T& item) override;
   void Return(T&& item) override;
   void Clear() override;
   void Dispose();
 
+  /** Creates up to count objects up front, within the capacity, so the
+      first Gets after start-up do not pay for construction. */
+  void Prewarm(std::size_t count);
+
+  /** Like Prewarm, for the slots handed out by Lease. */
+  void PrewarmLeases(std::size_t count);
+
+  /** Destroys the objects that stayed idle for at least max_idle, which
+      frees their share of the capacity, and returns how many were
+      destroyed. Meant to be called periodically; calls made before
+      max_idle has passed since the last effective Trim do nothing. */
+  std::size_t Trim(std::chrono::steady_clock::duration max_idle);
+
+  using Statistics = PoolStatistics;
+
+  /** Starts counting hits, misses, creations, returns and outstanding
+      objects. Must be called before the pool is shared between threads. */
+  void EnableStatistics();
+
+  /** Returns nullptr unless statistics are enabled. */
+  const Statistics* GetStatistics() const { return statistics_.get(); }
+
+  /** Takes a snapshot of the counters and of the number of idle objects. */
+  PoolStats Stats() const;
+
  private:
+  /** A pending GetAsync or GetOrEnqueue, linked into waiters_ while it
+      waits. deliver is called once the waiter is unlinked. */
+  struct Waiter {
+    Waiter* prev = nullptr;
+    Waiter* next = nullptr;
+    bool queued = false;
+    void (*deliver)(Waiter* self, T&& item) = nullptr;
+  };
+
+  template <typename TCancellationToken>
+  struct CallbackWaiter;
+
+  struct BlockingWaiter;
+
+  /** Claims one unit of capacity for a new object. */
+  bool TryReserve();
+
+  /** Takes an idle object or creates one within the capacity. */
+  std::optional<T> TryAcquire();
+
+  /** Links waiter unless an object or spare capacity turns up, or token is
+      cancelled, first. Returns false if the waiter was not linked; item
+      then holds the object, or is empty if cancelled. */
+  template <typename TCancellationToken>
+  bool Enqueue(Waiter* waiter, std::optional<T>& item,
+               const TCancellationToken& token);
+
+  /** Queues the calling thread as a waiter and parks it on monitor_
+      until an object or slot is handed to it. */
+  T WaitForItem();
+
+  /** Unlinks waiter if it is still queued. */
+  bool RemoveWaiter(Waiter* waiter);
+
+  Waiter* PopWaiter();
+
+  /** Hands idle objects and spare capacity to queued waiters. Called after
+      an object was made available while waiters may be queued. */
+  void ServeWaiters();
+
+  template <typename TItem>
+  void InternalReturn(TItem&& item);
+
+  static void ReleaseSlot(void* owner, T* slot);
+
+  /** Destroys an object taken out of a queue and frees its capacity. */
+  void Retire(T& item);
+  void Retire(T* slot);
+
+  template <typename TItem>
+  std::size_t TrimQueue(ws::concurrency::BlockingQueue<TItem>& queue,
+                        IdleWindow& idle_window,
+                        std::chrono::steady_clock::duration max_idle);
+
+  template <typename TItem>
+  static std::size_t IdleCount(
+      const ws::concurrency::BlockingQueue<TItem>& queue);
+
   const std::size_t capacity_;
   ws::concurrency::BlockingQueue<T> queue_;
+  ws::concurrency::BlockingQueue<T*> slots_;
   ws::Delegate<T()> object_generator_;
   std::atomic<std::size_t> current_count_;
+  std::unique_ptr<Statistics> statistics_;
+  IdleWindow idle_window_;
+  IdleWindow slot_idle_window_;
+  ws::concurrency::SpinMutex waiters_mutex_;
+  Waiter* waiters_head_ = nullptr;
+  Waiter* waiters_tail_ = nullptr;
+  std::atomic<std::size_t> num_waiters_{0};
+  ws::concurrency::internal::ConcurrentMonitor monitor_;
+};
+
+// ============================================================================
+// Implementation details for BlockingObjectPool<T>::GetAwaiter
+// ============================================================================
+
+template <typename T>
+template <typename TCancellationToken>
+class BlockingObjectPool<T>::GetAwaiter : private Waiter {
+ public:
+  using result_type =
+      std::conditional_t<std::is_same_v<TCancellationToken,
+                                        internal::NoCancellation>,
+                         T, StatusOr<T>>;
+
+  GetAwaiter(BlockingObjectPool* pool, TCancellationToken token)
+      : pool_(pool), token_(std::move(token)) {
+    this->deliver = &GetAwaiter::Deliver;
+  }
+
+  GetAwaiter(const GetAwaiter&) = delete;
+  GetAwaiter& operator=(const GetAwaiter&) = delete;
+
+  bool await_ready() {
+    if (token_.IsCancellationRequested()) return true;
+    item_ = pool_->TryAcquire();
+    return item_.has_value();
+  }
+
+  bool await_suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+    // Registered before the waiter is linked, so a cancellation can only
+    // resume the coroutine once it is actually suspended.
+    hook_.Register(token_, [this] {
+      if (pool_->RemoveWaiter(this)) handle_.resume();
+    });
+    if (pool_->Enqueue(this, item_, token_)) return true;
+    hook_.Unregister();
+    return false;
+  }
+
+  result_type await_resume() {
+    hook_.Unregister();
+    if constexpr (!std::is_same_v<TCancellationToken,
+                                  internal::NoCancellation>) {
+      if (!item_) {
+        return Status(StatusCode::kRequestAborted,
+                      "Pool acquisition was cancelled");
+      }
+    }
+    return std::move(*item_);
+  }
+
+ private:
+  static void Deliver(Waiter* self, T&& item) {
+    GetAwaiter* awaiter = static_cast<GetAwaiter*>(self);
+    awaiter->item_.emplace(std::move(item));
+    awaiter->handle_.resume();
+  }
+
+  BlockingObjectPool* pool_;
+  TCancellationToken token_;
+  internal::CancellationHook<TCancellationToken> hook_;
+  std::coroutine_handle<> handle_;
+  std::optional<T> item_;
+};
+
+template <typename T>
+template <typename TCancellationToken>
+struct BlockingObjectPool<T>::CallbackWaiter : Waiter {
+  explicit CallbackWaiter(ws::Delegate<void(T)> on_acquired)
+      : on_acquired(std::move(on_acquired)) {
+    this->deliver = &CallbackWaiter::Deliver;
+  }
+
+  static void Deliver(Waiter* self, T&& item) {
+    std::unique_ptr<CallbackWaiter> waiter(static_cast<CallbackWaiter*>(self));
+    waiter->hook.Unregister();
+    waiter->on_acquired(std::move(item));
+  }
+
+  ws::Delegate<void(T)> on_acquired;
+  internal::CancellationHook<TCancellationToken> hook;
+};
+
+/** A thread blocked in Get or Lease. It is served like any other waiter,
+    so every path that makes an object or capacity available wakes it. */
+template <typename T>
+struct BlockingObjectPool<T>::BlockingWaiter : Waiter {
+  explicit BlockingWaiter(BlockingObjectPool* pool) : pool(pool) {
+    this->deliver = &BlockingWaiter::Deliver;
+  }
+
+  static void Deliver(Waiter* self, T&& item) {
+    BlockingWaiter* waiter = static_cast<BlockingWaiter*>(self);
+    // The waiter may return as soon as ready is set, so nothing in it is
+    // touched afterwards; its sleep node is matched by address.
+    BlockingObjectPool* owner = waiter->pool;
+    const std::uintptr_t context = reinterpret_cast<std::uintptr_t>(waiter);
+    waiter->item.emplace(std::move(item));
+    waiter->ready.store(true, std::memory_order_release);
+    owner->monitor_.Notify(
+        [context](std::uintptr_t other) { return other == context; });
+  }
+
+  BlockingObjectPool* pool;
+  std::optional<T> item;
+  std::atomic<bool> ready{false};
 };
 
 // ============================================================================
@@ -39,7 +338,7 @@ class BlockingObjectPool : public IObjectPool<T> {
 template <typename T>
 inline StatusOr<BlockingObjectPool<T>> BlockingObjectPool<T>::Create(
     ws::Delegate<T()> object_generator, std::size_t capacity) {
-  if (!object_generator_) {
+  if (!object_generator) {
     return Status(StatusCode::kBadRequest, "object_generator is null");
   }
 
@@ -54,61 +353,448 @@ inline StatusOr<BlockingObjectPool<T>> BlockingObjectPool<T>::Create(
 template <typename T>
 inline BlockingObjectPool<T>::BlockingObjectPool(
     ws::Delegate<T()> object_generator, std::size_t capacity)
-    : object_generator_(object_generator),
-      capacity_(capacity),
+    : capacity_(capacity),
+      object_generator_(object_generator),
       current_count_(0) {
   queue_.SetCapacity(capacity_);
+  slots_.SetCapacity(capacity_);
+}
+
+template <typename T>
+inline BlockingObjectPool<T>::BlockingObjectPool(BlockingObjectPool&& other)
+    : capacity_(other.capacity_),
+      queue_(std::move(other.queue_)),
+      slots_(std::move(other.slots_)),
+      object_generator_(std::move(other.object_generator_)),
+      current_count_(other.current_count_.load(std::memory_order_relaxed)),
+      statistics_(std::move(other.statistics_)),
+      idle_window_(std::move(other.idle_window_)),
+      slot_idle_window_(std::move(other.slot_idle_window_)) {
+  assert(other.num_waiters_.load() == 0 && "Moved a pool with waiters");
+}
+
+template <typename T>
+inline BlockingObjectPool<T>::~BlockingObjectPool() {
+  Clear();
 }
 
 template <typename T>
 inline T BlockingObjectPool<T>::Get() {
   T item;
   if (queue_.TryPop(item)) {
+    idle_window_.Observe(IdleCount(queue_));
+    if (statistics_) statistics_->RecordHit();
     return item;
   }
 
-  if (current_count_.load(std::memory_order_relaxed) < capacity_) {
-    current_count_.fetch_add(1, std::memory_order_relaxed);
+  if (TryReserve()) {
+    if (statistics_) {
+      statistics_->RecordMiss();
+      statistics_->creations.Increment();
+    }
     return object_generator_();
+  }
+
+  T* slot = nullptr;
+  if (!slots_.TryPop(slot)) return WaitForItem();
+  slot_idle_window_.Observe(IdleCount(slots_));
+  item = std::move(*slot);
+  delete slot;
+  if (statistics_) statistics_->RecordHit();
+  return item;
+}
+
+template <typename T>
+inline PooledLease<T> BlockingObjectPool<T>::Lease() {
+  T* slot = nullptr;
+  if (slots_.TryPop(slot)) {
+    slot_idle_window_.Observe(IdleCount(slots_));
+    if (statistics_) statistics_->RecordHit();
+  } else if (TryReserve()) {
+    if (statistics_) {
+      statistics_->RecordMiss();
+      statistics_->creations.Increment();
+    }
+    slot = new T(object_generator_());
   } else {
-    queue_.Pop(item);
-    return item;
+    T item;
+    if (queue_.TryPop(item)) {
+      idle_window_.Observe(IdleCount(queue_));
+      if (statistics_) statistics_->RecordHit();
+    } else {
+      item = WaitForItem();
+    }
+    slot = new T(std::move(item));
   }
+  return PooledLease<T>(slot, &BlockingObjectPool::ReleaseSlot, this);
 }
 
 template <typename T>
 inline bool BlockingObjectPool<T>::TryGet(T& item) {
-  return queue_.TryPop(item);
+  if (!queue_.TryPop(item)) return false;
+  idle_window_.Observe(IdleCount(queue_));
+  if (statistics_) statistics_->RecordHit();
+  return true;
+}
+
+template <typename T>
+inline typename BlockingObjectPool<T>::template GetAwaiter<
+    internal::NoCancellation>
+BlockingObjectPool<T>::GetAsync() {
+  return GetAwaiter<internal::NoCancellation>(this,
+                                              internal::NoCancellation());
+}
+
+template <typename T>
+template <typename TCancellationToken>
+inline typename BlockingObjectPool<T>::template GetAwaiter<TCancellationToken>
+BlockingObjectPool<T>::GetAsync(TCancellationToken token) {
+  return GetAwaiter<TCancellationToken>(this, std::move(token));
+}
+
+template <typename T>
+inline void BlockingObjectPool<T>::GetOrEnqueue(
+    ws::Delegate<void(T)> on_acquired) {
+  GetOrEnqueue(std::move(on_acquired), internal::NoCancellation());
+}
+
+template <typename T>
+template <typename TCancellationToken>
+inline void BlockingObjectPool<T>::GetOrEnqueue(
+    ws::Delegate<void(T)> on_acquired, TCancellationToken token) {
+  if (token.IsCancellationRequested()) return;
+  std::optional<T> item = TryAcquire();
+  if (item) {
+    on_acquired(std::move(*item));
+    return;
+  }
+
+  using waiter_type = CallbackWaiter<TCancellationToken>;
+  auto waiter = std::make_unique<waiter_type>(std::move(on_acquired));
+  waiter_type* raw = waiter.get();
+  raw->hook.Register(token, [this, raw] {
+    if (RemoveWaiter(raw)) delete raw;
+  });
+  if (Enqueue(raw, item, token)) {
+    waiter.release();
+    return;
+  }
+
+  waiter->hook.Unregister();
+  if (item) waiter->on_acquired(std::move(*item));
 }
 
 template <typename T>
 inline void BlockingObjectPool<T>::Return(const T& item) {
-  queue_.Push(item);
+  InternalReturn(item);
 }
 
 template <typename T>
 inline void BlockingObjectPool<T>::Return(T&& item) {
-  queue_.Push(std::move(item));
+  InternalReturn(std::move(item));
+}
+
+template <typename T>
+template <typename TItem>
+inline void BlockingObjectPool<T>::InternalReturn(TItem&& item) {
+  if (statistics_) statistics_->RecordReturn();
+  if (num_waiters_.load(std::memory_order_relaxed) != 0) {
+    if (Waiter* waiter = PopWaiter()) {
+      if (statistics_) statistics_->RecordHit();
+      if constexpr (std::is_same_v<TItem, T>) {
+        waiter->deliver(waiter, std::move(item));
+      } else {
+        T copy(item);
+        waiter->deliver(waiter, std::move(copy));
+      }
+      return;
+    }
+  }
+
+  queue_.Push(std::forward<TItem>(item));
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (num_waiters_.load(std::memory_order_relaxed) != 0) ServeWaiters();
+}
+
+template <typename T>
+inline void BlockingObjectPool<T>::ReleaseSlot(void* owner, T* slot) {
+  BlockingObjectPool* pool = static_cast<BlockingObjectPool*>(owner);
+  if (pool->statistics_) pool->statistics_->RecordReturn();
+  pool->slots_.Push(slot);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (pool->num_waiters_.load(std::memory_order_relaxed) != 0) {
+    pool->ServeWaiters();
+  }
 }
 
 template <typename T>
 inline void BlockingObjectPool<T>::Clear() {
-  if constexpr (!std::is_member_function_pointer<
-                    decltype(&T::Dispose)>::value) {
-    objects_.Clear();
-    return;
+  T item;
+  while (queue_.TryPop(item)) {
+    Retire(item);
   }
+  idle_window_.Restart(0);
 
-  while (objects_.TryPop(item)) {
-    item.Dispose();
+  T* slot = nullptr;
+  while (slots_.TryPop(slot)) {
+    Retire(slot);
   }
+  slot_idle_window_.Restart(0);
+  // The freed capacity goes to the waiters, blocked Gets included. Pairs
+  // with the fence in Enqueue, which retries TryReserve after linking.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (num_waiters_.load(std::memory_order_relaxed) != 0) ServeWaiters();
 }
 
 template <typename T>
 inline void BlockingObjectPool<T>::Dispose() {
   Clear();
   queue_.SetCapacity(0);
+  slots_.SetCapacity(0);
+}
+
+template <typename T>
+inline void BlockingObjectPool<T>::Prewarm(std::size_t count) {
+  for (std::size_t i = 0; i < count && TryReserve(); ++i) {
+    queue_.Push(object_generator_());
+    if (statistics_) statistics_->creations.Increment();
+  }
+}
+
+template <typename T>
+inline void BlockingObjectPool<T>::PrewarmLeases(std::size_t count) {
+  for (std::size_t i = 0; i < count && TryReserve(); ++i) {
+    slots_.Push(new T(object_generator_()));
+    if (statistics_) statistics_->creations.Increment();
+  }
+}
+
+template <typename T>
+inline std::size_t BlockingObjectPool<T>::Trim(
+    std::chrono::steady_clock::duration max_idle) {
+  const std::size_t released = TrimQueue(queue_, idle_window_, max_idle) +
+                               TrimQueue(slots_, slot_idle_window_, max_idle);
+  // As in Clear, a Get that blocked while the items were being retired
+  // either sees the capacity in Enqueue or is served here.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (released != 0 && num_waiters_.load(std::memory_order_relaxed) != 0) {
+    ServeWaiters();
+  }
+  return released;
+}
+
+template <typename T>
+template <typename TItem>
+inline std::size_t BlockingObjectPool<T>::TrimQueue(
+    ws::concurrency::BlockingQueue<TItem>& queue, IdleWindow& idle_window,
+    std::chrono::steady_clock::duration max_idle) {
+  const std::optional<std::size_t> idle = idle_window.Close(max_idle);
+  if (!idle) return 0;
+
+  std::size_t released = 0;
+  TItem item{};
+  while (released < *idle && queue.TryPop(item)) {
+    Retire(item);
+    ++released;
+  }
+  idle_window.Restart(IdleCount(queue));
+  return released;
+}
+
+template <typename T>
+inline void BlockingObjectPool<T>::EnableStatistics() {
+  if (!statistics_) statistics_ = std::make_unique<Statistics>();
+}
+
+template <typename T>
+inline PoolStats BlockingObjectPool<T>::Stats() const {
+  const std::size_t idle = IdleCount(queue_) + IdleCount(slots_);
+  if (statistics_) return statistics_->Snapshot(idle);
+  PoolStats stats;
+  stats.idle = idle;
+  return stats;
+}
+
+template <typename T>
+inline bool BlockingObjectPool<T>::TryReserve() {
+  std::size_t count = current_count_.load(std::memory_order_relaxed);
+  while (count < capacity_) {
+    if (current_count_.compare_exchange_weak(count, count + 1,
+                                             std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+inline std::optional<T> BlockingObjectPool<T>::TryAcquire() {
+  std::optional<T> item(std::in_place);
+  if (queue_.TryPop(*item)) {
+    idle_window_.Observe(IdleCount(queue_));
+    if (statistics_) statistics_->RecordHit();
+    return item;
+  }
+
+  if (TryReserve()) {
+    if (statistics_) {
+      statistics_->RecordMiss();
+      statistics_->creations.Increment();
+    }
+    item.emplace(object_generator_());
+    return item;
+  }
+  return std::nullopt;
+}
+
+template <typename T>
+template <typename TCancellationToken>
+inline bool BlockingObjectPool<T>::Enqueue(Waiter* waiter,
+                                           std::optional<T>& item,
+                                           const TCancellationToken& token) {
+  T* slot = nullptr;
+  {
+    ws::concurrency::SpinMutex::ScopedLock lock(waiters_mutex_);
+    // Checked under the lock so a cancellation either sees the waiter
+    // linked or makes this call give up.
+    if (token.IsCancellationRequested()) {
+      item.reset();
+      return false;
+    }
+
+    waiter->prev = waiters_tail_;
+    waiter->next = nullptr;
+    waiter->queued = true;
+    (waiters_tail_ ? waiters_tail_->next : waiters_head_) = waiter;
+    waiters_tail_ = waiter;
+    num_waiters_.fetch_add(1, std::memory_order_relaxed);
+    // Pairs with the fences after an object is made available: either
+    // this thread sees the object or the other one sees the waiter.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // An object or slot returned, or capacity freed, just before the
+    // waiter was linked is picked up here instead of waiting for the next
+    // one. The waiter may be served as soon as the lock is released, so it
+    // is only touched under the lock.
+    item.emplace();
+    if (queue_.TryPop(*item)) {
+      idle_window_.Observe(IdleCount(queue_));
+      if (statistics_) statistics_->RecordHit();
+    } else if (slots_.TryPop(slot)) {
+      slot_idle_window_.Observe(IdleCount(slots_));
+      if (statistics_) statistics_->RecordHit();
+      *item = std::move(*slot);
+    } else if (TryReserve()) {
+      item.reset();
+    } else {
+      item.reset();
+      return true;
+    }
+
+    waiters_tail_ = waiter->prev;
+    (waiters_tail_ ? waiters_tail_->next : waiters_head_) = nullptr;
+    waiter->queued = false;
+    num_waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  delete slot;
+  if (!item) {
+    if (statistics_) {
+      statistics_->RecordMiss();
+      statistics_->creations.Increment();
+    }
+    item.emplace(object_generator_());
+  }
+  return false;
+}
+
+template <typename T>
+inline T BlockingObjectPool<T>::WaitForItem() {
+  BlockingWaiter waiter(this);
+  std::optional<T> item;
+  if (!Enqueue(&waiter, item, internal::NoCancellation())) {
+    return std::move(*item);
+  }
+
+  ws::concurrency::internal::ConcurrentMonitor::thread_context context(
+      reinterpret_cast<std::uintptr_t>(&waiter));
+  monitor_.Wait(
+      [&] { return waiter.ready.load(std::memory_order_acquire); }, context);
+  return std::move(*waiter.item);
+}
+
+template <typename T>
+inline bool BlockingObjectPool<T>::RemoveWaiter(Waiter* waiter) {
+  ws::concurrency::SpinMutex::ScopedLock lock(waiters_mutex_);
+  if (!waiter->queued) return false;
+  (waiter->prev ? waiter->prev->next : waiters_head_) = waiter->next;
+  (waiter->next ? waiter->next->prev : waiters_tail_) = waiter->prev;
+  waiter->queued = false;
+  num_waiters_.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+template <typename T>
+inline typename BlockingObjectPool<T>::Waiter*
+BlockingObjectPool<T>::PopWaiter() {
+  ws::concurrency::SpinMutex::ScopedLock lock(waiters_mutex_);
+  Waiter* waiter = waiters_head_;
+  if (!waiter) return nullptr;
+  waiters_head_ = waiter->next;
+  (waiters_head_ ? waiters_head_->prev : waiters_tail_) = nullptr;
+  waiter->queued = false;
+  num_waiters_.fetch_sub(1, std::memory_order_relaxed);
+  return waiter;
+}
+
+template <typename T>
+inline void BlockingObjectPool<T>::ServeWaiters() {
+  while (num_waiters_.load(std::memory_order_relaxed) != 0) {
+    std::optional<T> item = TryAcquire();
+    if (!item) {
+      T* slot = nullptr;
+      if (!slots_.TryPop(slot)) return;
+      slot_idle_window_.Observe(IdleCount(slots_));
+      if (statistics_) statistics_->RecordHit();
+      item.emplace(std::move(*slot));
+      delete slot;
+    }
+
+    Waiter* waiter = PopWaiter();
+    if (!waiter) {
+      // The waiters were served or cancelled meanwhile; park the object
+      // and look again in case a new waiter missed it.
+      if (statistics_) statistics_->RecordReturn();
+      queue_.Push(std::move(*item));
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      continue;
+    }
+    waiter->deliver(waiter, std::move(*item));
+  }
+}
+
+template <typename T>
+inline void BlockingObjectPool<T>::Retire(T& item) {
+  if constexpr (requires { item.Dispose(); }) {
+    item.Dispose();
+  }
+  assert(current_count_.load(std::memory_order_relaxed) > 0 &&
+         "Retired an object the pool did not create");
+  current_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename T>
+inline void BlockingObjectPool<T>::Retire(T* slot) {
+  Retire(*slot);
+  delete slot;
 }
 
+template <typename T>
+template <typename TItem>
+inline std::size_t BlockingObjectPool<T>::IdleCount(
+    const ws::concurrency::BlockingQueue<TItem>& queue) {
+  const std::ptrdiff_t size = queue.Size();
+  return size < 0 ? 0 : static_cast<std::size_t>(size);
+}
 }  // namespace pooling
 }  // namespace ws
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace ws {
+namespace pooling {
+/** Decides how many idle objects a pool may free on Trim. It tracks the
+    low-water mark of the pool's idle count over a window: that many
+    objects sat unused for the whole window, so once the window is at
+    least max_idle long they are known to have been idle that long. No
+    per-object timestamps are kept, so Get and Return never read the
+    clock. */
+class IdleWindow {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  IdleWindow() : start_(Now()) {}
+
+  IdleWindow(IdleWindow&& other) noexcept
+      : low_water_(other.low_water_.load(std::memory_order_relaxed)),
+        start_(other.start_.load(std::memory_order_relaxed)) {}
+
+  /** Records the idle count after objects were taken from the pool. */
+  void Observe(std::size_t idle) {
+    std::size_t low = low_water_.load(std::memory_order_relaxed);
+    while (idle < low && !low_water_.compare_exchange_weak(
+                             low, idle, std::memory_order_relaxed)) {
+    }
+  }
+
+  /** Closes the current window if it is at least max_idle long and returns
+      how many objects stayed idle through it. Returns nullopt while the
+      window is shorter, or when another thread closed it first. Call
+      Restart once the objects are freed. */
+  std::optional<std::size_t> Close(clock::duration max_idle) {
+    const clock::rep now = Now();
+    clock::rep start = start_.load(std::memory_order_relaxed);
+    if (now - start < max_idle.count() ||
+        !start_.compare_exchange_strong(start, now,
+                                        std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+    return low_water_.load(std::memory_order_relaxed);
+  }
+
+  /** Starts the next window's low-water mark at the current idle count. */
+  void Restart(std::size_t idle) {
+    low_water_.store(idle, std::memory_order_relaxed);
+  }
+
+ private:
+  static clock::rep Now() { return clock::now().time_since_epoch().count(); }
+
+  std::atomic<std::size_t> low_water_{0};
+  std::atomic<clock::rep> start_;
+};
+}  // namespace pooling
+}  // namespace ws
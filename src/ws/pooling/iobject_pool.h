@@ -1,11 +1,18 @@
 #pragma once
 
+#include "ws/pooling/pooled_lease.h"
+
 namespace ws {
 namespace pooling {
 template <typename T>
-class IObjectPool : {
+class IObjectPool {
  public:
+  virtual ~IObjectPool() = default;
+
   virtual T Get() = 0;
+  /** Like Get, but the object stays in pool-owned storage and goes back to
+      the pool when the lease is destroyed. */
+  virtual PooledLease<T> Lease() = 0;
   virtual void Return(const T& item) = 0;
   virtual void Return(T&& item) = 0;
   virtual void Clear() = 0;
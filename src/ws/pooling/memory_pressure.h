@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace ws {
+namespace pooling {
+/** How urgently pools should give cached memory back to the system. */
+enum class MemoryPressure {
+  kLow,
+  kMedium,
+  kHigh,
+};
+
+/** Estimates the pressure from the share of physical memory still
+    available: below 10% is high, below 30% medium. Reports kLow when the
+    system does not expose the numbers. */
+inline MemoryPressure CurrentMemoryPressure() {
+#if defined(__linux__)
+  std::ifstream meminfo("/proc/meminfo");
+  std::string line;
+  std::uint64_t total = 0;
+  std::uint64_t available = 0;
+  while ((total == 0 || available == 0) && std::getline(meminfo, line)) {
+    std::istringstream fields(line);
+    std::string name;
+    std::uint64_t kilobytes = 0;
+    if (!(fields >> name >> kilobytes)) continue;
+    if (name == "MemTotal:") {
+      total = kilobytes;
+    } else if (name == "MemAvailable:") {
+      available = kilobytes;
+    }
+  }
+
+  if (total != 0 && available != 0) {
+    if (available * 10 < total) return MemoryPressure::kHigh;
+    if (available * 10 < total * 3) return MemoryPressure::kMedium;
+  }
+#endif
+  return MemoryPressure::kLow;
+}
+}  // namespace pooling
+}  // namespace ws
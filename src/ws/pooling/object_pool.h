@@ -1,33 +1,157 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "ws/concurrency/concurrent_queue.h"
+#include "ws/concurrency/internal/helpers.h"
+#include "ws/concurrency/sharded_counter.h"
+#include "ws/concurrency/spin_mutex.h"
 #include "ws/delegate.h"
+#include "ws/machine.h"
+#include "ws/pooling/idle_window.h"
 #include "ws/pooling/iobject_pool.h"
+#include "ws/pooling/pool_statistics.h"
+#include "ws/pooling/pooled_lease.h"
 #include "ws/status/status_or.h"
 
 namespace ws {
 namespace pooling {
+/** Unbounded pool of reusable objects. Each thread keeps a small stack (a
+    magazine) of objects in front of the shared queue: Get and Return work
+    on the caller's magazine and only exchange half a magazine with the
+    queue when it runs empty or full, so most Get/Return pairs on one thread
+    touch no shared state. Objects parked in one thread's magazine are not
+    visible to other threads until a flush.
+
+    Objects handed out by Lease live in heap slots and circulate through a
+    second set of magazines and queue, separate from the by-value objects
+    of Get and Return, so a slot's object is never moved.
+
+    Idle objects are only destroyed by Clear and Trim; see IdleWindow for
+    how Trim decides which objects have been idle long enough. */
 template <typename T>
 class ObjectPool : public IObjectPool<T> {
  public:
+  static constexpr std::size_t kBatchSize = 16;
+  static constexpr std::size_t kMagazineCapacity = 2 * kBatchSize;
+
   static StatusOr<ObjectPool<T>> Create(ws::Delegate<T()> object_generator);
 
-  ObjectPool<T>() noexcept = default;
+  ObjectPool() noexcept = default;
+
+  ObjectPool(ObjectPool&&) noexcept = default;
 
-  ~ObjectPool<T>();
+  ~ObjectPool();
 
   T Get() override;
+  PooledLease<T> Lease() override;
   void Return(const T& item) override;
   void Return(T&& item) override;
   void Clear() override;
 
+  /** Creates count objects up front and parks them in the shared queue, so
+      the first Gets after start-up do not pay for construction. */
+  void Prewarm(std::size_t count);
+
+  /** Like Prewarm, for the slots handed out by Lease. */
+  void PrewarmLeases(std::size_t count);
+
+  /** Destroys the objects that stayed idle for at least max_idle and
+      returns how many were destroyed. Meant to be called periodically;
+      calls made before max_idle has passed since the last effective Trim
+      do nothing. */
+  std::size_t Trim(std::chrono::steady_clock::duration max_idle);
+
+  using Statistics = PoolStatistics;
+
+  /** Starts counting hits, misses, creations, returns and outstanding
+      objects. Must be called before the pool is shared between threads. */
+  void EnableStatistics();
+
+  /** Returns nullptr unless statistics are enabled. */
+  const Statistics* GetStatistics() const { return statistics_.get(); }
+
+  /** Takes a snapshot of the counters and of the number of idle objects. */
+  PoolStats Stats() const;
+
  private:
+  template <typename TItem>
+  struct alignas(ws::internal::CacheLineSize()) Magazine {
+    ws::concurrency::SpinMutex mutex;
+    std::vector<TItem> items;
+    /** Fewest items held since the last Trim; the oldest that many have
+        been idle for the whole window. */
+    std::size_t low_water = 0;
+  };
+
+  /** One kind of idle item, by-value objects or leased slots, with its
+      magazines, shared queue and trim window. */
+  template <typename TItem>
+  struct Shelf {
+    std::unique_ptr<Magazine<TItem>[]> magazines;
+    ws::concurrency::ConcurrentQueue<TItem> queue;
+    IdleWindow idle_window;
+  };
+
   explicit ObjectPool(ws::Delegate<T()> object_generator);
 
-  ws::concurrency::ConcurrentQueue<T> objects_;
+  /** Threads map to magazines by ordinal, like ShardedCounter slots, so the
+      spin lock is only contended when two threads share a slot. */
+  template <typename TItem>
+  Magazine<TItem>& LocalMagazine(Shelf<TItem>& shelf) {
+    return shelf.magazines[ws::concurrency::internal::ThisThreadOrdinal() &
+                           (num_magazines_ - 1)];
+  }
+
+  /** Refills an empty magazine from the shared queue. Returns false if the
+      magazine is still empty. The magazine must be locked. */
+  template <typename TItem>
+  bool Refill(Shelf<TItem>& shelf, Magazine<TItem>& magazine);
+
+  /** Drops the magazine's last item after it was taken. */
+  template <typename TItem>
+  static void PopBack(Magazine<TItem>& magazine);
+
+  template <typename TItem, typename TArg>
+  void Put(Shelf<TItem>& shelf, TArg&& item);
+
+  /** Moves the oldest count items of the magazine to the shared queue. */
+  template <typename TItem>
+  static void Flush(Shelf<TItem>& shelf, Magazine<TItem>& magazine,
+                    std::size_t count);
+
+  template <typename TItem>
+  void ClearShelf(Shelf<TItem>& shelf);
+
+  template <typename TItem>
+  std::size_t TrimShelf(Shelf<TItem>& shelf,
+                        std::chrono::steady_clock::duration max_idle);
+
+  template <typename TItem>
+  std::size_t IdleCount(const Shelf<TItem>& shelf) const;
+
+  static void ReleaseSlot(void* owner, T* slot);
+
+  static void Destroy(T& item);
+  static void Destroy(T* slot);
+
+  template <typename TItem>
+  static void DestroyAll(std::vector<TItem>& items);
+
+  std::size_t num_magazines_ = 0;
+  Shelf<T> objects_;
+  Shelf<T*> slots_;
   ws::Delegate<T()> object_generator_;
+  std::unique_ptr<Statistics> statistics_;
 };
 
 // ============================================================================
@@ -37,14 +161,19 @@ class ObjectPool : public IObjectPool<T> {
 template <typename T>
 inline StatusOr<ObjectPool<T>> ObjectPool<T>::Create(
     ws::Delegate<T()> object_generator) {
-  if (!object_generator_)
+  if (!object_generator)
     return Status(StatusCode::kBadRequest, "Object generator cannot be null");
   return ObjectPool<T>(object_generator);
 }
 
 template <typename T>
 inline ObjectPool<T>::ObjectPool(ws::Delegate<T()> object_generator)
-    : object_generator_(object_generator) {}
+    : num_magazines_(std::bit_ceil(
+          ws::concurrency::ShardedCounter::DefaultShards())),
+      object_generator_(object_generator) {
+  objects_.magazines = std::make_unique<Magazine<T>[]>(num_magazines_);
+  slots_.magazines = std::make_unique<Magazine<T*>[]>(num_magazines_);
+}
 
 template <typename T>
 inline ObjectPool<T>::~ObjectPool() {
@@ -53,35 +182,253 @@ inline ObjectPool<T>::~ObjectPool() {
 
 template <typename T>
 inline T ObjectPool<T>::Get() {
-  T item;
-  if (objects_.TryPop(item)) {
-    return item;
+  if (objects_.magazines) {
+    Magazine<T>& magazine = LocalMagazine(objects_);
+    ws::concurrency::SpinMutex::ScopedLock lock(magazine.mutex);
+    if (Refill(objects_, magazine)) {
+      T item = std::move(magazine.items.back());
+      PopBack(magazine);
+      if (statistics_) statistics_->RecordHit();
+      return item;
+    }
+  }
+
+  if (statistics_) {
+    statistics_->RecordMiss();
+    statistics_->creations.Increment();
+  }
+  return object_generator_();
+}
+
+template <typename T>
+inline PooledLease<T> ObjectPool<T>::Lease() {
+  T* slot = nullptr;
+  if (slots_.magazines) {
+    Magazine<T*>& magazine = LocalMagazine(slots_);
+    ws::concurrency::SpinMutex::ScopedLock lock(magazine.mutex);
+    if (Refill(slots_, magazine)) {
+      slot = magazine.items.back();
+      PopBack(magazine);
+    }
+  }
+
+  if (slot) {
+    if (statistics_) statistics_->RecordHit();
   } else {
-    return object_generator_();
+    if (statistics_) {
+      statistics_->RecordMiss();
+      statistics_->creations.Increment();
+    }
+    slot = new T(object_generator_());
   }
+  return PooledLease<T>(slot, &ObjectPool::ReleaseSlot, this);
 }
 
 template <typename T>
 inline void ObjectPool<T>::Return(const T& item) {
-  objects_.Push(item);
+  if (statistics_) statistics_->RecordReturn();
+  Put(objects_, item);
 }
 
 template <typename T>
 inline void ObjectPool<T>::Return(T&& item) {
-  objects_.Push(std::move(item));
+  if (statistics_) statistics_->RecordReturn();
+  Put(objects_, std::move(item));
 }
 
 template <typename T>
-inline void ObjectPool<T>::Clear() {
-  if constexpr (!std::is_member_function_pointer<
-                    decltype(&T::Dispose)>::value) {
-    objects_.Clear();
+inline void ObjectPool<T>::ReleaseSlot(void* owner, T* slot) {
+  ObjectPool* pool = static_cast<ObjectPool*>(owner);
+  if (pool->statistics_) pool->statistics_->RecordReturn();
+  pool->Put(pool->slots_, slot);
+}
+
+template <typename T>
+template <typename TItem>
+inline bool ObjectPool<T>::Refill(Shelf<TItem>& shelf,
+                                  Magazine<TItem>& magazine) {
+  if (magazine.items.empty() &&
+      shelf.queue.TryPopBulk(std::back_inserter(magazine.items),
+                             kBatchSize) != 0) {
+    shelf.idle_window.Observe(shelf.queue.UnsafeSize());
+  }
+  return !magazine.items.empty();
+}
+
+template <typename T>
+template <typename TItem>
+inline void ObjectPool<T>::PopBack(Magazine<TItem>& magazine) {
+  magazine.items.pop_back();
+  magazine.low_water = std::min(magazine.low_water, magazine.items.size());
+}
+
+template <typename T>
+template <typename TItem, typename TArg>
+inline void ObjectPool<T>::Put(Shelf<TItem>& shelf, TArg&& item) {
+  if (!shelf.magazines) {
+    shelf.queue.Push(std::forward<TArg>(item));
     return;
   }
 
-  while (objects_.TryPop(item)) {
+  Magazine<TItem>& magazine = LocalMagazine(shelf);
+  ws::concurrency::SpinMutex::ScopedLock lock(magazine.mutex);
+  if (magazine.items.size() >= kMagazineCapacity) {
+    Flush(shelf, magazine, kBatchSize);
+  }
+  magazine.items.push_back(std::forward<TArg>(item));
+}
+
+template <typename T>
+template <typename TItem>
+inline void ObjectPool<T>::Flush(Shelf<TItem>& shelf,
+                                 Magazine<TItem>& magazine,
+                                 std::size_t count) {
+  auto first = magazine.items.begin();
+  auto last = first + static_cast<std::ptrdiff_t>(count);
+  shelf.queue.PushRange(std::make_move_iterator(first),
+                        std::make_move_iterator(last));
+  magazine.items.erase(first, last);
+  magazine.low_water = std::min(magazine.low_water, magazine.items.size());
+}
+
+template <typename T>
+inline void ObjectPool<T>::Clear() {
+  ClearShelf(objects_);
+  ClearShelf(slots_);
+}
+
+template <typename T>
+template <typename TItem>
+inline void ObjectPool<T>::ClearShelf(Shelf<TItem>& shelf) {
+  for (std::size_t i = 0; shelf.magazines && i < num_magazines_; ++i) {
+    Magazine<TItem>& magazine = shelf.magazines[i];
+    ws::concurrency::SpinMutex::ScopedLock lock(magazine.mutex);
+    DestroyAll(magazine.items);
+    magazine.items.clear();
+    magazine.low_water = 0;
+  }
+
+  std::vector<TItem> drained;
+  while (shelf.queue.TryPopBulk(std::back_inserter(drained), kBatchSize) !=
+         0) {
+    DestroyAll(drained);
+    drained.clear();
+  }
+  shelf.idle_window.Restart(0);
+}
+
+template <typename T>
+inline void ObjectPool<T>::Prewarm(std::size_t count) {
+  if (count == 0) return;
+  std::vector<T> created;
+  created.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    created.push_back(object_generator_());
+  }
+
+  objects_.queue.PushRange(std::make_move_iterator(created.begin()),
+                           std::make_move_iterator(created.end()));
+  if (statistics_) {
+    statistics_->creations.Add(static_cast<std::int64_t>(count));
+  }
+}
+
+template <typename T>
+inline void ObjectPool<T>::PrewarmLeases(std::size_t count) {
+  if (count == 0) return;
+  std::vector<T*> created;
+  created.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    created.push_back(new T(object_generator_()));
+  }
+
+  slots_.queue.PushRange(created.begin(), created.end());
+  if (statistics_) {
+    statistics_->creations.Add(static_cast<std::int64_t>(count));
+  }
+}
+
+template <typename T>
+inline std::size_t ObjectPool<T>::Trim(
+    std::chrono::steady_clock::duration max_idle) {
+  return TrimShelf(objects_, max_idle) + TrimShelf(slots_, max_idle);
+}
+
+template <typename T>
+template <typename TItem>
+inline std::size_t ObjectPool<T>::TrimShelf(
+    Shelf<TItem>& shelf, std::chrono::steady_clock::duration max_idle) {
+  const std::optional<std::size_t> queue_idle =
+      shelf.idle_window.Close(max_idle);
+  if (!queue_idle) return 0;
+
+  // Magazines push and pop at the back, so the idle items are the oldest.
+  std::vector<TItem> released;
+  for (std::size_t i = 0; shelf.magazines && i < num_magazines_; ++i) {
+    Magazine<TItem>& magazine = shelf.magazines[i];
+    ws::concurrency::SpinMutex::ScopedLock lock(magazine.mutex);
+    auto first = magazine.items.begin();
+    auto last = first + static_cast<std::ptrdiff_t>(std::min(
+                            magazine.low_water, magazine.items.size()));
+    released.insert(released.end(), std::make_move_iterator(first),
+                    std::make_move_iterator(last));
+    magazine.items.erase(first, last);
+    magazine.low_water = magazine.items.size();
+  }
+
+  if (*queue_idle != 0) {
+    shelf.queue.TryPopBulk(std::back_inserter(released), *queue_idle);
+  }
+  shelf.idle_window.Restart(shelf.queue.UnsafeSize());
+  DestroyAll(released);
+  return released.size();
+}
+
+template <typename T>
+inline void ObjectPool<T>::Destroy(T& item) {
+  if constexpr (requires { item.Dispose(); }) {
     item.Dispose();
   }
 }
+
+template <typename T>
+inline void ObjectPool<T>::Destroy(T* slot) {
+  Destroy(*slot);
+  delete slot;
+}
+
+template <typename T>
+template <typename TItem>
+inline void ObjectPool<T>::DestroyAll(std::vector<TItem>& items) {
+  for (TItem& item : items) {
+    Destroy(item);
+  }
+}
+
+template <typename T>
+inline void ObjectPool<T>::EnableStatistics() {
+  if (!statistics_) statistics_ = std::make_unique<Statistics>();
+}
+
+template <typename T>
+template <typename TItem>
+inline std::size_t ObjectPool<T>::IdleCount(const Shelf<TItem>& shelf) const {
+  std::size_t idle = shelf.queue.UnsafeSize();
+  for (std::size_t i = 0; shelf.magazines && i < num_magazines_; ++i) {
+    Magazine<TItem>& magazine = shelf.magazines[i];
+    ws::concurrency::SpinMutex::ScopedLock lock(magazine.mutex);
+    idle += magazine.items.size();
+  }
+  return idle;
+}
+
+template <typename T>
+inline PoolStats ObjectPool<T>::Stats() const {
+  const std::size_t idle = IdleCount(objects_) + IdleCount(slots_);
+  if (statistics_) return statistics_->Snapshot(idle);
+  PoolStats stats;
+  stats.idle = idle;
+  return stats;
+}
 }  // namespace pooling
 }  // namespace ws
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "ws/concurrency/sharded_counter.h"
+
+namespace ws {
+namespace pooling {
+/** Point-in-time copy of a pool's counters. The counters stay zero unless
+    statistics are enabled; idle is always filled in. */
+struct PoolStats {
+  std::int64_t hits = 0;
+  std::int64_t misses = 0;
+  std::int64_t creations = 0;
+  std::int64_t returns = 0;
+  std::int64_t outstanding = 0;
+  std::int64_t peak_outstanding = 0;
+  std::size_t idle = 0;
+};
+
+/** Counters a pool keeps once statistics are enabled. Event counts are
+    ShardedCounters; the outstanding count is a single atomic because its
+    peak needs an exact running value, which costs one shared add per Get
+    and Return. */
+struct PoolStatistics {
+  ws::concurrency::ShardedCounter hits;
+  ws::concurrency::ShardedCounter misses;
+  ws::concurrency::ShardedCounter creations;
+  ws::concurrency::ShardedCounter returns;
+  std::atomic<std::int64_t> outstanding{0};
+  std::atomic<std::int64_t> peak_outstanding{0};
+
+  void RecordHit() {
+    hits.Increment();
+    RecordAcquire();
+  }
+
+  void RecordMiss() {
+    misses.Increment();
+    RecordAcquire();
+  }
+
+  void RecordReturn() {
+    returns.Increment();
+    outstanding.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  PoolStats Snapshot(std::size_t idle) const {
+    PoolStats stats;
+    stats.hits = hits.Load();
+    stats.misses = misses.Load();
+    stats.creations = creations.Load();
+    stats.returns = returns.Load();
+    stats.outstanding = outstanding.load(std::memory_order_relaxed);
+    stats.peak_outstanding = peak_outstanding.load(std::memory_order_relaxed);
+    stats.idle = idle;
+    return stats;
+  }
+
+ private:
+  void RecordAcquire() {
+    const std::int64_t current =
+        outstanding.fetch_add(1, std::memory_order_relaxed) + 1;
+    std::int64_t peak = peak_outstanding.load(std::memory_order_relaxed);
+    while (current > peak && !peak_outstanding.compare_exchange_weak(
+                                 peak, current, std::memory_order_relaxed)) {
+    }
+  }
+};
+}  // namespace pooling
+}  // namespace ws
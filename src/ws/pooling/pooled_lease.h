@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cassert>
+#include <utility>
+
+namespace ws {
+namespace pooling {
+/** Move-only handle to an object leased from a pool. The object lives in a
+    slot the pool allocated, so it is never moved or copied while pooled;
+    destroying or resetting the lease hands the slot back. The pool must
+    outlive its leases and must not be moved while any are out. */
+template <typename T>
+class PooledLease {
+ public:
+  using release_function = void (*)(void* owner, T* object);
+
+  PooledLease() noexcept = default;
+
+  PooledLease(T* object, release_function release, void* owner) noexcept
+      : object_(object), release_(release), owner_(owner) {}
+
+  PooledLease(PooledLease&& other) noexcept
+      : object_(std::exchange(other.object_, nullptr)),
+        release_(std::exchange(other.release_, nullptr)),
+        owner_(std::exchange(other.owner_, nullptr)) {}
+
+  PooledLease(const PooledLease&) = delete;
+
+  PooledLease& operator=(PooledLease&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      object_ = std::exchange(other.object_, nullptr);
+      release_ = std::exchange(other.release_, nullptr);
+      owner_ = std::exchange(other.owner_, nullptr);
+    }
+
+    return *this;
+  }
+
+  PooledLease& operator=(const PooledLease&) = delete;
+
+  ~PooledLease() { Reset(); }
+
+  T& operator*() const {
+    assert(object_ != nullptr && "Lease is empty");
+    return *object_;
+  }
+
+  T* operator->() const {
+    assert(object_ != nullptr && "Lease is empty");
+    return object_;
+  }
+
+  T* Get() const noexcept { return object_; }
+
+  explicit operator bool() const noexcept { return object_ != nullptr; }
+
+  /** Hands the object back to its pool now and leaves the lease empty. */
+  void Reset() noexcept {
+    if (object_) release_(owner_, object_);
+    object_ = nullptr;
+    release_ = nullptr;
+    owner_ = nullptr;
+  }
+
+ private:
+  T* object_ = nullptr;
+  release_function release_ = nullptr;
+  void* owner_ = nullptr;
+};
+}  // namespace pooling
+}  // namespace ws
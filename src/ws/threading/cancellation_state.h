@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <memory>
+#include <thread>
 
 #include "ws/concurrency/concurrent_unordered_map.h"
 #include "ws/delegate.h"
@@ -14,7 +15,10 @@ struct CancellationState {
 
   std::atomic_bool cancelled{false};
   map_type callbacks;
-  size_t next_id = 1;
+  std::atomic<size_t> next_id{1};
+  // Id of the callback Cancel is running, so Unregister can wait for it.
+  std::atomic<size_t> executing_id{0};
+  std::thread::id executing_thread;
 };
 }  // namespace threading
 }  // namespace ws
@@ -14,7 +14,15 @@ StatusOr<CancellationTokenRegistration> CancellationToken::RegisterCallback(
   }
 
   long id = state_->next_id++;
-  state_->callbacks[id] = callback;
+  state_->callbacks.emplace(id, callback);
+  // Cancel may have taken its snapshot before the insert; whoever erases
+  // the entry runs the callback.
+  if (state_->cancelled.load() &&
+      state_->callbacks.concurrent_erase(id) != 0) {
+    callback();
+    return CancellationTokenRegistration();
+  }
+
   return CancellationTokenRegistration(state_, id);
 }
 }  // namespace threading
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <thread>
+
 #include "ws/threading/cancellation_state.h"
 namespace ws {
 namespace threading {
@@ -26,7 +28,13 @@ inline CancellationTokenRegistration::CancellationTokenRegistration(
 
 inline void CancellationTokenRegistration::Unregister() {
   if (auto st = state_.lock()) {
-    st->callbacks.erase(id_);
+    if (st->callbacks.concurrent_erase(id_) != 0) return;
+    // Cancel already claimed the callback; wait until it has returned so
+    // the caller may release whatever it captured.
+    while (st->executing_id.load() == id_ &&
+           st->executing_thread != std::this_thread::get_id()) {
+      std::this_thread::yield();
+    }
   }
 }
 
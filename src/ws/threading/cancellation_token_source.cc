@@ -1,17 +1,24 @@
 #include "ws/threading/cancellation_token_source.h"
+
 namespace ws {
 namespace threading {
 void CancellationTokenSource::Cancel() {
   if (state_->cancelled.exchange(true)) return;
-  auto callbacks_copy = state_->callbacks;
-  state_->callbacks.clear();
-  for (const auto& [id, callback] : callbacks_copy) {
+  state_->executing_thread = std::this_thread::get_id();
+  // Callbacks may still be registered or unregistered concurrently, so
+  // run them from a snapshot and erase them one by one instead of
+  // clearing the map.
+  const auto pending = state_->callbacks.snapshot();
+  for (const auto& [id, callback] : pending) {
+    state_->executing_id.store(id);
+    if (state_->callbacks.concurrent_erase(id) == 0) continue;
     try {
       callback();
     } catch (...) {
       // Handle exceptions
     }
   }
+  state_->executing_id.store(0);
 }
 
 void CancellationTokenSource::CancelAfter(std::chrono::milliseconds delay) {